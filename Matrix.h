@@ -6,6 +6,34 @@
 //#	    <类>		        <描述>		<关系>		<描述>
 //#	    Matrix<T>			矩阵类	    基类	    具有线性代数中矩阵的基本计算功能
 //#	    Determinant<T>		行列式类	包含矩阵类	  包含一个矩阵类指针，具有求值功能
+//#	    MatrixChain<T>		矩阵连乘表达式	包含矩阵类	  延迟求值，动态规划选取运算量最少的结合顺序
+//#	    MatrixProfiler		运算统计类	独立		  可选的分配、拷贝、浮点运算与耗时统计
+//#	    LUDecomposition<T>	LU分解类	包含矩阵类	  部分选主元LU分解，求解方程组、行列式与逆
+//#	    BareissElimination<T>	分数无关消元类	包含矩阵类	  整数矩阵的精确行列式、秩、伴随矩阵与带公分母的逆
+//#	    ModularElimination<T>	模p消元类	独立		  模素数消元，多模加中国剩余定理求精确行列式
+//#	    CholeskyDecomposition<T>	Cholesky分解类	包含矩阵类	  对称正定矩阵的LLᵀ分解
+//#	    PivotedQRDecomposition<T>	列选主元QR分解类	包含矩阵类	  带容限的秩判定，剩余子块足够小时提前停止
+//#	    SymmetricEigenDecomposition<T>	对称特征分解类	包含矩阵类	  三对角化加隐式QL求特征值与特征向量
+//#	    HermitianEigenDecomposition<T>	Hermite特征分解类	包含矩阵类	  复Householder三对角化，复用对称三对角QL求实特征值
+//#	    MatrixScalar<T>		标量特性类	独立		  实数与复数元素的共轭、绝对值、解析与输出
+//#	    Half, BFloat16		16位浮点类	独立		  半精度与bfloat16存储格式，以float计算与累加
+//#	    ReducedPrecision		16位浮点转换类	独立		  运行时选择F16C/AVX-512-BF16或软件实现的成批转换
+//#	    SingularValueDecomposition<T>	奇异值分解类	包含矩阵类	  TSQR加单边Jacobi的奇异值分解与伪逆
+//#	    SparseMatrix<T>		稀疏矩阵类	独立		  压缩行存储的稀疏矩阵与并行矩阵向量乘法
+//#	    LinearOperator<T>		线性算子类	独立		  由稠密矩阵、稀疏矩阵或可调用对象构造的 y = Ax
+//#	    KroneckerOperator<T>	Kronecker算子类	包含矩阵类	  不形成乘积，以两次GEMM计算 (A⊗B)x
+//#	    JacobiPreconditioner<T>	预条件子类	独立		  对角预条件子
+//#	    ILU0Preconditioner<T>	预条件子类	包含稀疏矩阵类	  零填充不完全LU分解预条件子
+//#	    IterativeSolver<T>		迭代求解器类	独立		  CG、GMRES(m)与BiCGSTAB迭代求解方程组
+//#	    MixedPrecisionSolver<T>	混合精度求解器	包含矩阵类	  低精度分解加高精度迭代修正求解方程组
+//#	    MatrixThreadPool		线程池类	独立		  库内并行计算共用的全局工作线程池
+//#	    MatrixMemory		内存放置类	独立		  按行分块或按页轮流由工作线程首次写入，用于NUMA放置
+//#	    MatrixJobControl		作业控制类	独立		  异步作业的取消标志、进度与提交，检查点位于分块算法的块之间
+//#	    MatrixRandom		随机数类	独立		  Philox计数器随机数与全局种子序列，用于并行可复现的随机填充
+//#	    Vector<T>			向量类		独立		  稠密向量与矩阵行列视图的内积、AXPY与GEMV
+//#	    MatrixKernel<T>		计算内核类	独立		  分块并行GEMM与分块高斯消元等底层内核
+//#	    MatrixBatch<T>		批量矩阵类	独立		  结构数组布局的批量小矩阵运算
+//#	    MatrixBatchLU<T>		批量LU分解类	包含批量矩阵类	  批量求解、求逆与行列式
 //#
 //#     矩阵元素访问函数 operator()() 行列序号默认从1开始，若要使用0作为序号起始，请在包含本
 //# 头文件前定义宏 MATRIX_INDEX_START_AT_0:
@@ -13,6 +41,11 @@
 //#      #define MATRIX_INDEX_START_AT_0
 //#      
 //#     矩阵的数据以行存储（Row Major）
+//#
+//#     在包含本头文件前定义宏 MATRIX_COPY_ON_WRITE 后，矩阵的拷贝共享同一份数据（原子引用
+//# 计数），直到某一方第一次通过非常量接口访问数据时才复制出私有的一份：
+//#
+//#      #define MATRIX_COPY_ON_WRITE
 //#																	2020/08/05
 //#																	Shepard Liu
 //#								   Version:0.1
@@ -46,10 +79,25 @@
 #include <sstream>
 #include <cassert>
 #include <vector>
+#include <algorithm>
 #include <initializer_list>
 #include <sstream>
 #include <random>
 #include <chrono>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <future>
+#include <deque>
+#include <type_traits>
+#include <cstdint>
 
 template <typename T, size_t _CapacityIncrement = 2>
 class Matrix;
@@ -59,1656 +107,11546 @@ typedef Matrix<double> Matrixd;
 template <typename T>
 class Determinant;
 
+template <typename T>
+class Vector;
+
+template <typename T>
+class SingularValueDecomposition;
+
+template <typename T>
+class PivotedQRDecomposition;
+
+template <typename T>
+class MatrixChain;
+
+template <typename T>
+class LUDecomposition;
+
+template <typename T>
+class CholeskyDecomposition;
+
+template <typename T>
+class BareissElimination;
+
+template <typename T>
+class ModularElimination;
+
+typedef Vector<double> Vectord;
+
+///////////////////////////////////////////////////////////////////////////////////
+//                               性能统计（可选）
+//
+//     在包含本头文件前定义宏 MATRIX_ENABLE_PROFILER 以启用运算统计。未定义时所有统计
+// 钩子均展开为空语句，不产生任何开销。
+//
+//     启用后，每个线程独立记录：内存分配次数与字节数、深拷贝（拷贝构造/拷贝赋值）次数、
+// 移动次数，以及每种公开运算的调用次数、浮点运算次数、期间发生的分配与深拷贝次数和耗时。
+// 通过 MatrixProfiler::Snapshot() 汇总所有线程的数据，MatrixProfiler::Dump() 输出报表。
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifdef MATRIX_ENABLE_PROFILER
+#include <map>
+#include <iomanip>
+
 /**
-    @brief 矩阵类
-    
-    矩阵基类，提供基础的矩阵运算与输入输出功能
+ * @brief 单项运算的统计数据
+ *
+ * 耗时、浮点运算、分配与拷贝次数均为包含嵌套调用的累计值
+ */
+struct MatrixOpStats
+{
+    unsigned long long calls = 0;       //调用次数
+    unsigned long long flops = 0;       //浮点运算次数
+    unsigned long long allocations = 0; //运算期间的内存分配次数
+    unsigned long long copies = 0;      //运算期间的深拷贝次数
+    double seconds = 0.0;               //累计耗时（秒）
+};
 
-    @tparam T	                矩阵数据类型
-    @tparam _CapacityIncrement	矩阵扩增系数
-*/
-template <typename T, size_t _CapacityIncrement>
-class Matrix
+/**
+ * @brief 统计数据快照
+ */
+struct MatrixProfileSnapshot
 {
-    //声明
-    friend Determinant<T>;
+    unsigned long long allocations = 0;       //内存分配次数
+    unsigned long long bytesAllocated = 0;    //分配的字节数
+    unsigned long long copyConstructions = 0; //拷贝构造次数
+    unsigned long long copyAssignments = 0;   //拷贝赋值次数
+    unsigned long long moveConstructions = 0; //移动构造次数
+    unsigned long long moveAssignments = 0;   //移动赋值次数
 
-protected:
-    size_t uRow; //行数
-    size_t uCol; //列数
+    std::map<std::string, MatrixOpStats, std::less<>> ops; //各运算的统计数据
+
+    /**
+     * @brief 合并另一份快照的数据
+     *
+     * @param other 另一份快照
+     */
+    void Merge(const MatrixProfileSnapshot &other)
+    {
+        allocations += other.allocations;
+        bytesAllocated += other.bytesAllocated;
+        copyConstructions += other.copyConstructions;
+        copyAssignments += other.copyAssignments;
+        moveConstructions += other.moveConstructions;
+        moveAssignments += other.moveAssignments;
+        for (auto &item : other.ops)
+        {
+            MatrixOpStats &s = ops[item.first];
+            s.calls += item.second.calls;
+            s.flops += item.second.flops;
+            s.allocations += item.second.allocations;
+            s.copies += item.second.copies;
+            s.seconds += item.second.seconds;
+        }
+    }
+
+    /**
+     * @brief 以表格形式输出统计数据
+     *
+     * @param os 输出流
+     */
+    void Dump(std::ostream &os) const
+    {
+        os << "Matrix profile\n"
+           << "  allocations: " << allocations << " (" << bytesAllocated << " bytes)\n"
+           << "  deep copies: " << copyConstructions << " construct, " << copyAssignments << " assign\n"
+           << "  moves:       " << moveConstructions << " construct, " << moveAssignments << " assign\n";
+        os << std::left << std::setw(20) << "  operation" << std::right
+           << std::setw(12) << "calls" << std::setw(12) << "allocs" << std::setw(12) << "copies"
+           << std::setw(16) << "flops" << std::setw(14) << "seconds" << std::setw(12) << "GFLOP/s" << '\n';
+        for (auto &item : ops)
+        {
+            const MatrixOpStats &s = item.second;
+            double gflops = s.seconds > 0.0 ? s.flops / s.seconds * 1e-9 : 0.0;
+            os << "  " << std::left << std::setw(18) << item.first << std::right
+               << std::setw(12) << s.calls << std::setw(12) << s.allocations << std::setw(12) << s.copies
+               << std::setw(16) << s.flops << std::setw(14) << std::setprecision(6) << s.seconds
+               << std::setw(12) << std::setprecision(4) << gflops << '\n';
+        }
+    }
+};
+
+/**
+ * @brief 运算统计注册表
+ *
+ * 每个线程拥有独立的记录，线程内的统计只加本线程记录的锁，几乎没有竞争。
+ * 线程退出时其记录并入全局的已退出线程数据，不会丢失。
+ */
+class MatrixProfiler
+{
+    friend class MatrixProfileScope;
 
-    T *pData = nullptr; //矩阵数据
-    size_t uCapacity;   //数据容量
 private:
-    static const size_t uCapacityIncrement = _CapacityIncrement > 1 ? _CapacityIncrement : 2; //容量倍增系数
+    //单个线程的统计记录
+    struct Record
+    {
+        std::mutex mtx;
+        MatrixProfileSnapshot data;
+    };
 
-public:
-    enum Direction
+    //全局注册表
+    struct Registry
     {
-        LEFT,
-        RIGHT,
-        ABOVE,
-        BELOW,
-        TOPLEFT,
-        TOPRIGHT,
-        BOTLEFT,
-        BOTRIGHT,
+        std::mutex mtx;
+        std::vector<std::shared_ptr<Record>> live; //存活线程的记录
+        MatrixProfileSnapshot retired;             //已退出线程的数据
+    };
+
+    //线程本地记录持有者，析构时从注册表注销
+    struct LocalHolder
+    {
+        std::shared_ptr<Record> rec = std::make_shared<Record>();
+
+        LocalHolder()
+        {
+            Registry &reg = GetRegistry();
+            std::lock_guard<std::mutex> lock(reg.mtx);
+            reg.live.push_back(rec);
+        }
+
+        ~LocalHolder()
+        {
+            Registry &reg = GetRegistry();
+            std::lock_guard<std::mutex> lock(reg.mtx);
+            {
+                std::lock_guard<std::mutex> recLock(rec->mtx);
+                reg.retired.Merge(rec->data);
+            }
+            for (size_t i = 0; i < reg.live.size(); ++i)
+                if (reg.live[i] == rec)
+                {
+                    reg.live.erase(reg.live.begin() + i);
+                    break;
+                }
+        }
     };
 
+    //注册表永不析构：线程池的工作线程可能在静态对象析构之后才退出并注销记录
+    static Registry &GetRegistry()
+    {
+        static Registry *reg = new Registry;
+        return *reg;
+    }
+
+    static Record &Local()
+    {
+        thread_local LocalHolder holder;
+        return *holder.rec;
+    }
+
 public:
-    //构造函数
+    /**
+     * @brief 记录一次内存分配
+     *
+     * @param bytes 分配的字节数
+     */
+    static void RecordAlloc(size_t bytes);
 
     /**
-     * @brief   无参构造函数
-     * 
-     * 构造0行0列无数据的空矩阵
+     * @brief 记录一次拷贝构造
      */
-    Matrix() : Matrix(0, 0)
-    {
-    }
+    static void RecordCopyConstruct();
 
     /**
-        @brief 无数据构造函数：
+     * @brief 记录一次拷贝赋值
+     */
+    static void RecordCopyAssign();
 
-        构造一个row × col大小的矩阵
-        @param row 矩阵的行数
-        @param col 矩阵的列数
-    */
-    Matrix(size_t row, size_t col) : uRow(row), uCol(col)
+    /**
+     * @brief 记录一次移动构造
+     */
+    static void RecordMoveConstruct()
     {
-        uCapacity = uCapacityIncrement * row * col;
-        pData = new T[uCapacity]{};
-        assert(pData);
+        Record &r = Local();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        ++r.data.moveConstructions;
     }
 
     /**
-        @brief 矩阵构造函数：指定所有元素为某值
-
-        构造一个row × col大小的，元素全为同一值的矩阵
-        @param row 矩阵的行数
-        @param col 矩阵的列数
-    */
-    Matrix(size_t row, size_t col, const T &value) : uRow(row), uCol(col)
+     * @brief 记录一次移动赋值
+     */
+    static void RecordMoveAssign()
     {
-        uCapacity = uCapacityIncrement * row * col;
-        pData = new T[uCapacity]{};
-        for (size_t i = 0; i < row * col; ++i)
-            pData[i] = value;
-        assert(pData);
+        Record &r = Local();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        ++r.data.moveAssignments;
     }
 
     /**
-        @brief 矩阵构造函数：数组指针
+     * @brief 为当前线程正在进行的运算累加浮点运算次数
+     *
+     * @param flops 浮点运算次数
+     */
+    static void RecordFlops(unsigned long long flops);
 
-        构造一个row × col大小的矩阵，复制线性数组data的数据
-        @param row	矩阵的行数
-        @param col	矩阵的列数
-        @param data	矩阵数据
-        @param dataLen  数组元素个数
-    */
-    Matrix(size_t row, size_t col, const T *data, size_t dataLen) : Matrix(row, col)
+    /**
+     * @brief 获取当前线程的统计快照
+     *
+     * @return MatrixProfileSnapshot 当前线程的统计数据
+     */
+    static MatrixProfileSnapshot ThreadSnapshot()
     {
-        size_t elemCount = row * col;
-        memcpy_s(pData, sizeof(T) * elemCount, data,
-                 dataLen > elemCount ? elemCount * sizeof(T) : dataLen * sizeof(T));
+        Record &r = Local();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        return r.data;
     }
 
     /**
-     * @brief 矩阵构造函数：从字符串
-     * 
-     * 使用类似于MATLAB中使用的矩阵定义字符串创建矩阵对象.
-     * 例如："[ 1 2, 5; 2.5 0 -1.3e2; 3, 2 6 ]"将转换为矩阵
-     * 
-     * 1    2   5
-     * 2.5  0   -1.3e2
-     * 3    2   6
-     * 
-     * 按行指定，每个元素间用分隔符' '或','且多余的空格自动忽略
-     * 该函数将检查表达式是否合法，第一行元素个数决定矩阵有多少列，
-     * 若后续行中缺项，将报错。
-     * 
-     * @param expr 类MATLAB的矩阵定义字符串
+     * @brief 获取所有线程（包括已退出线程）的汇总统计快照
+     *
+     * @return MatrixProfileSnapshot 汇总的统计数据
      */
-    explicit Matrix(const std::string &expr)
+    static MatrixProfileSnapshot Snapshot()
     {
-        //错误标识打印
-        auto flagPrint = [](const std::string &str, size_t flagPos)
+        Registry &reg = GetRegistry();
+        std::lock_guard<std::mutex> lock(reg.mtx);
+        MatrixProfileSnapshot total = reg.retired;
+        for (auto &rec : reg.live)
         {
-            std::cout << '\n'
-                      << str << '\n';
-            for (size_t i = 0; i < flagPos; ++i)
-                std::cout << ' ';
-            std::cout << "^\n";
-        };
+            std::lock_guard<std::mutex> recLock(rec->mtx);
+            total.Merge(rec->data);
+        }
+        return total;
+    }
 
-        //转换矩阵行：传入rowStr需保证没有'[', ';', ']'
-        auto parseRow = [&](const std::string &rowStr, int &errIdx)
+    /**
+     * @brief 清空所有线程的统计数据
+     */
+    static void Reset()
+    {
+        Registry &reg = GetRegistry();
+        std::lock_guard<std::mutex> lock(reg.mtx);
+        reg.retired = MatrixProfileSnapshot();
+        for (auto &rec : reg.live)
         {
-            std::string str = ' ' + rowStr + ' ';
+            std::lock_guard<std::mutex> recLock(rec->mtx);
+            rec->data = MatrixProfileSnapshot();
+        }
+    }
 
-            std::vector<T> values;
-            size_t numStartIdx = 0;
-            bool inNumber = false;
+    /**
+     * @brief 输出所有线程的汇总统计报表
+     *
+     * @param os 输出流
+     */
+    static void Dump(std::ostream &os = std::cout)
+    {
+        Snapshot().Dump(os);
+    }
+};
 
-            for (size_t i = 0; i < str.size(); ++i)
-            {
-                if (str[i] != ' ' && str[i] != ',' && !inNumber)
-                {
-                    numStartIdx = i;
-                    inNumber = true;
-                }
-                if (inNumber && (str[i] == ' ' || str[i] == ','))
-                {
-                    inNumber = false;
-                    std::stringstream ss(str.substr(numStartIdx, i - numStartIdx));
-                    T num = T(0);
-                    auto &is = (ss >> num);
-                    if (is.fail() || !is.eof())
-                    {
-                        errIdx = numStartIdx;
-                        return std::vector<T>();
-                    }
-                    values.push_back(num);
-                }
-            }
+/**
+ * @brief 运算计时作用域
+ *
+ * 构造时开始计时，析构时将调用次数、耗时以及期间累计的浮点运算、分配与深拷贝
+ * 次数记入当前线程的统计，并向外层作用域累加（包含式统计）。
+ */
+class MatrixProfileScope
+{
+    friend class MatrixProfiler;
 
-            errIdx = -1;
-            return values;
-        };
+private:
+    const char *name;
+    MatrixProfileScope *pParent;
+    std::chrono::steady_clock::time_point start;
+    unsigned long long flops = 0;
+    unsigned long long allocations = 0;
+    unsigned long long copies = 0;
+
+    static MatrixProfileScope *&Current()
+    {
+        thread_local MatrixProfileScope *pCurrent = nullptr;
+        return pCurrent;
+    }
 
-        //开始转换矩阵字符串
+public:
+    explicit MatrixProfileScope(const char *opName) : name(opName), pParent(Current())
+    {
+        Current() = this;
+        start = std::chrono::steady_clock::now();
+    }
 
-        size_t lbraIdx = expr.find('[');
-        //保证开始符‘[’前不存在除空格以外的符号
-        for (size_t i = 0; i < lbraIdx; ++i)
-        {
-            if (expr[i] != ' ')
-            {
-                std::cout << "Error parsing matrix expression (unrecognized character before '['):\n";
-                flagPrint(expr, i);
-                assert(0);
-            }
-        }
+    MatrixProfileScope(const MatrixProfileScope &) = delete;
+    MatrixProfileScope &operator=(const MatrixProfileScope &) = delete;
 
-        size_t rbraIdx = expr.find(']');
-        //保证结束符']'后不存在除空格以外的符号
-        for (size_t i = rbraIdx + 1; i < expr.size(); ++i)
+    ~MatrixProfileScope()
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Current() = pParent;
+        if (pParent)
         {
-            if (expr[i] != ' ')
-            {
-                std::cout << "Error parsing matrix expression (unrecognized character after ']'):\n";
-                flagPrint(expr, i);
-                assert(0);
-            }
+            pParent->flops += flops;
+            pParent->allocations += allocations;
+            pParent->copies += copies;
         }
 
-        ////////////逐行字符检查
+        MatrixProfiler::Record &r = MatrixProfiler::Local();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        auto it = r.data.ops.find(name);
+        if (it == r.data.ops.end())
+            it = r.data.ops.emplace(name, MatrixOpStats()).first;
+        MatrixOpStats &s = it->second;
+        ++s.calls;
+        s.flops += flops;
+        s.allocations += allocations;
+        s.copies += copies;
+        s.seconds += seconds;
+    }
+};
 
-        std::vector<std::vector<T>> dataVec;
+inline void MatrixProfiler::RecordAlloc(size_t bytes)
+{
+    if (MatrixProfileScope *pScope = MatrixProfileScope::Current())
+        ++pScope->allocations;
+    Record &r = Local();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    ++r.data.allocations;
+    r.data.bytesAllocated += bytes;
+}
 
-        //检查第一行
-        size_t rowDelimIdx = expr.find(';');
-        if (rowDelimIdx == std::string::npos)
-            rowDelimIdx = rbraIdx;
+inline void MatrixProfiler::RecordCopyConstruct()
+{
+    if (MatrixProfileScope *pScope = MatrixProfileScope::Current())
+        ++pScope->copies;
+    Record &r = Local();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    ++r.data.copyConstructions;
+}
 
-        int errIdx = -1;
-        dataVec.push_back(parseRow(expr.substr(lbraIdx + 1, rowDelimIdx - lbraIdx - 1), errIdx));
-        if (errIdx != -1)
-        {
-            std::cout << "Error parsing matrix expression (unable to parse row element):\n";
-            flagPrint(expr, errIdx + lbraIdx);
-            assert(0);
-        }
+inline void MatrixProfiler::RecordCopyAssign()
+{
+    if (MatrixProfileScope *pScope = MatrixProfileScope::Current())
+        ++pScope->copies;
+    Record &r = Local();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    ++r.data.copyAssignments;
+}
 
-        uCol = dataVec.front().size();
+inline void MatrixProfiler::RecordFlops(unsigned long long flops)
+{
+    if (MatrixProfileScope *pScope = MatrixProfileScope::Current())
+        pScope->flops += flops;
+}
 
-        //检查接下来的行
-
-        bool onEnd = false;
+//统计一个运算作用域
+#define MATRIX_PROFILE_SCOPE(name) MatrixProfileScope matrixProfileScope_(name)
+//记录一个统计事件，如 MATRIX_PROFILE_EVENT(RecordFlops(n))
+#define MATRIX_PROFILE_EVENT(event) MatrixProfiler::event
+#else
+#define MATRIX_PROFILE_SCOPE(name) ((void)0)
+#define MATRIX_PROFILE_EVENT(event) ((void)0)
+#endif
 
-        while (!onEnd)
-        {
-            size_t rowNextDelimIdx = expr.find(';', rowDelimIdx + 1);
-            if (rowNextDelimIdx == std::string::npos)
-            {
-                rowNextDelimIdx = rbraIdx;
-                onEnd = true;
-            }
+///////////////////////////////////////////////////////////////////////////////////
+//                                  线程池
+//
+//     库内所有并行计算共用一个全局线程池。并行区域被静态地划分为与线程数相同的若干块，
+// 第c块优先由第c个参与线程执行（第0块由调用线程执行），空闲线程会窃取未被领取的块，
+// 因此同一划分在多次调用间通常落在同一线程上。并行区域内部再次发起的并行调用会串行执行。
+//
+//     RunOnEachThread() 不允许窃取，第c次调用一定由第c个线程执行，用于按线程放置内存
+// （见 MatrixMemory）。Linux下可把工作线程按NUMA节点顺序绑定到CPU上，使编号相邻的
+// 线程位于同一节点，线程在计算中也不会迁移到其它节点。
+//
+//     线程池另有少量作业线程，按提交顺序执行 Submit() 提交的整个作业（见 MatrixJobControl）。
+// 作业线程不是工作线程，作业内部的并行调用照常分给工作线程执行。
+///////////////////////////////////////////////////////////////////////////////////
 
-            dataVec.push_back(parseRow(expr.substr(rowDelimIdx + 1, rowNextDelimIdx - rowDelimIdx - 1), errIdx));
-            if (errIdx != -1)
-            {
-                std::cout << "Error parsing matrix expression (unable to parse row element):\n";
-                flagPrint(expr, errIdx + rowDelimIdx);
-                assert(0);
-            }
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#endif
 
-            //保证列数相同
-            if (dataVec.back().size() != uCol)
-            {
-                std::cout << "Error parsing matrix expression (matrix rows must have consistent number of elements):\n";
-                flagPrint(expr, rowNextDelimIdx);
-                assert(0);
-            }
+/**
+ * @brief 全局工作线程池
+ */
+class MatrixThreadPool
+{
+private:
+    //一个并行区域
+    struct Region
+    {
+        std::function<void(size_t, size_t)> body;    //区域函数体，参数为[begin, end)
+        size_t begin = 0;                             //区域起始下标
+        size_t end = 0;                               //区域结束下标
+        size_t chunks = 0;                            //划分块数
+        std::unique_ptr<std::atomic<bool>[]> claimed; //各块是否已被领取
+        std::atomic<size_t> unclaimed{0};             //未被领取的块数
+        std::atomic<size_t> pending{0};               //未完成的块数
+        std::mutex mtx;
+        std::condition_variable done;
+        std::exception_ptr error; //第一个抛出的异常
+        bool bStatic = false;     //为真时第c块只能由第c个线程执行
+    };
 
-            rowDelimIdx = rowNextDelimIdx;
-        }
+    std::vector<std::thread> workers;                  //工作线程
+    std::vector<std::shared_ptr<Region>> regions;      //正在进行的并行区域
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+    size_t threadCount;
+    bool bPinned = false; //工作线程是否绑定到CPU
+
+    std::vector<std::thread> jobThreads;    //作业线程
+    std::deque<std::function<void()>> jobs; //等待执行的作业
+    std::mutex jobMtx;
+    std::condition_variable jobCv;
+    bool jobStopping = false;
+    size_t jobThreadCount = 2;
+
+    MatrixThreadPool()
+    {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0)
+            threadCount = 1;
+    }
 
-        //确定行数，输入数据
-        uRow = dataVec.size();
-        pData = new T[uCol * uRow];
-        for (size_t i = 0; i < dataVec.size(); ++i)
-            memcpy_s(pData + i * uCol, uCol * sizeof(T), dataVec[i].data(), uCol * sizeof(T));
+    ~MatrixThreadPool()
+    {
+        StopJobThreads();
+        StopWorkers();
     }
 
-    /**
-     * @brief 矩阵构造函数：从初始化列表
-     * 
-     * 使用嵌套的初始化列表构造矩阵
-     * 格式如 { {2, 5, 9}, {1.0, 22, 6}, {0, 98, 6}, ...}
-     * 每个内列表指定行元素，第一个内列表的元素个数指定矩阵列数
-     * 若后续内列表缺项，将报错。
-     * 
-     * @param iList 嵌套的初始化列表
-     */
-    explicit Matrix(std::initializer_list<std::initializer_list<T>> iList)
+    //当前线程是否正在执行并行区域
+    static bool &InRegion()
     {
-        uCol = (*iList.begin()).size();
-        uRow = iList.size();
-        pData = new T[uCol * uRow];
+        thread_local bool inRegion = false;
+        return inRegion;
+    }
 
-        for (size_t i = 0; i < uRow; ++i)
+    void StartWorkers()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!workers.empty() || threadCount <= 1)
+            return;
+        stopping = false;
+        std::vector<int> cpus;
+        if (bPinned)
+            cpus = NodeOrderedCpus();
+        for (size_t w = 1; w < threadCount; ++w)
         {
-            auto &inner = iList.begin()[i];
-            assert(uCol == inner.size());
-            memcpy_s(pData + i * uCol, uCol * sizeof(T), inner.begin(), uCol * sizeof(T));
+            int cpu = cpus.empty() ? -1 : cpus[w % cpus.size()];
+            workers.emplace_back([this, w, cpu]
+                                 {
+                                     if (cpu >= 0)
+                                         PinCurrentThread(cpu);
+                                     WorkerLoop(w);
+                                 });
         }
     }
 
-    /**
-     * @brief  矩阵构造函数：从变长数组
-     * 
-     * @param row 行数
-     * @param col 列数
-     * @param vec 数据
-     */
-    Matrix(size_t row, size_t col, const std::vector<T> &vec) : Matrix(row, col, vec.data(), vec.size()) {}
-
-    /**
-        @brief  拷贝构造函数：
-
-        使用现有矩阵复制构造
-        @param mat 矩阵对象的引用
-    */
-    Matrix(const Matrix &mat) : Matrix(mat.uRow, mat.uCol, mat.pData, mat.uRow * mat.uCol) {}
+    //本进程可用的CPU，按NUMA节点排序；无法获取时返回空
+    static std::vector<int> NodeOrderedCpus()
+    {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            return cpus;
+        std::vector<char> added(CPU_SETSIZE, 0);
+        //依次读取各节点的CPU列表，如 "0-7,16-23"
+        for (int node = 0;; ++node)
+        {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file)
+                break;
+            std::string list;
+            std::getline(file, list);
+            std::istringstream ss(list);
+            std::string range;
+            while (std::getline(ss, range, ','))
+            {
+                if (range.empty())
+                    continue;
+                size_t dash = range.find('-');
+                int lo = std::stoi(range.substr(0, dash));
+                int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+                for (int c = lo; c <= hi && c < CPU_SETSIZE; ++c)
+                    if (CPU_ISSET(c, &allowed) && !added[c])
+                    {
+                        cpus.push_back(c);
+                        added[c] = 1;
+                    }
+            }
+        }
+        //没有节点信息或节点信息不全时补上其余可用的CPU
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &allowed) && !added[c])
+                cpus.push_back(c);
+#endif
+        return cpus;
+    }
 
-    /**
-        @brief  移动拷贝构造函数：
-        右值引用构造
-        @param mat 矩阵对象的右值引用，其数据指针会被置空
-    */
-    Matrix(Matrix<T> &&mat) noexcept : uRow(mat.uRow), uCol(mat.uCol), pData(mat.pData), uCapacity(mat.uCapacity)
+    static void PinCurrentThread(int cpu)
     {
-        mat.pData = nullptr;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
     }
 
-    /**
-        @brief  赋值运算符函数
+    void StopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto &t : workers)
+            t.join();
+        workers.clear();
+    }
 
-        @param mat 矩阵对象的引用
-        @return 返回被赋值对象的引用
-    */
-    Matrix<T> &operator=(const Matrix<T> &mat)
+    //执行完已提交的作业后结束作业线程
+    void StopJobThreads()
     {
-        if (this == &mat)
-            return *this;
-        this->uRow = mat.uRow;
-        this->uCol = mat.uCol;
-        this->pData = new T[mat.uCapacity];
-        assert(pData);
-        memcpy_s(this->pData, this->uRow * this->uCol * sizeof(T), mat.pData, mat.uRow * mat.uCol * sizeof(T));
-        return *this;
+        {
+            std::lock_guard<std::mutex> lock(jobMtx);
+            jobStopping = true;
+        }
+        jobCv.notify_all();
+        for (auto &t : jobThreads)
+            t.join();
+        jobThreads.clear();
+        jobStopping = false;
     }
 
-    /**
-        @brief  移动赋值运算符函数：
+    void JobLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(jobMtx);
+                jobCv.wait(lock, [&]
+                           { return jobStopping || !jobs.empty(); });
+                if (jobs.empty())
+                    return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
 
-        使用右值移动赋值
-        @param mat 矩阵对象的右值引用，其数据指针会被置空
-        @return 被赋值对象的引用
-    */
-    Matrix<T> &operator=(Matrix<T> &&mat) noexcept
+    void WorkerLoop(size_t index)
     {
-        if (&mat == this)
-            return *this;
-        this->uRow = mat.uRow;
-        this->uCol = mat.uCol;
-        this->uCapacity = mat.uCapacity;
-        this->pData = mat.pData;
-        mat.pData = nullptr;
-        return *this;
+        for (;;)
+        {
+            std::shared_ptr<Region> r;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]
+                        {
+                            if (stopping)
+                                return true;
+                            //静态区域中本线程的块已被领取时不再参与
+                            for (auto &region : regions)
+                                if (!region->bStatic || (index < region->chunks && !region->claimed[index]))
+                                {
+                                    r = region;
+                                    return true;
+                                }
+                            return false;
+                        });
+                if (stopping)
+                    return;
+            }
+            Participate(*r, index);
+        }
     }
 
-    //析构函数
-    virtual ~Matrix()
+    //领取第c块，成功则返回true
+    bool TryClaim(Region &r, size_t c)
     {
-        if (pData != nullptr)
-            delete[] pData;
+        if (r.claimed[c].exchange(true))
+            return false;
+        if (--r.unclaimed == 0)
+        {
+            //所有块都已领取，区域不再需要新的参与者
+            std::lock_guard<std::mutex> lock(mtx);
+            for (size_t i = 0; i < regions.size(); ++i)
+                if (regions[i].get() == &r)
+                {
+                    regions.erase(regions.begin() + i);
+                    break;
+                }
+        }
+        return true;
     }
 
-public:
-    //矩阵输出
-    template <typename E>
-    friend std::ostream &operator<<(std::ostream &os, const Matrix<E> &mat);
+    static void RunChunk(Region &r, size_t c)
+    {
+        size_t n = r.end - r.begin;
+        size_t b = r.begin + n * c / r.chunks;
+        size_t e = r.begin + n * (c + 1) / r.chunks;
+        InRegion() = true;
+        try
+        {
+            r.body(b, e);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(r.mtx);
+            if (!r.error)
+                r.error = std::current_exception();
+        }
+        InRegion() = false;
+        if (--r.pending == 0)
+        {
+            std::lock_guard<std::mutex> lock(r.mtx);
+            r.done.notify_all();
+        }
+    }
 
-public:
-    /**
-        获取矩阵的数据
-        @return 矩阵数据的头指针
-    */
-    inline T *Data()
+    //参与执行区域：先执行自己对应的块，再窃取剩余的块（静态区域不窃取）
+    void Participate(Region &r, size_t preferred)
     {
-        return this->pData;
+        if (preferred < r.chunks && TryClaim(r, preferred))
+            RunChunk(r, preferred);
+        if (r.bStatic)
+            return;
+        for (size_t c = 0; c < r.chunks && r.unclaimed > 0; ++c)
+            if (TryClaim(r, c))
+                RunChunk(r, c);
     }
 
 public:
+    MatrixThreadPool(const MatrixThreadPool &) = delete;
+    MatrixThreadPool &operator=(const MatrixThreadPool &) = delete;
+
     /**
-        获取矩阵的行数
-        @return 矩阵的行数
-    */
-    size_t RowSize() const
+     * @brief 获取全局线程池
+     *
+     * @return MatrixThreadPool& 线程池的引用
+     */
+    static MatrixThreadPool &Instance()
     {
-        return uRow;
+        static MatrixThreadPool pool;
+        return pool;
     }
 
-public:
     /**
-        获取矩阵的列数
-        @return 矩阵的列数
-    */
-    size_t ColumnSize() const
+     * @brief 设置参与并行计算的线程数（包括调用线程）
+     *
+     * 默认为硬件线程数。应在没有并行计算进行时调用。
+     *
+     * @param n 线程数，为0时恢复默认值
+     */
+    static void SetThreadCount(size_t n)
     {
-        return uCol;
+        MatrixThreadPool &pool = Instance();
+        pool.StopWorkers();
+        if (n == 0)
+            n = std::thread::hardware_concurrency();
+        pool.threadCount = n > 0 ? n : 1;
     }
 
-private:
-    //数据扩增
-    void Expand()
+    /**
+     * @brief 获取参与并行计算的线程数（包括调用线程）
+     *
+     * @return size_t 线程数
+     */
+    static size_t ThreadCount()
     {
-        T *pOldData = pData;
-        pData = new T[uCapacityIncrement * uCapacity];
-        assert(pData);
-        memcpy_s(pData, sizeof(T) * uCapacity, pOldData, sizeof(T) * uCapacity);
-        uCapacity *= uCapacityIncrement;
-        delete[] pOldData;
+        return Instance().threadCount;
     }
 
-protected:
     /**
-     * @brief 访问矩阵元素，下标从1开始。
-     * 
-     * @param row 行号，从1开始
-     * @param col 列号，从1开始
-     * @return const T& 元素的常引用
+     * @brief 设置同时执行的作业数（作业线程数），默认为2
+     *
+     * 先等待已提交的作业全部完成，新的作业线程在下次提交时创建。
+     *
+     * @param n 作业线程数，为0时视为1
      */
-    inline const T &ElementAt(size_t row, size_t col) const
+    static void SetJobThreadCount(size_t n)
     {
-        return pData[(row - 1) * uCol + col - 1];
+        MatrixThreadPool &pool = Instance();
+        pool.StopJobThreads();
+        pool.jobThreadCount = n > 0 ? n : 1;
     }
 
-public:
-#ifdef MATRIX_INDEX_START_AT_0
     /**
-     * @brief 获取矩阵元素的引用，下标从0开始。
-     * 
-     * 因为已经定义 MATRIX_INDEX_START_AT_0 ,本函数启用。若要
-     * 使该函数下标从1开始，请勿定义 MATRIX_INDEX_START_AT_0
-     * 
-     * @param row 行号，从0开始
-     * @param col 列号，从0开始
-     * @return T& 元素的引用
+     * @brief 提交一个作业，由作业线程按提交顺序执行
+     *
+     * job不应抛出异常，也不应等待其它作业的结果。通常使用 MatrixJobControl::Async()。
+     *
+     * @param job 作业
      */
-    inline T &operator()(size_t row, size_t col)
+    static void Submit(std::function<void()> job)
     {
-        assert(row < uRow && col < uCol);
-        return pData[row * uCol + col];
+        MatrixThreadPool &pool = Instance();
+        {
+            std::lock_guard<std::mutex> lock(pool.jobMtx);
+            pool.jobs.push_back(std::move(job));
+            while (pool.jobThreads.size() < pool.jobThreadCount)
+                pool.jobThreads.emplace_back([&pool]
+                                             { pool.JobLoop(); });
+        }
+        pool.jobCv.notify_one();
     }
-#else
+
     /**
-     * @brief 获取矩阵元素的引用，行列序号从1开始。
-     * 
-     * 因为未定义 MATRIX_INDEX_START_AT_0 ,本函数启用。若要
-     * 使该函数行列序号从0开始，请在包含本头文件前定义 MATRIX_INDEX_START_AT_0
-     * 
-     * @param row 行号，从1开始
-     * @param col 列号，从1开始
-     * @return T& 元素的引用
+     * @brief 设置是否把工作线程绑定到CPU（仅Linux）
+     *
+     * 第w个工作线程绑定到按NUMA节点排序后的第w个可用CPU，调用线程不绑定。
+     * 与 SetThreadCount() 一样应在没有并行计算进行时调用，工作线程在下次并行计算时重新创建。
+     *
+     * @param pin 是否绑定
      */
-    inline T &operator()(size_t row, size_t col)
+    static void PinWorkers(bool pin)
     {
-        assert(row > 0 && col > 0 && row <= uRow && col <= uCol);
-        return pData[(row - 1) * uCol + col - 1];
+        MatrixThreadPool &pool = Instance();
+        pool.StopWorkers();
+        pool.bPinned = pin;
     }
-#endif
 
-public:
     /**
-        @brief 元素访问与修改，行列序号从1开始
+     * @brief 每个参与线程恰好执行一次 body(index, count)
+     *
+     * count为 ThreadCount()，第index次调用一定由第index个线程执行（第0次由调用线程执行），
+     * 不被其它线程窃取，因此与 ParallelFor() 对同一区间的划分落在相同的线程上。
+     * 在并行区域内调用时在当前线程依次执行。
+     *
+     * @param body 形如 void(size_t index, size_t count) 的函数
+     */
+    template <typename F>
+    static void RunOnEachThread(F &&body)
+    {
+        MatrixThreadPool &pool = Instance();
+        size_t count = pool.threadCount;
+        if (count <= 1 || InRegion())
+        {
+            for (size_t c = 0; c < count; ++c)
+                body(c, count);
+            return;
+        }
 
-        该函数的行列序号始终从1开始，无论 MATRIX_INDEX_START_AT_0
-        是否被定义
+        pool.StartWorkers();
+        auto r = std::make_shared<Region>();
+        r->body = [&body, count](size_t b, size_t e)
+        {
+            for (size_t c = b; c < e; ++c)
+                body(c, count);
+        };
+        r->begin = 0;
+        r->end = count;
+        r->chunks = count;
+        r->bStatic = true;
+        r->claimed.reset(new std::atomic<bool>[count]);
+        for (size_t c = 0; c < count; ++c)
+            r->claimed[c] = false;
+        r->unclaimed = count;
+        r->pending = count;
+        {
+            std::lock_guard<std::mutex> lock(pool.mtx);
+            pool.regions.push_back(r);
+        }
+        pool.cv.notify_all();
 
-        @param row 元素所在的行数，从1开始
-        @param col 元素所在的列数，从1开始
-        @return 矩阵元素的引用
-    */
-    inline T &ElemAt(size_t row, size_t col)
-    {
-        assert(row > 0 && col > 0 && row <= uRow && col <= uCol);
-        return pData[(row - 1) * uCol + col - 1];
+        pool.Participate(*r, 0);
+        {
+            std::unique_lock<std::mutex> lock(r->mtx);
+            r->done.wait(lock, [&]
+                         { return r->pending == 0; });
+        }
+        if (r->error)
+            std::rethrow_exception(r->error);
     }
 
-public:
     /**
-        @brief 元素访问与修改，行列序号从1开始
-
-        该函数的行列序号始终从1开始，无论 MATRIX_INDEX_START_AT_0
-        是否被定义
-
-        @param row 元素所在的行数，从1开始
-        @param col 元素所在的列数，从1开始
-        @return 矩阵元素的引用
-    */
-    inline const T &ElemAt(size_t row, size_t col) const
+     * @brief 并行执行区间 [begin, end)
+     *
+     * 区间被划分为至多 ThreadCount() 块，每块不少于 grain 个下标，
+     * 对每块调用 body(blockBegin, blockEnd)。函数在所有块完成后返回，
+     * 若有块抛出异常，将在调用线程重新抛出第一个异常。
+     *
+     * @param begin 起始下标
+     * @param end   结束下标（不包含）
+     * @param grain 每块的最少下标数
+     * @param body  块函数
+     */
+    template <typename F>
+    static void ParallelFor(size_t begin, size_t end, size_t grain, F &&body)
     {
-        assert(row > 0 && col > 0 && row <= uRow && col <= uCol);
-        return pData[(row - 1) * uCol + col - 1];
+        if (end <= begin)
+            return;
+        MatrixThreadPool &pool = Instance();
+        size_t n = end - begin;
+        grain = grain > 0 ? grain : 1;
+        size_t chunks = (n + grain - 1) / grain;
+        if (chunks > pool.threadCount)
+            chunks = pool.threadCount;
+        if (chunks <= 1 || InRegion())
+        {
+            body(begin, end);
+            return;
+        }
+
+        pool.StartWorkers();
+        auto r = std::make_shared<Region>();
+        r->body = std::forward<F>(body);
+        r->begin = begin;
+        r->end = end;
+        r->chunks = chunks;
+        r->claimed.reset(new std::atomic<bool>[chunks]);
+        for (size_t c = 0; c < chunks; ++c)
+            r->claimed[c] = false;
+        r->unclaimed = chunks;
+        r->pending = chunks;
+        {
+            std::lock_guard<std::mutex> lock(pool.mtx);
+            pool.regions.push_back(r);
+        }
+        pool.cv.notify_all();
+
+        pool.Participate(*r, 0);
+        {
+            std::unique_lock<std::mutex> lock(r->mtx);
+            r->done.wait(lock, [&]
+                         { return r->pending == 0; });
+        }
+        if (r->error)
+            std::rethrow_exception(r->error);
     }
+};
 
+///////////////////////////////////////////////////////////////////////////////////
+//                                 异步作业
+//
+//     求逆、行最简形、大矩阵乘法和矩阵分解可能耗时数秒到数分钟。Matrix 的 InverseAsync()、
+// MultiplyAsync() 等接口以及 MatrixJobControl::Async() 把运算作为作业交给线程池的作业线程，
+// 立即返回 std::future；作业内部的并行计算仍由工作线程完成，多个作业可以同时进行。
+//
+//     分块算法在块与块之间设置检查点：分块消元的每个面板、行最简形回代的每个块、作业中
+// 矩阵乘法的每个行块、Cholesky分解的每64行。检查点更新作业进度，作业被取消时抛出
+// MatrixCancelled，由 future::get() 重新抛出。没有检查点的运算只在开始前检查是否被取消。
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 作业被取消时由检查点抛出的异常
+ */
+class MatrixCancelled : public std::exception
+{
 public:
-    /**
-        @brief 元素访问与修改，行列序号从0开始
+    const char *what() const noexcept override
+    {
+        return "matrix job cancelled";
+    }
+};
 
-        该函数的行列序号始终从0开始，无论 MATRIX_INDEX_START_AT_0
-        是否被定义
+/**
+ * @brief 异步作业的控制对象：取消标志与进度
+ *
+ * 拷贝得到的对象共享同一状态，可以在任意线程调用 Cancel() 与 Progress()。
+ * 通常每个作业使用一个控制对象；多个作业共用时 Cancel() 取消所有作业，进度为各作业报告的最大值。
+ */
+class MatrixJobControl
+{
+private:
+    struct State
+    {
+        std::atomic<bool> cancelled{false};
+        std::atomic<double> progress{0.0};
+        std::function<void(double)> onProgress;
+    };
 
-        @param row 元素所在的行数，从0开始
-        @param col 元素所在的列数，从0开始
-        @return 矩阵元素的引用
-    */
-    inline T &ElemAt0(size_t row, size_t col)
+    //当前线程正在执行的作业；base与span把当前阶段的进度映射到整个作业
+    struct Scope
     {
-        assert(row < uRow && col < uCol);
-        return pData[row * uCol + col];
+        State *state;
+        double base;
+        double span;
+    };
+
+    std::shared_ptr<State> state;
+
+    static Scope *&Current()
+    {
+        thread_local Scope *scope = nullptr;
+        return scope;
+    }
+
+    static void Report(State &st, double progress)
+    {
+        if (progress <= st.progress.load(std::memory_order_relaxed))
+            return;
+        st.progress.store(progress, std::memory_order_relaxed);
+        if (st.onProgress)
+            st.onProgress(progress);
     }
 
 public:
-    /**
-        @brief 元素访问与修改，行列序号从0开始
+    MatrixJobControl() : state(std::make_shared<State>())
+    {
+    }
 
-        该函数的行列序号始终从0开始，无论 MATRIX_INDEX_START_AT_0
-        是否被定义
+    //请求取消，作业在下一个检查点结束
+    void Cancel()
+    {
+        state->cancelled.store(true, std::memory_order_relaxed);
+    }
 
-        @param row 元素所在的行数，从0开始
-        @param col 元素所在的列数，从0开始
-        @return 矩阵元素的引用
-    */
-    inline const T &ElemAt0(size_t row, size_t col) const
+    //是否已请求取消
+    bool IsCancelled() const
     {
-        assert(row < uRow && col < uCol);
-        return pData[row * uCol + col];
+        return state->cancelled.load(std::memory_order_relaxed);
+    }
+
+    //作业进度，在0到1之间；作业正常结束后为1
+    double Progress() const
+    {
+        return state->progress.load(std::memory_order_relaxed);
     }
 
-private:
     /**
-     * @brief 求元素在线性数组中的下标
-     * 
-     * @param row 行号，从1开始
-     * @param col 列号，从1开始
-     * @return size_t 元素在数据中的下标
+     * @brief 设置进度回调，作业线程在进度增加时以新的进度调用
+     *
+     * 应在提交作业之前设置；多个作业共用控制对象时回调可能被同时调用。
+     *
+     * @param callback 形如 void(double progress) 的函数
      */
-    inline size_t IndexAt(size_t row, size_t col) const
+    void SetProgressCallback(std::function<void(double)> callback)
     {
-        return (row - 1) * uCol + col - 1;
+        state->onProgress = std::move(callback);
     }
 
-public:
     /**
-     * @brief 遍历矩阵元素
-     * 
-     * @param pOps 对每个元素执行的操作
-     * @return Matrix<T>& 本对象的引用
+     * @brief 在线程池的作业线程上执行f，返回保存其结果的 future
+     *
+     * f开始前检查一次是否已被取消；f抛出的异常（包括 MatrixCancelled）由 future 重新抛出。
+     * 作业线程数见 MatrixThreadPool::SetJobThreadCount()，f不应等待其它作业的结果。
+     *
+     * @param f 形如 R() 的函数，R不为void，移入作业中保存
+     * @return std::future<R> f的返回值
      */
-    Matrix<T> &ForEach(bool (*pOps)(T &))
+    template <typename F>
+    std::future<decltype(std::declval<F &>()())> Async(F f) const
     {
-        auto ps = pData - 1;
-        auto pe = pData + uCol * uRow;
-        while (ps != pe)
-            if (!pOps(*(++ps)))
-                break;
-        return *this;
+        typedef decltype(std::declval<F &>()()) R;
+        std::shared_ptr<State> st = state;
+        auto task = std::make_shared<std::packaged_task<R()>>([st, f = std::move(f)]() mutable
+                                                              {
+                                                                  Scope scope{st.get(), 0.0, 1.0};
+                                                                  Scope *outer = Current();
+                                                                  Current() = &scope;
+                                                                  struct Restore
+                                                                  {
+                                                                      Scope *outer;
+                                                                      ~Restore() { Current() = outer; }
+                                                                  } restore{outer};
+                                                                  Checkpoint(0.0);
+                                                                  R r = f();
+                                                                  Report(*st, 1.0);
+                                                                  return r;
+                                                              });
+        std::future<R> result = task->get_future();
+        MatrixThreadPool::Submit([task]
+                                 { (*task)(); });
+        return result;
     }
 
-public:
     /**
-     * @brief 遍历矩阵元素
-     * 
-     * @param pOps 对每个元素执行的操作(函数指针)
-     * @return Matrix<T>& 本对象的引用
+     * @brief 检查点：报告当前阶段已完成的比例，作业已被取消时抛出 MatrixCancelled
+     *
+     * 由库的分块算法在块之间调用，也可以在传给 Async() 的函数中调用；不在作业中时什么也不做。
+     *
+     * @param fraction 当前阶段已完成的比例，在0到1之间
      */
-    Matrix<T> &ForEach(bool (*pOps)(T &, size_t))
+    static void Checkpoint(double fraction)
     {
-        auto ps = pData - 1;
-        auto pe = pData + uCol * uRow;
-#ifdef MATRIX_INDEX_START_AT_0
-        size_t idx = -1;
-#else
-        size_t idx = 0;
-#endif
-        while (ps != pe)
-            if (!pOps(*(++ps), ++idx))
-                break;
-        return *this;
+        Scope *scope = Current();
+        if (scope == nullptr)
+            return;
+        Report(*scope->state, scope->base + scope->span * fraction);
+        if (scope->state->cancelled.load(std::memory_order_relaxed))
+            throw MatrixCancelled();
+    }
+
+    //当前线程是否正在执行作业
+    static bool InJob()
+    {
+        return Current() != nullptr;
     }
 
-public:
     /**
-        @brief 在矩阵中插入一行数据，可能会引起数据扩增
+     * @brief 作业的一个阶段：生存期内检查点报告的比例映射到外层进度的 [from, to] 区间
+     *
+     * 例如依次进行的两个运算可分别放在 Phase(0, 0.5) 与 Phase(0.5, 1) 中。不在作业中时什么也不做。
+     */
+    class Phase
+    {
+    private:
+        Scope *scope;
+        double base = 0.0;
+        double span = 1.0;
 
-        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-        否则从1开始。
+    public:
+        Phase(double from, double to) : scope(Current())
+        {
+            if (scope == nullptr)
+                return;
+            base = scope->base;
+            span = scope->span;
+            scope->base = base + span * from;
+            scope->span = span * (to - from);
+        }
 
-        @param pos			要插入到的行序号
-        @param pNewRowData	要插入的行数据的指针
-        @param dataSize		要插入的行数据的个数，若少于列数，将使用0补齐
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &InsertRow(size_t pos, const T *pNewRowData, size_t dataSize)
-    {
-#ifdef MATRIX_INDEX_START_AT_0
-        ++pos;
-#endif
-        //检查位置是否合法
-        assert(pos <= uRow + 1 && pos != 0);
+        ~Phase()
+        {
+            if (scope == nullptr)
+                return;
+            scope->base = base;
+            scope->span = span;
+        }
 
-        //实际添加的数据个数n
-        size_t n = uCol < dataSize ? uCol : dataSize;
+        Phase(const Phase &) = delete;
+        Phase &operator=(const Phase &) = delete;
+    };
+};
 
-        //检查容量是否充足，否则分配内存
-        if ((uRow + 1) * uCol < uCapacity)
-            Expand();
+///////////////////////////////////////////////////////////////////////////////////
+//                                 内存放置
+//
+//     操作系统在线程第一次写入某页时才为它分配物理内存，并放在该线程所在的NUMA节点上
+// （first touch）。矩阵数据默认由构造线程值初始化，所有页都落在同一节点，多路服务器上
+// 其它节点的线程只能跨节点访问。MatrixMemory 的策略让线程池中的线程并行完成初始化：
+//
+//      BLOCK_ROWS  行按 ParallelFor() 的公式划分：块数为 min(线程数, ⌈行数/grain⌉)，
+//                  第c块由第c个线程写入，矩阵取逐元素运算的 grain
+//      INTERLEAVE  页按线程轮流写入，适合被所有线程读取的矩阵（如GEMM的B）
+//
+//     BLOCK_ROWS 只能尽量对齐：以其它 grain 划分的运算（如GEMM按乘加次数取 grain）块数
+// 可能不同，ParallelFor() 中空闲的线程还会窃取其它线程的块，这时处理某块的线程不一定
+// 是写入它的线程。
+//
+//     配合 MatrixThreadPool::PinWorkers() 使用，线程才不会迁移到其它节点。策略只对
+// 平凡可默认构造的元素类型、较大的矩阵起作用，其余情况仍由调用线程初始化。
+///////////////////////////////////////////////////////////////////////////////////
 
-        //向后移动数据
-        //获取末尾元素指针
-        T *pLastElem = &ElemAt(uRow, uCol);
-        size_t CopyLen = 1 + IndexAt(uRow, uCol) - IndexAt(pos, 1);
-        for (size_t i = 0; i < CopyLen; ++i)
-            *(pLastElem - i + uCol) = *(pLastElem - i);
+/**
+ * @brief 矩阵数据的内存放置策略
+ */
+class MatrixMemory
+{
+public:
+    enum Policy
+    {
+        CALLER,     //由分配数据的线程初始化（默认）
+        BLOCK_ROWS, //按行分块，由处理该块的线程初始化
+        INTERLEAVE, //按页轮流由各线程初始化
+    };
 
-        ++uRow;
-        T *pNewRowHead = &ElemAt(pos, 1);
-        for (size_t i = 0; i < n; ++i) //复制数据
-            *(pNewRowHead + i) = pNewRowData[i];
-        for (size_t i = n; i < uCol; ++i) //用0把这行填满
-            *(pNewRowHead + i) = T(0);
+    static const size_t uFirstTouchBytes = size_t(1) << 21; //按策略放置的最小字节数
+    static const size_t uPageSize = 4096;                   //页大小
 
-        return *this;
+private:
+    static std::atomic<int> &DefaultPolicyRef()
+    {
+        static std::atomic<int> policy{CALLER};
+        return policy;
     }
 
 public:
     /**
-        @brief 在矩阵中插入一行数据，可能会引起数据扩增
-
-        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-        否则从1开始。
+     * @brief 设置新分配的矩阵数据默认使用的策略
+     *
+     * 已有的矩阵不受影响，可用 Matrix<T>::SetMemoryPolicy() 单独设置。
+     *
+     * @param policy 放置策略
+     */
+    static void SetDefaultPolicy(Policy policy)
+    {
+        DefaultPolicyRef().store(policy, std::memory_order_relaxed);
+    }
 
-        @param pos			要插入到的行序号
-        @param pNewRowData	要插入的行数据的指针
-        @param dataSize		要插入的行数据的个数，若少于列数，将使用0补齐
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &InsertRow(size_t pos, const std::vector<T> &rowData)
+    //新分配的矩阵数据默认使用的策略
+    static Policy DefaultPolicy()
     {
-        return InsertRow(pos, rowData.data(), rowData.size());
+        return Policy(DefaultPolicyRef().load(std::memory_order_relaxed));
     }
 
-public:
     /**
-        @brief 在矩阵中插入一列数据，可能会引起数据扩增
+     * @brief 分配count个值初始化的元素，前 rows×cols 个元素是rows行、每行cols个元素的矩阵数据
+     *
+     * @param count     元素个数（容量）
+     * @param rows      矩阵行数
+     * @param cols      矩阵列数
+     * @param policy    放置策略
+     * @param grain     BLOCK_ROWS 策略按 ParallelFor(0, rows, grain, ...) 划分行
+     * @return T* 以 new[] 分配的数据
+     */
+    template <typename T>
+    static T *Allocate(size_t count, size_t rows, size_t cols, Policy policy, size_t grain = 1)
+    {
+        size_t threads = MatrixThreadPool::ThreadCount();
+        if (policy == CALLER || threads <= 1 || count * sizeof(T) < uFirstTouchBytes ||
+            !std::is_trivially_default_constructible<T>::value)
+            return new T[count]{};
+
+        //默认初始化不写入内存，页在下面第一次写入时才分配
+        T *p = new T[count];
+        size_t used = rows * cols;
+        grain = grain > 0 ? grain : 1;
+        size_t chunks = (rows + grain - 1) / grain;
+        MatrixThreadPool::RunOnEachThread([=](size_t c, size_t n)
+                                          {
+                                              if (policy == BLOCK_ROWS)
+                                              {
+                                                  //与 ParallelFor(0, rows, grain, ...) 的划分相同，多余的线程不写行数据
+                                                  size_t k = chunks < n ? chunks : n;
+                                                  if (c < k)
+                                                      std::fill(p + rows * c / k * cols, p + rows * (c + 1) / k * cols, T());
+                                                  size_t spare = count - used;
+                                                  std::fill(p + used + spare * c / n, p + used + spare * (c + 1) / n, T());
+                                                  return;
+                                              }
+                                              //第k页由第 k mod n 个线程写入，跨页的元素属于起始地址所在的页
+                                              uintptr_t base = reinterpret_cast<uintptr_t>(p);
+                                              uintptr_t first = base / uPageSize * uPageSize;
+                                              size_t pages = (base + count * sizeof(T) - first + uPageSize - 1) / uPageSize;
+                                              for (size_t k = c; k < pages; k += n)
+                                              {
+                                                  uintptr_t lo = first + k * uPageSize, hi = lo + uPageSize;
+                                                  size_t b = lo <= base ? 0 : (lo - base + sizeof(T) - 1) / sizeof(T);
+                                                  size_t e = (hi - base + sizeof(T) - 1) / sizeof(T);
+                                                  std::fill(p + b, p + (e < count ? e : count), T());
+                                              }
+                                          });
+        return p;
+    }
+};
 
-        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-        否则从1开始。
+//限定指针无别名，帮助编译器向量化内层循环
+#if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+#define MATRIX_RESTRICT __restrict
+#else
+#define MATRIX_RESTRICT
+#endif
 
-        @param pos			要插入到的列序号
-        @param pNewRowData	要插入的列数据的指针
-        @param dataSize		要插入的列数据的个数，若少于行数，将使用0补齐
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &InsertColumn(size_t pos, const T *pNewColData, size_t dataSize)
-    {
-#ifdef MATRIX_INDEX_START_AT_0
-        ++pos;
+///////////////////////////////////////////////////////////////////////////////////
+//                               16位浮点类型
+//
+//     Half（IEEE 754 binary16）与 BFloat16（float的高16位）只作为存储格式：元素隐式转换为
+// float参与运算，结果舍入（就近舍入到偶数）后存回，因此 Matrix<Half> 的逐元素运算
+// 以float计算。GEMM、GEMV、内积与求和以float累加。
+//
+//     成批转换在运行时检测CPU：支持F16C时以 vcvtph2ps/vcvtps2ph 转换Half，支持
+// AVX-512-BF16时以 vcvtneps2bf16 把float转换为BFloat16（该指令把非规格化数当作0），
+// 否则使用软件转换。BFloat16到float只需移位，软件实现即可向量化。
+//
+//     GEMV的内层（与float向量的内积、AXPY）在支持AVX2与FMA时直接从16位数据载入并转换
+// 到寄存器中累加，不经过临时缓冲；访存量是float矩阵的一半。
+///////////////////////////////////////////////////////////////////////////////////
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MATRIX_X86_DISPATCH
+#if (defined(__clang__) && __clang_major__ >= 9) || (!defined(__clang__) && __GNUC__ >= 10)
+#define MATRIX_X86_DISPATCH_BF16
+#endif
 #endif
-        //检查插入位置是否合法
-        assert(pos <= uCol + 1 && pos != 0);
 
-        //实际添加的数据个数n
-        size_t n = uRow < dataSize ? uRow : dataSize;
+struct Half;
+struct BFloat16;
 
-        //检查容量是否充足，否则分配内存
-        if (uRow * (uCol + 1) < uCapacity)
-            Expand();
+/**
+ * @brief 16位浮点数的转换函数
+ *
+ * 单个元素的转换为软件实现（编译时启用F16C则使用对应指令），
+ * 成批转换按CPU支持的指令集在运行时选择实现，长数组由线程池并行。
+ */
+class ReducedPrecision
+{
+private:
+    static const size_t uParallelSize = size_t(1) << 15; //成批转换并行的最小长度
+    static const size_t uWidenBlock = 1024;              //无向量指令时每次转换为float的元素个数
 
-        //向后移动数据--------------
-        //获取末尾元素指针
-        T *pLastElem = &ElemAt(uRow, uCol);
-        //先处理最后一行在插入列右侧的数据的移动
-        for (size_t i = 0; i < uCol - pos + 1; ++i)
-            *(pLastElem - i + uRow) = *(pLastElem - i);
-        //再向前分每uCol个元素一组处理数据移动
-        for (size_t Shift = uRow - 1; Shift >= 1; --Shift)
+public:
+    //binary16的位模式转换为float
+    static float HalfToFloat(uint16_t h)
+    {
+#ifdef __F16C__
+        return _cvtsh_ss(h);
+#else
+        uint32_t sign = uint32_t(h & 0x8000) << 16;
+        uint32_t exp = (h >> 10) & 0x1f, man = h & 0x3ff;
+        uint32_t bits;
+        if (exp == 0x1f)
+            bits = sign | 0x7f800000 | (man << 13);
+        else if (exp != 0)
+            bits = sign | ((exp + 112) << 23) | (man << 13);
+        else
         {
-            T *pSectionLast = &ElemAt(Shift + 1, pos - 1);
-            for (size_t i = 0; i < uCol; ++i)
-                *(pSectionLast - i + Shift) = *(pSectionLast - i);
+            //非规格化数 man·2⁻²⁴ 可由float精确表示
+            float f = float(man) * 5.9604644775390625e-8f;
+            memcpy(&bits, &f, sizeof(bits));
+            bits |= sign;
         }
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+#endif
+    }
 
-        //拷贝数据到新列----------
-        ++uCol;
-        //获取空出的第一个位置的指针
-        T *pBlankPos = &ElemAt(1, pos);
-        for (size_t i = 0; i < n; ++i)
-            *(pBlankPos + i * uCol) = pNewColData[i];
-        for (size_t i = n; i < uRow; ++i)
-            *(pBlankPos + i * uCol) = T(0);
+    //float就近舍入到偶数，转换为binary16的位模式
+    static uint16_t FloatToHalf(float f)
+    {
+#ifdef __F16C__
+        return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#else
+        uint32_t x;
+        memcpy(&x, &f, sizeof(x));
+        uint32_t sign = (x >> 16) & 0x8000;
+        x &= 0x7fffffff;
+        uint16_t h;
+        if (x >= 0x47800000) //不小于65536：上溢为无穷，NaN保持为静默NaN
+            h = x > 0x7f800000 ? 0x7e00 : 0x7c00;
+        else if (x < 0x38800000) //小于2⁻¹⁴：加0.5使尾数对齐到非规格化数的精度，由硬件完成舍入
+        {
+            float a;
+            memcpy(&a, &x, sizeof(a));
+            a += 0.5f;
+            memcpy(&x, &a, sizeof(x));
+            h = uint16_t(x - 0x3f000000);
+        }
+        else
+        {
+            uint32_t odd = (x >> 13) & 1;
+            x += 0xc8000fffu + odd; //指数减去112，并在第13位就近舍入到偶数
+            h = uint16_t(x >> 13);
+        }
+        return uint16_t(h | sign);
+#endif
+    }
 
-        return *this;
+    //bfloat16的位模式转换为float
+    static float BFloat16ToFloat(uint16_t b)
+    {
+        uint32_t bits = uint32_t(b) << 16;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    //float就近舍入到偶数，转换为bfloat16的位模式
+    static uint16_t FloatToBFloat16(float f)
+    {
+        uint32_t x;
+        memcpy(&x, &f, sizeof(x));
+        if ((x & 0x7fffffff) > 0x7f800000)
+            return uint16_t((x >> 16) | 0x40);
+        x += 0x7fff + ((x >> 16) & 1);
+        return uint16_t(x >> 16);
     }
 
 public:
     /**
-        @brief 在矩阵中插入一列数据，可能会引起数据扩增
-
-        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-        否则从1开始。
+     * @brief 启用或禁用成批转换的指令集实现
+     *
+     * 禁用后始终使用软件转换，可用于对比两种实现的结果。默认启用。
+     *
+     * @param enable 是否启用
+     */
+    static void UseHardware(bool enable)
+    {
+        HardwareEnabled().store(enable, std::memory_order_relaxed);
+    }
 
-        @param pos		要插入到的列序号
-        @param colData	要插入的列数据
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &InsertColumn(size_t pos, const std::vector<T> &colData)
+    //是否以F16C指令转换Half
+    static bool HasF16C()
     {
-        return InsertColumn(pos, colData.data(), colData.size());
+#ifdef MATRIX_X86_DISPATCH
+        static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("f16c") != 0);
+        return supported && HardwareEnabled().load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
     }
 
-public:
-    /**
-        @brief 矩阵最下方添加一行数据，可能会引起数据扩增
+    //是否以AVX2、FMA与F16C指令计算16位数据与float向量的内积和AXPY
+    static bool HasAvx2Fma()
+    {
+#ifdef MATRIX_X86_DISPATCH
+        static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                                                                 __builtin_cpu_supports("f16c"));
+        return supported && HardwareEnabled().load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
 
-        @param pNewRowData	要添加的行数据的指针
-        @param dataSize		要添加的行数据的个数，若少于列数，将使用0补齐
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &AddRow(const T *pNewRowData, size_t dataSize)
+    //是否以AVX-512-BF16指令把float转换为BFloat16
+    static bool HasAvx512Bf16()
     {
-#ifdef MATRIX_INDEX_START_AT_0
-        return InsertRow(uRow, pNewRowData, dataSize);
+#ifdef MATRIX_X86_DISPATCH_BF16
+        static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx512bf16") != 0);
+        return supported && HardwareEnabled().load(std::memory_order_relaxed);
 #else
-        return InsertRow(uRow + 1, pNewRowData, dataSize);
+        return false;
 #endif
     }
 
 public:
     /**
-        @brief 矩阵最下方添加一行数据，可能会引起数据扩增
-
+     * @brief 成批转换 dst[i] = src[i]
+     *
+     * 对Half、BFloat16与float之间的转换使用向量化实现，其它类型逐元素static_cast。
+     *
+     * @param src 源数据
+     * @param dst 目标数据，不得与src重叠
+     * @param n   元素个数
+     */
+    template <typename U, typename T>
+    static void Convert(const U *src, T *dst, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = static_cast<T>(src[i]);
+    }
+
+    static void Convert(const Half *src, float *dst, size_t n)
+    {
+        ParallelConvert(reinterpret_cast<const uint16_t *>(src), dst, n, HasF16C() ? HalfToFloatF16C : HalfToFloatSoftware);
+    }
+
+    static void Convert(const float *src, Half *dst, size_t n)
+    {
+        ParallelConvert(src, reinterpret_cast<uint16_t *>(dst), n, HasF16C() ? FloatToHalfF16C : FloatToHalfSoftware);
+    }
+
+    static void Convert(const BFloat16 *src, float *dst, size_t n)
+    {
+        ParallelConvert(reinterpret_cast<const uint16_t *>(src), dst, n, BFloat16ToFloatSoftware);
+    }
+
+    static void Convert(const float *src, BFloat16 *dst, size_t n)
+    {
+        ParallelConvert(src, reinterpret_cast<uint16_t *>(dst), n, HasAvx512Bf16() ? FloatToBFloat16Avx512 : FloatToBFloat16Software);
+    }
+
+public:
+    /**
+     * @brief 16位矩阵的若干行与float向量的内积 dots[r] += Σⱼ A[r][j]·x[j]
+     *
+     * @param A     行主序的16位矩阵（Half或BFloat16）
+     * @param lda   行跨度
+     * @param rows  行数
+     * @param n     列数
+     * @param x     长度为n的float向量
+     * @param dots  输出，长度为rows，结果累加到原有值上
+     */
+    template <typename H>
+    static void DotRows(const H *A, size_t lda, size_t rows, size_t n, const float *x, float *dots)
+    {
+        const bool bf16 = std::is_same<H, BFloat16>::value;
+        const uint16_t *a = reinterpret_cast<const uint16_t *>(A);
+        if (HasAvx2Fma())
+        {
+            (bf16 ? DotRowsAvx2<true> : DotRowsAvx2<false>)(a, lda, rows, n, x, dots);
+            return;
+        }
+        //按块转换为float后计算
+        float buffer[uWidenBlock];
+        for (size_t r = 0; r < rows; ++r)
+            for (size_t j0 = 0; j0 < n; j0 += uWidenBlock)
+            {
+                size_t len = n - j0 < uWidenBlock ? n - j0 : uWidenBlock;
+                Convert(A + r * lda + j0, buffer, len);
+                float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+                size_t j = 0;
+                for (; j + 8 <= len; j += 8)
+                    for (size_t l = 0; l < 8; ++l)
+                        acc[l] += buffer[j + l] * x[j0 + j + l];
+                float sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+                for (; j < len; ++j)
+                    sum += buffer[j] * x[j0 + j];
+                dots[r] += sum;
+            }
+    }
+
+    /**
+     * @brief y += α·row，row为16位数据
+     *
+     * @param row   Half或BFloat16数据
+     * @param n     元素个数
+     * @param alpha 系数α
+     * @param y     float向量
+     */
+    template <typename H>
+    static void AxpyRow(const H *row, size_t n, float alpha, float *y)
+    {
+        const bool bf16 = std::is_same<H, BFloat16>::value;
+        if (HasAvx2Fma())
+        {
+            (bf16 ? AxpyRowAvx2<true> : AxpyRowAvx2<false>)(reinterpret_cast<const uint16_t *>(row), n, alpha, y);
+            return;
+        }
+        float buffer[uWidenBlock];
+        for (size_t j0 = 0; j0 < n; j0 += uWidenBlock)
+        {
+            size_t len = n - j0 < uWidenBlock ? n - j0 : uWidenBlock;
+            Convert(row + j0, buffer, len);
+            float *MATRIX_RESTRICT py = y + j0;
+            for (size_t j = 0; j < len; ++j)
+                py[j] += alpha * buffer[j];
+        }
+    }
+
+private:
+    static std::atomic<bool> &HardwareEnabled()
+    {
+        static std::atomic<bool> enabled(true);
+        return enabled;
+    }
+
+    //长数组按固定大小分段并行转换
+    template <typename S, typename D>
+    static void ParallelConvert(const S *src, D *dst, size_t n, void (*convert)(const S *, D *, size_t))
+    {
+        if (n < 2 * uParallelSize)
+        {
+            convert(src, dst, n);
+            return;
+        }
+        MatrixThreadPool::ParallelFor(0, n, uParallelSize, [=](size_t b, size_t e)
+                                      { convert(src + b, dst + b, e - b); });
+    }
+
+    static void HalfToFloatSoftware(const uint16_t *src, float *dst, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = HalfToFloat(src[i]);
+    }
+
+    static void FloatToHalfSoftware(const float *src, uint16_t *dst, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = FloatToHalf(src[i]);
+    }
+
+    static void BFloat16ToFloatSoftware(const uint16_t *src, float *dst, size_t n)
+    {
+        uint32_t *MATRIX_RESTRICT out = reinterpret_cast<uint32_t *>(dst);
+        for (size_t i = 0; i < n; ++i)
+            out[i] = uint32_t(src[i]) << 16;
+    }
+
+    static void FloatToBFloat16Software(const float *src, uint16_t *dst, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = FloatToBFloat16(src[i]);
+    }
+
+#ifdef MATRIX_X86_DISPATCH
+    __attribute__((target("avx,f16c"))) static void HalfToFloatF16C(const uint16_t *src, float *dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+        for (; i < n; ++i)
+            dst[i] = HalfToFloat(src[i]);
+    }
+
+    __attribute__((target("avx,f16c"))) static void FloatToHalfF16C(const float *src, uint16_t *dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+        for (; i < n; ++i)
+            dst[i] = FloatToHalf(src[i]);
+    }
+
+    //载入8个16位元素并转换为float
+    template <bool bBF16>
+    __attribute__((target("avx2,fma,f16c"))) static __m256 Load8(const uint16_t *p)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        if (bBF16)
+            return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16));
+        return _mm256_cvtph_ps(v);
+    }
+
+    __attribute__((target("avx2,fma,f16c"))) static float HorizontalSum(__m256 v)
+    {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s = _mm_hadd_ps(s, s);
+        s = _mm_hadd_ps(s, s);
+        return _mm_cvtss_f32(s);
+    }
+
+    //每次4行，复用x的每次载入
+    template <bool bBF16>
+    __attribute__((target("avx2,fma,f16c"))) static void DotRowsAvx2(const uint16_t *A, size_t lda, size_t rows, size_t n,
+                                                                        const float *x, float *dots)
+    {
+        size_t r = 0;
+        for (; r + 4 <= rows; r += 4)
+        {
+            const uint16_t *a0 = A + r * lda, *a1 = a0 + lda, *a2 = a1 + lda, *a3 = a2 + lda;
+            __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8)
+            {
+                __m256 xv = _mm256_loadu_ps(x + j);
+                s0 = _mm256_fmadd_ps(Load8<bBF16>(a0 + j), xv, s0);
+                s1 = _mm256_fmadd_ps(Load8<bBF16>(a1 + j), xv, s1);
+                s2 = _mm256_fmadd_ps(Load8<bBF16>(a2 + j), xv, s2);
+                s3 = _mm256_fmadd_ps(Load8<bBF16>(a3 + j), xv, s3);
+            }
+            float t0 = HorizontalSum(s0), t1 = HorizontalSum(s1), t2 = HorizontalSum(s2), t3 = HorizontalSum(s3);
+            for (; j < n; ++j)
+            {
+                t0 += ToFloat<bBF16>(a0[j]) * x[j];
+                t1 += ToFloat<bBF16>(a1[j]) * x[j];
+                t2 += ToFloat<bBF16>(a2[j]) * x[j];
+                t3 += ToFloat<bBF16>(a3[j]) * x[j];
+            }
+            dots[r] += t0;
+            dots[r + 1] += t1;
+            dots[r + 2] += t2;
+            dots[r + 3] += t3;
+        }
+        for (; r < rows; ++r)
+        {
+            const uint16_t *a0 = A + r * lda;
+            __m256 s0 = _mm256_setzero_ps();
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8)
+                s0 = _mm256_fmadd_ps(Load8<bBF16>(a0 + j), _mm256_loadu_ps(x + j), s0);
+            float t0 = HorizontalSum(s0);
+            for (; j < n; ++j)
+                t0 += ToFloat<bBF16>(a0[j]) * x[j];
+            dots[r] += t0;
+        }
+    }
+
+    template <bool bBF16>
+    __attribute__((target("avx2,fma,f16c"))) static void AxpyRowAvx2(const uint16_t *row, size_t n, float alpha, float *y)
+    {
+        __m256 av = _mm256_set1_ps(alpha);
+        size_t j = 0;
+        for (; j + 8 <= n; j += 8)
+            _mm256_storeu_ps(y + j, _mm256_fmadd_ps(Load8<bBF16>(row + j), av, _mm256_loadu_ps(y + j)));
+        for (; j < n; ++j)
+            y[j] += alpha * ToFloat<bBF16>(row[j]);
+    }
+#else
+    static void HalfToFloatF16C(const uint16_t *src, float *dst, size_t n)
+    {
+        HalfToFloatSoftware(src, dst, n);
+    }
+
+    static void FloatToHalfF16C(const float *src, uint16_t *dst, size_t n)
+    {
+        FloatToHalfSoftware(src, dst, n);
+    }
+
+    template <bool bBF16>
+    static void DotRowsAvx2(const uint16_t *, size_t, size_t, size_t, const float *, float *)
+    {
+    }
+
+    template <bool bBF16>
+    static void AxpyRowAvx2(const uint16_t *, size_t, float, float *)
+    {
+    }
+#endif
+
+    template <bool bBF16>
+    static float ToFloat(uint16_t v)
+    {
+        return bBF16 ? BFloat16ToFloat(v) : HalfToFloat(v);
+    }
+
+#ifdef MATRIX_X86_DISPATCH_BF16
+    __attribute__((target("avx512f,avx512bf16"))) static void FloatToBFloat16Avx512(const float *src, uint16_t *dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), (__m256i)_mm512_cvtneps_pbh(_mm512_loadu_ps(src + i)));
+        for (; i < n; ++i)
+            dst[i] = FloatToBFloat16(src[i]);
+    }
+#else
+    static void FloatToBFloat16Avx512(const float *src, uint16_t *dst, size_t n)
+    {
+        FloatToBFloat16Software(src, dst, n);
+    }
+#endif
+};
+
+/**
+ * @brief IEEE 754 半精度浮点数（binary16）
+ *
+ * 1位符号、5位指数、10位尾数，最大有限值65504，ε = 2⁻¹⁰。
+ * 可与float隐式互相转换，算术运算在float上进行，复合赋值的结果舍入后存回。
+ */
+struct Half
+{
+    uint16_t bits; //位模式
+
+    Half() = default;
+    Half(float f) : bits(ReducedPrecision::FloatToHalf(f)) {}
+    operator float() const { return ReducedPrecision::HalfToFloat(bits); }
+
+    //由位模式构造
+    static Half FromBits(uint16_t b)
+    {
+        Half h;
+        h.bits = b;
+        return h;
+    }
+
+    Half &operator+=(float v) { return *this = float(*this) + v; }
+    Half &operator-=(float v) { return *this = float(*this) - v; }
+    Half &operator*=(float v) { return *this = float(*this) * v; }
+    Half &operator/=(float v) { return *this = float(*this) / v; }
+
+    friend std::ostream &operator<<(std::ostream &os, const Half &h) { return os << float(h); }
+    friend std::istream &operator>>(std::istream &is, Half &h)
+    {
+        float f;
+        if (is >> f)
+            h = f;
+        return is;
+    }
+};
+
+/**
+ * @brief bfloat16浮点数
+ *
+ * float的高16位：1位符号、8位指数、7位尾数，表示范围与float相同，ε = 2⁻⁷。
+ * 可与float隐式互相转换，算术运算在float上进行，复合赋值的结果舍入后存回。
+ */
+struct BFloat16
+{
+    uint16_t bits; //位模式
+
+    BFloat16() = default;
+    BFloat16(float f) : bits(ReducedPrecision::FloatToBFloat16(f)) {}
+    operator float() const { return ReducedPrecision::BFloat16ToFloat(bits); }
+
+    //由位模式构造
+    static BFloat16 FromBits(uint16_t b)
+    {
+        BFloat16 h;
+        h.bits = b;
+        return h;
+    }
+
+    BFloat16 &operator+=(float v) { return *this = float(*this) + v; }
+    BFloat16 &operator-=(float v) { return *this = float(*this) - v; }
+    BFloat16 &operator*=(float v) { return *this = float(*this) * v; }
+    BFloat16 &operator/=(float v) { return *this = float(*this) / v; }
+
+    friend std::ostream &operator<<(std::ostream &os, const BFloat16 &h) { return os << float(h); }
+    friend std::istream &operator>>(std::istream &is, BFloat16 &h)
+    {
+        float f;
+        if (is >> f)
+            h = f;
+        return is;
+    }
+};
+
+namespace std
+{
+    template <>
+    class numeric_limits<Half>
+    {
+    public:
+        static const bool is_specialized = true;
+        static const bool is_signed = true;
+        static const bool is_integer = false;
+        static const bool is_exact = false;
+        static const bool has_infinity = true;
+        static const bool has_quiet_NaN = true;
+        static const bool is_iec559 = true;
+        static const int radix = 2;
+        static const int digits = 11;
+        static Half min() { return Half::FromBits(0x0400); }
+        static Half max() { return Half::FromBits(0x7bff); }
+        static Half lowest() { return Half::FromBits(0xfbff); }
+        static Half epsilon() { return Half::FromBits(0x1400); }
+        static Half denorm_min() { return Half::FromBits(0x0001); }
+        static Half infinity() { return Half::FromBits(0x7c00); }
+        static Half quiet_NaN() { return Half::FromBits(0x7e00); }
+    };
+
+    template <>
+    class numeric_limits<BFloat16>
+    {
+    public:
+        static const bool is_specialized = true;
+        static const bool is_signed = true;
+        static const bool is_integer = false;
+        static const bool is_exact = false;
+        static const bool has_infinity = true;
+        static const bool has_quiet_NaN = true;
+        static const bool is_iec559 = false;
+        static const int radix = 2;
+        static const int digits = 8;
+        static BFloat16 min() { return BFloat16::FromBits(0x0080); }
+        static BFloat16 max() { return BFloat16::FromBits(0x7f7f); }
+        static BFloat16 lowest() { return BFloat16::FromBits(0xff7f); }
+        static BFloat16 epsilon() { return BFloat16::FromBits(0x3c00); }
+        static BFloat16 denorm_min() { return BFloat16::FromBits(0x0001); }
+        static BFloat16 infinity() { return BFloat16::FromBits(0x7f80); }
+        static BFloat16 quiet_NaN() { return BFloat16::FromBits(0x7fc0); }
+    };
+}
+
+/**
+ * @brief 矩阵元素的标量特性
+ *
+ * 为实数与复数元素提供统一的共轭、绝对值、解析与输出操作。Real为对应的实数类型，
+ * 范数、容限与特征值均以Real表示；实数类型的各操作与直接运算相同。
+ *
+ * @tparam T 元素类型
+ */
+template <typename T>
+struct MatrixScalar
+{
+    typedef T Real;                   //对应的实数类型
+    static const bool bComplex = false; //是否为复数
+    static const size_t uParts = 1;   //每个元素包含的Real个数
+
+    //内积、求和与GEMM累加使用的类型，16位浮点类型以float累加
+    typedef typename std::conditional<std::is_same<T, Half>::value || std::is_same<T, BFloat16>::value,
+                                      float, T>::type Accumulator;
+
+    static T Conj(const T &x) { return x; }
+    static Real RealPart(const T &x) { return x; }
+    static Real ImagPart(const T &) { return Real(0); }
+    //由实部与虚部构造元素，实数类型忽略虚部
+    static T Compose(const Real &re, const Real &) { return re; }
+    static Real Abs(const T &x)
+    {
+        using std::abs;
+        return abs(x);
+    }
+    //|x|²
+    static Real AbsSquare(const T &x) { return x * x; }
+
+    //解析一个完整的数字字符串，有多余字符时失败
+    static bool Parse(const std::string &str, T &value)
+    {
+        std::stringstream ss(str);
+        auto &is = (ss >> value);
+        return !is.fail() && is.eof();
+    }
+
+    //按流的当前格式输出
+    static void Print(std::ostream &os, const T &x) { os << x; }
+};
+
+/**
+ * @brief 复数元素的标量特性
+ *
+ * 复数以 a+bi 的形式输出，解析时接受 a+bi、a-bj、bi、-i 等形式，因此输出可以
+ * 直接作为字符串构造函数的输入（精度为输出的4位有效数字）。
+ *
+ * @tparam U 实部与虚部的类型
+ */
+template <typename U>
+struct MatrixScalar<std::complex<U>>
+{
+    typedef U Real;
+    static const bool bComplex = true;
+    static const size_t uParts = 2;
+    typedef std::complex<U> Accumulator;
+
+    static std::complex<U> Conj(const std::complex<U> &x) { return std::conj(x); }
+    static Real RealPart(const std::complex<U> &x) { return x.real(); }
+    static Real ImagPart(const std::complex<U> &x) { return x.imag(); }
+    static std::complex<U> Compose(const Real &re, const Real &im) { return std::complex<U>(re, im); }
+    static Real Abs(const std::complex<U> &x) { return std::abs(x); }
+    static Real AbsSquare(const std::complex<U> &x) { return std::norm(x); }
+
+    static bool Parse(const std::string &str, std::complex<U> &value)
+    {
+        if (str.empty())
+            return false;
+        char last = str.back();
+        if (last != 'i' && last != 'j')
+        {
+            U re;
+            if (!MatrixScalar<U>::Parse(str, re))
+                return false;
+            value = std::complex<U>(re, U(0));
+            return true;
+        }
+
+        //虚部从最后一个不属于指数的正负号开始
+        size_t split = 0;
+        for (size_t i = str.size() - 1; i-- > 1;)
+            if ((str[i] == '+' || str[i] == '-') && str[i - 1] != 'e' && str[i - 1] != 'E')
+            {
+                split = i;
+                break;
+            }
+        U re = U(0), im;
+        if (split > 0 && !MatrixScalar<U>::Parse(str.substr(0, split), re))
+            return false;
+        std::string imStr = str.substr(split, str.size() - 1 - split);
+        if (imStr.empty() || imStr == "+")
+            im = U(1);
+        else if (imStr == "-")
+            im = U(-1);
+        else if (!MatrixScalar<U>::Parse(imStr, im))
+            return false;
+        value = std::complex<U>(re, im);
+        return true;
+    }
+
+    static void Print(std::ostream &os, const std::complex<U> &x)
+    {
+        std::ostringstream ss;
+        ss.flags(os.flags());
+        ss.precision(os.precision());
+        U im = x.imag();
+        ss << x.real() << (std::signbit(im) ? '-' : '+') << (std::signbit(im) ? -im : im) << 'i';
+        os << ss.str();
+    }
+};
+
+/**
+ * @brief 矩阵计算内核
+ *
+ * 以行主序的原始指针和行跨度（leading dimension）描述矩阵，供矩阵类及各分解类共用。
+ * 所有函数均为静态函数。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class MatrixKernel
+{
+    //16位浮点类型转换为float后调用float内核的私有函数
+    template <typename U>
+    friend class MatrixKernel;
+
+public:
+    static const size_t uGemmKBlock = 128; //GEMM在k方向的分块大小
+    static const size_t uGemmNBlock = 256; //GEMM在列方向的分块大小
+    static const size_t uPanelWidth = 64;  //分块消元的面板宽度
+    static const size_t uParallelVectorSize = size_t(1) << 15; //向量运算并行的最小长度
+    static const size_t uWidenBlock = 1024; //16位浮点转置GEMV每次处理的列数
+
+public:
+    /**
+     * @brief 通用矩阵乘法 C = αAB + βC
+     *
+     * 按C的行分块交给线程池并行，每块内对k与列方向分块以复用缓存中的B面板，
+     * 每次同时更新C的4行以复用B的每次载入。β为0时C的原有值被忽略。
+     *
+     * 复数元素在规模较大时把A、B拆分为实部与虚部平面，以4次实数GEMM计算
+     * Re(AB) = ArBr - AiBi 与 Im(AB) = ArBi + AiBr，内层循环可以向量化。
+     * 16位浮点元素（Half、BFloat16）成批转换为float后以float GEMM计算，结果舍入后写回。
+     *
+     * @param m     A与C的行数
+     * @param n     B与C的列数
+     * @param k     A的列数，B的行数
+     * @param alpha 系数α
+     * @param A     A的数据
+     * @param lda   A的行跨度
+     * @param B     B的数据
+     * @param ldb   B的行跨度
+     * @param beta  系数β
+     * @param C     C的数据
+     * @param ldc   C的行跨度
+     */
+    static void Gemm(size_t m, size_t n, size_t k, const T &alpha, const T *A, size_t lda,
+                     const T *B, size_t ldb, const T &beta, T *C, size_t ldc)
+    {
+        if (m == 0 || n == 0)
+            return;
+        if (GemmSplit(std::integral_constant<bool, MatrixScalar<T>::bComplex>(), m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+            return;
+        if (GemmWiden(Widened(), m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+            return;
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * m * n * k));
+
+        //每个并行块至少约有2^18次乘加
+        size_t rowWork = n * (k > 0 ? k : 1);
+        size_t grain = rowWork >= (size_t(1) << 18) ? 1 : (size_t(1) << 18) / rowWork;
+        MatrixThreadPool::ParallelFor(0, m, grain, [=](size_t i0, size_t i1)
+                                      { GemmRows(i0, i1, n, k, alpha, A, lda, B, ldb, beta, C, ldc); });
+    }
+
+    /**
+     * @brief 向量内积 Σ xᵢyᵢ
+     *
+     * 连续存储时使用8个独立累加器以便向量化，长向量按块并行后按块顺序合并，
+     * 因此线程数不变时结果可复现。
+     *
+     * @param n     元素个数
+     * @param x     x的数据
+     * @param incx  x的元素间距
+     * @param y     y的数据
+     * @param incy  y的元素间距
+     * @return T    内积
+     */
+    static T Dot(size_t n, const T *x, size_t incx, const T *y, size_t incy)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * n));
+        size_t chunks = MatrixThreadPool::ThreadCount();
+        if (n < uParallelVectorSize || chunks <= 1)
+            return DotSerial(n, x, incx, y, incy);
+
+        std::vector<T> partial(chunks, T(0));
+        MatrixThreadPool::ParallelFor(0, chunks, 1, [&](size_t c0, size_t c1)
+                                      {
+                                          for (size_t c = c0; c < c1; ++c)
+                                          {
+                                              size_t b = n * c / chunks, e = n * (c + 1) / chunks;
+                                              partial[c] = DotSerial(e - b, x + b * incx, incx, y + b * incy, incy);
+                                          }
+                                      });
+        T sum = T(0);
+        for (size_t c = 0; c < chunks; ++c)
+            sum += partial[c];
+        return sum;
+    }
+
+    /**
+     * @brief y = αx + y
+     *
+     * @param n     元素个数
+     * @param alpha 系数α
+     * @param x     x的数据
+     * @param incx  x的元素间距
+     * @param y     y的数据
+     * @param incy  y的元素间距
+     */
+    static void Axpy(size_t n, const T &alpha, const T *x, size_t incx, T *y, size_t incy)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * n));
+        MatrixThreadPool::ParallelFor(0, n, uParallelVectorSize, [=](size_t b, size_t e)
+                                      {
+                                          if (incx == 1 && incy == 1)
+                                          {
+                                              const T *MATRIX_RESTRICT px = x;
+                                              T *MATRIX_RESTRICT py = y;
+                                              for (size_t i = b; i < e; ++i)
+                                                  py[i] += alpha * px[i];
+                                          }
+                                          else
+                                              for (size_t i = b; i < e; ++i)
+                                                  y[i * incy] += alpha * x[i * incx];
+                                      });
+    }
+
+    /**
+     * @brief 矩阵向量乘法 y = αAx + βy 或 y = αAᵀx + βy
+     *
+     * 不转置时按行并行，每次同时计算4行的内积以复用x；
+     * 转置时不生成Aᵀ，而是按y的分段并行，每段逐行累加 αxᵢ 与A第i行对应段的乘积，
+     * 始终按行连续访问A。β为0时y的原有值被忽略。
+     *
+     * 16位浮点元素的A直接以16位读取并在寄存器中转换为float（见 ReducedPrecision::DotRows()），
+     * x与y以float累加，访存量约为float矩阵的一半。
+     *
+     * @param transpose 是否使用Aᵀ
+     * @param m         A的行数
+     * @param n         A的列数
+     * @param alpha     系数α
+     * @param A         A的数据
+     * @param lda       A的行跨度
+     * @param x         x的数据
+     * @param incx      x的元素间距
+     * @param beta      系数β
+     * @param y         y的数据
+     * @param incy      y的元素间距
+     */
+    static void Gemv(bool transpose, size_t m, size_t n, const T &alpha, const T *A, size_t lda,
+                     const T *x, size_t incx, const T &beta, T *y, size_t incy)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * m * n));
+        size_t ySize = transpose ? n : m;
+        size_t work = transpose ? m : n;
+        size_t grain = work >= uParallelVectorSize ? 4 : uParallelVectorSize / (work > 0 ? work : 1);
+        if (GemvWiden(Widened(), transpose, m, n, alpha, A, lda, x, incx, beta, y, incy, grain))
+            return;
+
+        //x不连续时先复制为连续向量
+        std::vector<T> xCopy;
+        if (incx != 1)
+        {
+            xCopy.resize(transpose ? m : n);
+            for (size_t i = 0; i < xCopy.size(); ++i)
+                xCopy[i] = x[i * incx];
+            x = xCopy.data();
+        }
+
+        MatrixThreadPool::ParallelFor(0, ySize, grain, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                              y[i * incy] = beta == T(0) ? T(0) : T(beta * y[i * incy]);
+                                          if (transpose)
+                                              GemvTransposedRange(b, e, m, alpha, A, lda, x, y, incy);
+                                          else
+                                              GemvRange(b, e, n, alpha, A, lda, x, y, incy);
+                                      });
+    }
+
+    /**
+     * @brief 求和 Σ f(xᵢ)
+     *
+     * 默认使用成对求和：不超过128个元素的叶子用8个独立累加器累加（可向量化），
+     * 叶子之间两两合并，误差界约为 (128 + log₂n)·u·Σ|f(xᵢ)|。
+     * compensated为真时使用Neumaier补偿求和，误差界约为 2u·Σ|f(xᵢ)|，与n无关，但较慢。
+     * 两种方法都以 MatrixScalar<T>::Accumulator 累加，结果只舍入一次。
+     *
+     * @param n           元素个数
+     * @param x           数据
+     * @param incx        元素间距
+     * @param compensated 是否使用补偿求和
+     * @param f           对每个元素的变换，例如取绝对值
+     * @return T          和
+     */
+    template <typename F>
+    static T Sum(size_t n, const T *x, size_t incx, bool compensated, const F &f)
+    {
+        return T(AccumulateSum(n, x, incx, compensated, f));
+    }
+
+    /**
+     * @brief 求和 Σ f(xᵢ)，返回未舍入为T的累加结果，用于再与其它部分和合并，见 Sum()
+     *
+     * @param n           元素个数
+     * @param x           数据
+     * @param incx        元素间距
+     * @param compensated 是否使用补偿求和
+     * @param f           对每个元素的变换
+     * @return Accumulator 以 MatrixScalar<T>::Accumulator 表示的和
+     */
+    template <typename F>
+    static typename MatrixScalar<T>::Accumulator AccumulateSum(size_t n, const T *x, size_t incx, bool compensated, const F &f)
+    {
+        typedef typename MatrixScalar<T>::Accumulator A;
+        MATRIX_PROFILE_EVENT(RecordFlops(n));
+        if (!compensated)
+            return PairwiseSum(n, x, incx, f);
+
+        A s = A(0), c = A(0);
+        for (size_t i = 0; i < n; ++i)
+            NeumaierAdd(s, c, f(x[i * incx]));
+        return s + c;
+    }
+
+    /**
+     * @brief Neumaier补偿加法：把v累加到和s上，舍入误差累积到c
+     *
+     * @tparam A 累加类型，由s与c推导（v的类型不参与推导）
+     * @param s 和
+     * @param c 补偿量
+     * @param v 加数
+     */
+    template <typename A>
+    static void NeumaierAdd(A &s, A &c, const typename std::decay<A>::type &v)
+    {
+        using std::abs;
+        A t = s + v;
+        if (abs(s) >= abs(v))
+            c += (s - t) + v;
+        else
+            c += (v - t) + s;
+        s = t;
+    }
+
+    /**
+     * @brief 生成Householder反射 (I - τvvᵀ)[α; x] = [β; 0]，v的首元素为1
+     *
+     * @param alpha 首元素
+     * @param xnorm 其余元素的2范数
+     * @param tau   输出的反射系数，xnorm为0时为0
+     * @param scale 输出的缩放系数，v的其余元素为 x·scale
+     * @return T    β
+     */
+    static T MakeReflector(T alpha, T xnorm, T &tau, T &scale)
+    {
+        if (xnorm == T(0))
+        {
+            tau = scale = T(0);
+            return alpha;
+        }
+        T beta = std::hypot(alpha, xnorm);
+        if (alpha >= T(0))
+            beta = -beta;
+        tau = (beta - alpha) / beta;
+        scale = T(1) / (alpha - beta);
+        return beta;
+    }
+
+    /**
+     * @brief Strassen-Winograd 矩阵乘法 C = AB
+     *
+     * 每层递归用7次子矩阵乘法和15次子矩阵加减代替8次乘法，直到三个维度中最小的一个
+     * 不大于cutoff后交给分块GEMM。各维度按递归层数补0对齐，所有补齐缓冲与各层临时
+     * 矩阵在调用开始时一次性分配。每层只需两个临时矩阵，其余中间结果存放在C的四个子块中。
+     *
+     * @param m      A与C的行数
+     * @param n      B与C的列数
+     * @param k      A的列数，B的行数
+     * @param A      A的数据
+     * @param lda    A的行跨度
+     * @param B      B的数据
+     * @param ldb    B的行跨度
+     * @param C      C的数据（输出）
+     * @param ldc    C的行跨度
+     * @param cutoff 递归截止维度
+     */
+    static void Strassen(size_t m, size_t n, size_t k, const T *A, size_t lda, const T *B, size_t ldb,
+                         T *C, size_t ldc, size_t cutoff)
+    {
+        cutoff = cutoff > 1 ? cutoff : 1;
+        size_t depth = 0;
+        while (true)
+        {
+            size_t mm = m >> depth, nn = n >> depth, kk = k >> depth;
+            if (mm <= cutoff || nn <= cutoff || kk <= cutoff)
+                break;
+            ++depth;
+        }
+        if (depth == 0 || k == 0)
+        {
+            Gemm(m, n, k, T(1), A, lda, B, ldb, T(0), C, ldc);
+            return;
+        }
+
+        //各维度补齐为 2^depth 的倍数
+        size_t align = size_t(1) << depth;
+        size_t M = (m + align - 1) / align * align;
+        size_t N = (n + align - 1) / align * align;
+        size_t K = (k + align - 1) / align * align;
+        bool padded = M != m || N != n || K != k;
+
+        //一次性计算并分配所有工作空间
+        size_t total = padded ? M * K + K * N + M * N : 0;
+        for (size_t l = 0; l < depth; ++l)
+        {
+            size_t mh = M >> (l + 1), nh = N >> (l + 1), kh = K >> (l + 1);
+            total += mh * (kh > nh ? kh : nh) + kh * nh;
+        }
+        MATRIX_PROFILE_EVENT(RecordAlloc(total * sizeof(T)));
+        std::vector<T> arena(total);
+        T *pWork = arena.data();
+
+        if (!padded)
+        {
+            StrassenLevel(M, N, K, A, lda, B, ldb, C, ldc, depth, pWork);
+            return;
+        }
+
+        T *Ap = pWork, *Bp = Ap + M * K, *Cp = Bp + K * N;
+        for (size_t i = 0; i < m; ++i)
+            std::copy(A + i * lda, A + i * lda + k, Ap + i * K);
+        for (size_t i = 0; i < k; ++i)
+            std::copy(B + i * ldb, B + i * ldb + n, Bp + i * N);
+        StrassenLevel(M, N, K, Ap, K, Bp, N, Cp, N, depth, Cp + M * N);
+        for (size_t i = 0; i < m; ++i)
+            std::copy(Cp + i * N, Cp + i * N + n, C + i * ldc);
+    }
+
+    /**
+     * @brief 分块右视高斯消元（部分选主元）
+     *
+     * 每次分解宽度为 uPanelWidth 的列面板（行交换作用于整行），再以一次三角求解
+     * 和一次GEMM更新面板右侧的尾部矩阵。消元后，第t个主元行位于第t行，
+     * 其主元所在列记录在 pivCols[t]，主元左侧保存消元乘数（L）。
+     *
+     * 当 skipZeroColumns 为true时（行阶梯形），绝对值不大于tol的主元列被跳过，不占用主元行；
+     * 为false时（LU分解），零主元列仍占用一行，乘数置0，调用者可由对角元判断奇异。
+     *
+     * @param a               矩阵数据，原地消元
+     * @param m               行数
+     * @param n               列数
+     * @param lda             行跨度
+     * @param tol             主元绝对值不大于tol视为0
+     * @param skipZeroColumns 是否跳过零主元列
+     * @param pivCols         输出：各主元所在的列（从0开始）
+     * @param swaps           输出：第t步与第t行交换的行（从0开始）
+     * @param stopAtZeroColumn 为true时在第一个零主元列处立即返回（只需判断满秩时使用），矩阵只消元了一部分
+     * @return size_t         主元个数
+     */
+    static size_t Eliminate(T *a, size_t m, size_t n, size_t lda, const typename MatrixScalar<T>::Real &tol,
+                            bool skipZeroColumns, std::vector<size_t> &pivCols, std::vector<size_t> &swaps,
+                            bool stopAtZeroColumn = false)
+    {
+        typedef typename MatrixScalar<T>::Real R;
+        pivCols.clear();
+        swaps.clear();
+
+        size_t r = 0;
+        std::vector<size_t> panelPiv;
+        std::vector<T> lPack;
+        for (size_t c0 = 0; c0 < n && r < m; c0 += uPanelWidth)
+        {
+            //检查点：剩余工作量约与剩余子矩阵的 行数·列数·min(行数, 列数) 成正比
+            double rm = double(m - r) / m, rn = double(n - c0) / n;
+            double rk = double(m - r < n - c0 ? m - r : n - c0) / (m < n ? m : n);
+            MatrixJobControl::Checkpoint(1.0 - rm * rn * rk);
+
+            size_t c1 = c0 + uPanelWidth < n ? c0 + uPanelWidth : n;
+            size_t rStart = r;
+            panelPiv.clear();
+
+            //面板分解：只更新面板内的列
+            for (size_t j = c0; j < c1 && r < m; ++j)
+            {
+                size_t p = r;
+                R maxVal = MatrixScalar<T>::Abs(a[r * lda + j]);
+                for (size_t i = r + 1; i < m; ++i)
+                {
+                    R v = MatrixScalar<T>::Abs(a[i * lda + j]);
+                    if (v > maxVal)
+                    {
+                        maxVal = v;
+                        p = i;
+                    }
+                }
+                bool zero = !(maxVal > tol);
+                if (zero && stopAtZeroColumn)
+                    return r;
+                if (zero && skipZeroColumns)
+                    continue;
+
+                if (p != r)
+                {
+                    T *MATRIX_RESTRICT pr = a + r * lda;
+                    T *MATRIX_RESTRICT pp = a + p * lda;
+                    for (size_t jj = 0; jj < n; ++jj)
+                    {
+                        T tmp = pr[jj];
+                        pr[jj] = pp[jj];
+                        pp[jj] = tmp;
+                    }
+                }
+                swaps.push_back(p);
+                pivCols.push_back(j);
+                panelPiv.push_back(j);
+
+                const T *pr = a + r * lda;
+                for (size_t i = r + 1; i < m; ++i)
+                {
+                    T *pi = a + i * lda;
+                    T l = zero ? T(0) : T(pi[j] / pr[j]);
+                    pi[j] = l;
+                    if (l == T(0))
+                        continue;
+                    for (size_t jj = j + 1; jj < c1; ++jj)
+                        pi[jj] -= l * pr[jj];
+                }
+                MATRIX_PROFILE_EVENT(RecordFlops(2ull * (m - r - 1) * (c1 - j - 1)));
+                ++r;
+            }
+
+            size_t np = r - rStart;
+            if (np == 0 || c1 >= n)
+                continue;
+
+            //面板主元行的尾部：U12 = L11⁻¹ A12，各列相互独立，按列并行
+            if (np > 1)
+                MatrixThreadPool::ParallelFor(c1, n, 256, [&](size_t jb, size_t je)
+                                              {
+                                                  for (size_t t = 1; t < np; ++t)
+                                                  {
+                                                      T *MATRIX_RESTRICT pt = a + (rStart + t) * lda;
+                                                      for (size_t s = 0; s < t; ++s)
+                                                      {
+                                                          T l = pt[panelPiv[s]];
+                                                          if (l == T(0))
+                                                              continue;
+                                                          const T *MATRIX_RESTRICT ps = a + (rStart + s) * lda;
+                                                          for (size_t jj = jb; jj < je; ++jj)
+                                                              pt[jj] -= l * ps[jj];
+                                                      }
+                                                  }
+                                              });
+
+            //尾部矩阵：A22 -= L21 U12
+            if (r < m)
+            {
+                lPack.resize((m - r) * np);
+                for (size_t i = r; i < m; ++i)
+                    for (size_t s = 0; s < np; ++s)
+                        lPack[(i - r) * np + s] = a[i * lda + panelPiv[s]];
+                Gemm(m - r, n - c1, np, T(-1), lPack.data(), np, a + rStart * lda + c1, lda,
+                     T(1), a + r * lda + c1, lda);
+            }
+        }
+        return r;
+    }
+
+    /**
+     * @brief 由 Eliminate 得到的行阶梯形（skipZeroColumns 为true）计算行最简形
+     *
+     * 清除主元左侧的乘数与非主元行，然后自下而上按块回代：块内逐行归一化并消去块内
+     * 上方元素，再以一次GEMM消去块上方所有行在块主元列上的元素。
+     *
+     * @param a       消元后的矩阵数据
+     * @param m       行数
+     * @param n       列数
+     * @param lda     行跨度
+     * @param pivCols Eliminate 输出的主元列
+     */
+    static void ReduceEchelon(T *a, size_t m, size_t n, size_t lda, const std::vector<size_t> &pivCols)
+    {
+        size_t rank = pivCols.size();
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t zeroEnd = i < rank ? pivCols[i] : n;
+            for (size_t j = 0; j < zeroEnd; ++j)
+                a[i * lda + j] = T(0);
+        }
+
+        std::vector<T> fPack;
+        for (size_t t1 = rank, t0; t1 > 0; t1 = t0)
+        {
+            //检查点：第t1个主元行以上的块约有 (t1/rank)² 的工作量未完成
+            MatrixJobControl::Checkpoint(1.0 - double(t1) * t1 / (double(rank) * rank));
+            t0 = t1 > uPanelWidth ? t1 - uPanelWidth : 0;
+
+            //块内回代
+            for (size_t t = t1; t-- > t0;)
+            {
+                size_t pc = pivCols[t];
+                T *MATRIX_RESTRICT pt = a + t * lda;
+                T pivot = pt[pc];
+                for (size_t jj = pc + 1; jj < n; ++jj)
+                    pt[jj] /= pivot;
+                pt[pc] = T(1);
+                for (size_t s = t0; s < t; ++s)
+                {
+                    T *MATRIX_RESTRICT ps = a + s * lda;
+                    T f = ps[pc];
+                    if (f == T(0))
+                        continue;
+                    for (size_t jj = pc + 1; jj < n; ++jj)
+                        ps[jj] -= f * pt[jj];
+                    ps[pc] = T(0);
+                }
+            }
+
+            //块上方的行
+            if (t0 == 0)
+                break;
+            size_t bs = t1 - t0, pc0 = pivCols[t0];
+            fPack.resize(t0 * bs);
+            for (size_t s = 0; s < t0; ++s)
+                for (size_t u = 0; u < bs; ++u)
+                    fPack[s * bs + u] = a[s * lda + pivCols[t0 + u]];
+            Gemm(t0, n - pc0, bs, T(-1), fPack.data(), bs, a + t0 * lda + pc0, lda, T(1), a + pc0, lda);
+            for (size_t s = 0; s < t0; ++s)
+                for (size_t u = 0; u < bs; ++u)
+                    a[s * lda + pivCols[t0 + u]] = T(0);
+        }
+    }
+
+private:
+    //成对求和，叶子为128个元素，以Accumulator类型累加
+    template <typename F>
+    static typename MatrixScalar<T>::Accumulator PairwiseSum(size_t n, const T *x, size_t incx, const F &f)
+    {
+        typedef typename MatrixScalar<T>::Accumulator A;
+        if (n > 128)
+        {
+            size_t half = n / 2;
+            half -= half % 8;
+            return PairwiseSum(half, x, incx, f) + PairwiseSum(n - half, x + half * incx, incx, f);
+        }
+
+        A acc[8] = {A(0), A(0), A(0), A(0), A(0), A(0), A(0), A(0)};
+        size_t i = 0;
+        if (incx == 1)
+            for (; i + 8 <= n; i += 8)
+                for (size_t l = 0; l < 8; ++l)
+                    acc[l] += f(x[i + l]);
+        A sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+        for (; i < n; ++i)
+            sum += f(x[i * incx]);
+        return sum;
+    }
+
+    //连续或跨步向量的串行内积，以Accumulator类型累加
+    static T DotSerial(size_t n, const T *x, size_t incx, const T *y, size_t incy)
+    {
+        typedef typename MatrixScalar<T>::Accumulator A;
+        if (incx != 1 || incy != 1)
+        {
+            A sum = A(0);
+            for (size_t i = 0; i < n; ++i)
+                sum += A(x[i * incx]) * A(y[i * incy]);
+            return T(sum);
+        }
+
+        A acc[8] = {A(0), A(0), A(0), A(0), A(0), A(0), A(0), A(0)};
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            for (size_t l = 0; l < 8; ++l)
+                acc[l] += A(x[i + l]) * A(y[i + l]);
+        A sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+        for (; i < n; ++i)
+            sum += A(x[i]) * A(y[i]);
+        return T(sum);
+    }
+
+    //y的第[b, e)个元素累加 α·A[b:e]·x
+    static void GemvRange(size_t b, size_t e, size_t n, const T &alpha, const T *A, size_t lda,
+                          const T *x, T *y, size_t incy)
+    {
+        size_t i = b;
+        for (; i + 4 <= e; i += 4)
+        {
+            const T *MATRIX_RESTRICT a0 = A + i * lda;
+            const T *MATRIX_RESTRICT a1 = a0 + lda;
+            const T *MATRIX_RESTRICT a2 = a1 + lda;
+            const T *MATRIX_RESTRICT a3 = a2 + lda;
+            T s0 = T(0), s1 = T(0), s2 = T(0), s3 = T(0);
+            for (size_t j = 0; j < n; ++j)
+            {
+                T xj = x[j];
+                s0 += a0[j] * xj;
+                s1 += a1[j] * xj;
+                s2 += a2[j] * xj;
+                s3 += a3[j] * xj;
+            }
+            y[i * incy] += alpha * s0;
+            y[(i + 1) * incy] += alpha * s1;
+            y[(i + 2) * incy] += alpha * s2;
+            y[(i + 3) * incy] += alpha * s3;
+        }
+        for (; i < e; ++i)
+            y[i * incy] += alpha * DotSerial(n, A + i * lda, 1, x, 1);
+    }
+
+    //y的第[b, e)个元素累加 α·(Aᵀx)[b:e]
+    static void GemvTransposedRange(size_t b, size_t e, size_t m, const T &alpha, const T *A, size_t lda,
+                                    const T *x, T *y, size_t incy)
+    {
+        for (size_t i = 0; i < m; ++i)
+        {
+            T a = alpha * x[i];
+            if (a == T(0))
+                continue;
+            const T *MATRIX_RESTRICT pa = A + i * lda;
+            if (incy == 1)
+            {
+                T *MATRIX_RESTRICT py = y;
+                for (size_t j = b; j < e; ++j)
+                    py[j] += a * pa[j];
+            }
+            else
+                for (size_t j = b; j < e; ++j)
+                    y[j * incy] += a * pa[j];
+        }
+    }
+
+    //Strassen-Winograd的一层递归，m、n、k均为偶数（depth > 0时）
+    static void StrassenLevel(size_t m, size_t n, size_t k, const T *A, size_t lda, const T *B, size_t ldb,
+                              T *C, size_t ldc, size_t depth, T *pWork)
+    {
+        if (depth == 0)
+        {
+            Gemm(m, n, k, T(1), A, lda, B, ldb, T(0), C, ldc);
+            return;
+        }
+
+        size_t mh = m / 2, nh = n / 2, kh = k / 2;
+        const T *A11 = A, *A12 = A + kh, *A21 = A + mh * lda, *A22 = A21 + kh;
+        const T *B11 = B, *B12 = B + nh, *B21 = B + kh * ldb, *B22 = B21 + nh;
+        T *C11 = C, *C12 = C + nh, *C21 = C + mh * ldc, *C22 = C21 + nh;
+
+        //本层的两个临时矩阵，X为 mh × max(kh, nh)，Y为 kh × nh
+        size_t ldx = kh > nh ? kh : nh, ldy = nh;
+        T *X = pWork, *Y = X + mh * ldx, *pNext = Y + kh * ldy;
+
+        MATRIX_PROFILE_EVENT(RecordFlops(15ull * mh * (kh > nh ? kh : nh)));
+        Combine(mh, kh, A11, lda, T(-1), A21, lda, X, ldx);            //X = S3 = A11 - A21
+        Combine(kh, nh, B22, ldb, T(-1), B12, ldb, Y, ldy);            //Y = T3 = B22 - B12
+        StrassenLevel(mh, nh, kh, X, ldx, Y, ldy, C21, ldc, depth - 1, pNext); //C21 = P7
+        Combine(mh, kh, A21, lda, T(1), A22, lda, X, ldx);             //X = S1 = A21 + A22
+        Combine(kh, nh, B12, ldb, T(-1), B11, ldb, Y, ldy);            //Y = T1 = B12 - B11
+        StrassenLevel(mh, nh, kh, X, ldx, Y, ldy, C22, ldc, depth - 1, pNext); //C22 = P5
+        Combine(mh, kh, X, ldx, T(-1), A11, lda, X, ldx);              //X = S2 = S1 - A11
+        Combine(kh, nh, B22, ldb, T(-1), Y, ldy, Y, ldy);              //Y = T2 = B22 - T1
+        StrassenLevel(mh, nh, kh, X, ldx, Y, ldy, C12, ldc, depth - 1, pNext); //C12 = P6
+        Combine(mh, kh, A12, lda, T(-1), X, ldx, X, ldx);              //X = S4 = A12 - S2
+        StrassenLevel(mh, nh, kh, X, ldx, B22, ldb, C11, ldc, depth - 1, pNext); //C11 = P3
+        StrassenLevel(mh, nh, kh, A11, lda, B11, ldb, X, ldx, depth - 1, pNext); //X = P1
+        Combine(mh, nh, X, ldx, T(1), C12, ldc, C12, ldc);             //C12 = U2 = P1 + P6
+        Combine(mh, nh, C12, ldc, T(1), C21, ldc, C21, ldc);           //C21 = U3 = U2 + P7
+        Combine(mh, nh, C12, ldc, T(1), C22, ldc, C12, ldc);           //C12 = U4 = U2 + P5
+        Combine(mh, nh, C21, ldc, T(1), C22, ldc, C22, ldc);           //C22 = U7 = U3 + P5
+        Combine(mh, nh, C12, ldc, T(1), C11, ldc, C12, ldc);           //C12 = U5 = U4 + P3
+        Combine(kh, nh, Y, ldy, T(-1), B21, ldb, Y, ldy);              //Y = T4 = T2 - B21
+        StrassenLevel(mh, nh, kh, A22, lda, Y, ldy, C11, ldc, depth - 1, pNext); //C11 = P4
+        Combine(mh, nh, C21, ldc, T(-1), C11, ldc, C21, ldc);          //C21 = U6 = U3 - P4
+        StrassenLevel(mh, nh, kh, A12, lda, B21, ldb, C11, ldc, depth - 1, pNext); //C11 = P2
+        Combine(mh, nh, X, ldx, T(1), C11, ldc, C11, ldc);             //C11 = U1 = P1 + P2
+    }
+
+    //Z = X + sY（s为1或-1），Z可以与X或Y为同一块
+    static void Combine(size_t m, size_t n, const T *X, size_t ldx, const T &s, const T *Y, size_t ldy,
+                        T *Z, size_t ldz)
+    {
+        size_t grain = n >= (size_t(1) << 15) ? 1 : (size_t(1) << 15) / (n > 0 ? n : 1);
+        MatrixThreadPool::ParallelFor(0, m, grain, [=](size_t i0, size_t i1)
+                                      {
+                                          for (size_t i = i0; i < i1; ++i)
+                                          {
+                                              const T *px = X + i * ldx;
+                                              const T *py = Y + i * ldy;
+                                              T *pz = Z + i * ldz;
+                                              if (s == T(1))
+                                                  for (size_t j = 0; j < n; ++j)
+                                                      pz[j] = px[j] + py[j];
+                                              else
+                                                  for (size_t j = 0; j < n; ++j)
+                                                      pz[j] = px[j] - py[j];
+                                          }
+                                      });
+    }
+
+    //元素类型是否转换为float计算
+    typedef std::integral_constant<bool, !std::is_same<typename MatrixScalar<T>::Accumulator, T>::value> Widened;
+
+    //rows×cols矩阵与连续存储的Accumulator数组之间的成批转换
+    template <typename S, typename D>
+    static void ConvertRows(size_t rows, size_t cols, const S *src, size_t lds, D *dst, size_t ldd)
+    {
+        if (lds == cols && ldd == cols)
+        {
+            ReducedPrecision::Convert(src, dst, rows * cols);
+            return;
+        }
+        size_t grain = cols >= (size_t(1) << 14) ? 1 : (size_t(1) << 14) / (cols > 0 ? cols : 1);
+        MatrixThreadPool::ParallelFor(0, rows, grain, [=](size_t i0, size_t i1)
+                                      {
+                                          for (size_t i = i0; i < i1; ++i)
+                                              ReducedPrecision::Convert(src + i * lds, dst + i * ldd, cols);
+                                      });
+    }
+
+    static bool GemmWiden(std::false_type, size_t, size_t, size_t, const T &, const T *, size_t,
+                          const T *, size_t, const T &, T *, size_t)
+    {
+        return false;
+    }
+
+    //16位浮点GEMM：A、B（β不为0时还有C）转换为float，以float GEMM计算后舍入写回C
+    static bool GemmWiden(std::true_type, size_t m, size_t n, size_t k, const T &alpha, const T *A, size_t lda,
+                          const T *B, size_t ldb, const T &beta, T *C, size_t ldc)
+    {
+        typedef typename MatrixScalar<T>::Accumulator F;
+        size_t sa = m * k, sb = k * n, sc = m * n;
+        MATRIX_PROFILE_EVENT(RecordAlloc((sa + sb + sc) * sizeof(F)));
+        std::vector<F> buffer(sa + sb + sc);
+        F *Af = buffer.data(), *Bf = Af + sa, *Cf = Bf + sb;
+        ConvertRows(m, k, A, lda, Af, k);
+        ConvertRows(k, n, B, ldb, Bf, n);
+        if (!(beta == T(0)))
+            ConvertRows(m, n, C, ldc, Cf, n);
+        MatrixKernel<F>::Gemm(m, n, k, F(alpha), Af, k, Bf, n, F(beta), Cf, n);
+        ConvertRows(m, n, Cf, n, C, ldc);
+        return true;
+    }
+
+    static bool GemvWiden(std::false_type, bool, size_t, size_t, const T &, const T *, size_t,
+                          const T *, size_t, const T &, T *, size_t, size_t)
+    {
+        return false;
+    }
+
+    //16位浮点GEMV：x与y以float保存，A的行直接以16位读取
+    static bool GemvWiden(std::true_type, bool transpose, size_t m, size_t n, const T &alpha, const T *A, size_t lda,
+                          const T *x, size_t incx, const T &beta, T *y, size_t incy, size_t grain)
+    {
+        typedef typename MatrixScalar<T>::Accumulator F;
+        size_t xSize = transpose ? m : n, ySize = transpose ? n : m;
+        std::vector<F> xf(xSize), yf(ySize, F(0));
+        ConvertRows(xSize, 1, x, incx, xf.data(), 1);
+        F fa = F(alpha);
+        const F *px = xf.data();
+        F *py = yf.data();
+
+        if (!transpose)
+            MatrixThreadPool::ParallelFor(0, m, grain, [=](size_t b, size_t e)
+                                          { ReducedPrecision::DotRows(A + b * lda, lda, e - b, n, px, py + b); });
+        else
+            MatrixThreadPool::ParallelFor(0, n, grain, [=](size_t b, size_t e)
+                                          {
+                                              //按列分段，y的每段留在缓存中
+                                              for (size_t j0 = b; j0 < e; j0 += uWidenBlock)
+                                              {
+                                                  size_t len = e - j0 < uWidenBlock ? e - j0 : uWidenBlock;
+                                                  for (size_t i = 0; i < m; ++i)
+                                                      if (!(px[i] == F(0)))
+                                                          ReducedPrecision::AxpyRow(A + i * lda + j0, len, px[i], py + j0);
+                                              }
+                                          });
+
+        //y = α·(Ax) + βy
+        MatrixThreadPool::ParallelFor(0, ySize, uParallelVectorSize, [=](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                          {
+                                              F v = fa * py[i];
+                                              if (!(beta == T(0)))
+                                                  v += F(beta) * F(y[i * incy]);
+                                              y[i * incy] = T(v);
+                                          }
+                                      });
+        return true;
+    }
+
+    //实数元素不拆分
+    static bool GemmSplit(std::false_type, size_t, size_t, size_t, const T &, const T *, size_t,
+                          const T *, size_t, const T &, T *, size_t)
+    {
+        return false;
+    }
+
+    //复数GEMM：拆分为实部与虚部平面后做4次实数GEMM，规模过小时返回false
+    static bool GemmSplit(std::true_type, size_t m, size_t n, size_t k, const T &alpha, const T *A, size_t lda,
+                          const T *B, size_t ldb, const T &beta, T *C, size_t ldc)
+    {
+        typedef typename MatrixScalar<T>::Real R;
+        if (k == 0 || m * n * k < (size_t(1) << 12))
+            return false;
+
+        size_t sa = m * k, sb = k * n, sc = m * n;
+        MATRIX_PROFILE_EVENT(RecordAlloc(2 * (sa + sb + sc) * sizeof(R)));
+        std::vector<R> planes(2 * (sa + sb + sc));
+        R *Ar = planes.data(), *Ai = Ar + sa, *Br = Ai + sa, *Bi = Br + sb, *Pr = Bi + sb, *Pi = Pr + sc;
+        SplitPlanes(m, k, A, lda, Ar, Ai);
+        SplitPlanes(k, n, B, ldb, Br, Bi);
+
+        MatrixKernel<R>::Gemm(m, n, k, R(1), Ar, k, Br, n, R(0), Pr, n);
+        MatrixKernel<R>::Gemm(m, n, k, R(-1), Ai, k, Bi, n, R(1), Pr, n);
+        MatrixKernel<R>::Gemm(m, n, k, R(1), Ar, k, Bi, n, R(0), Pi, n);
+        MatrixKernel<R>::Gemm(m, n, k, R(1), Ai, k, Br, n, R(1), Pi, n);
+
+        //C = αP + βC
+        MatrixThreadPool::ParallelFor(0, m, 64, [=](size_t i0, size_t i1)
+                                      {
+                                          for (size_t i = i0; i < i1; ++i)
+                                          {
+                                              T *pc = C + i * ldc;
+                                              const R *pr = Pr + i * n, *pi = Pi + i * n;
+                                              for (size_t j = 0; j < n; ++j)
+                                                  pc[j] = alpha * T(pr[j], pi[j]) + (beta == T(0) ? T(0) : beta * pc[j]);
+                                          }
+                                      });
+        return true;
+    }
+
+    //把rows×cols复数矩阵拆分为连续的实部与虚部平面，按行并行
+    template <typename R>
+    static void SplitPlanes(size_t rows, size_t cols, const T *X, size_t ldx, R *re, R *im)
+    {
+        size_t grain = cols >= (size_t(1) << 14) ? 1 : (size_t(1) << 14) / (cols > 0 ? cols : 1);
+        MatrixThreadPool::ParallelFor(0, rows, grain, [=](size_t i0, size_t i1)
+                                      {
+                                          for (size_t i = i0; i < i1; ++i)
+                                          {
+                                              const T *px = X + i * ldx;
+                                              R *MATRIX_RESTRICT pr = re + i * cols;
+                                              R *MATRIX_RESTRICT pi = im + i * cols;
+                                              for (size_t j = 0; j < cols; ++j)
+                                              {
+                                                  pr[j] = px[j].real();
+                                                  pi[j] = px[j].imag();
+                                              }
+                                          }
+                                      });
+    }
+
+    //计算C的第[i0, i1)行
+    static void GemmRows(size_t i0, size_t i1, size_t n, size_t k, const T &alpha, const T *A, size_t lda,
+                         const T *B, size_t ldb, const T &beta, T *C, size_t ldc)
+    {
+        for (size_t i = i0; i < i1; ++i)
+        {
+            T *pc = C + i * ldc;
+            if (beta == T(0))
+                std::fill(pc, pc + n, T(0));
+            else if (beta != T(1))
+                for (size_t j = 0; j < n; ++j)
+                    pc[j] *= beta;
+        }
+
+        for (size_t kk = 0; kk < k; kk += uGemmKBlock)
+        {
+            size_t kEnd = kk + uGemmKBlock < k ? kk + uGemmKBlock : k;
+            for (size_t jj = 0; jj < n; jj += uGemmNBlock)
+            {
+                size_t jLen = jj + uGemmNBlock < n ? uGemmNBlock : n - jj;
+                size_t i = i0;
+                for (; i + 4 <= i1; i += 4)
+                {
+                    T *MATRIX_RESTRICT c0 = C + i * ldc + jj;
+                    T *MATRIX_RESTRICT c1 = c0 + ldc;
+                    T *MATRIX_RESTRICT c2 = c1 + ldc;
+                    T *MATRIX_RESTRICT c3 = c2 + ldc;
+                    for (size_t p = kk; p < kEnd; ++p)
+                    {
+                        const T *MATRIX_RESTRICT b = B + p * ldb + jj;
+                        T a0 = alpha * A[i * lda + p];
+                        T a1 = alpha * A[(i + 1) * lda + p];
+                        T a2 = alpha * A[(i + 2) * lda + p];
+                        T a3 = alpha * A[(i + 3) * lda + p];
+                        for (size_t j = 0; j < jLen; ++j)
+                        {
+                            T bj = b[j];
+                            c0[j] += a0 * bj;
+                            c1[j] += a1 * bj;
+                            c2[j] += a2 * bj;
+                            c3[j] += a3 * bj;
+                        }
+                    }
+                }
+                for (; i < i1; ++i)
+                {
+                    T *MATRIX_RESTRICT c0 = C + i * ldc + jj;
+                    for (size_t p = kk; p < kEnd; ++p)
+                    {
+                        const T *MATRIX_RESTRICT b = B + p * ldb + jj;
+                        T a0 = alpha * A[i * lda + p];
+                        for (size_t j = 0; j < jLen; ++j)
+                            c0[j] += a0 * b[j];
+                    }
+                }
+            }
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////
+//                               计数器随机数发生器
+//
+//     Philox4x32-10（Salmon等，SC'11）把(计数器, 密钥)映射为4个32位随机数，无内部状态。
+// 矩阵第i个元素只由种子和i决定，因此多个线程可以各自填充不相交的区间，且同一种子
+// 的结果与线程数无关。
+///////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 计数器随机数发生器
+ *
+ * 提供Philox4x32-10分组函数与全局种子序列。未调用 Seed() 时种子序列以时钟初始化；
+ * 调用 Seed() 后，此后每次不指定种子的随机填充依次取得确定的种子，整个运行过程可复现。
+ */
+class MatrixRandom
+{
+public:
+    /**
+     * @brief Philox4x32-10 分组函数
+     *
+     * @param key     64位密钥（种子）
+     * @param counter 64位计数器
+     * @param out     输出的4个32位随机数
+     */
+    static void Philox(uint64_t key, uint64_t counter, uint32_t out[4])
+    {
+        uint32_t c0 = uint32_t(counter), c1 = uint32_t(counter >> 32), c2 = 0, c3 = 0;
+        uint32_t k0 = uint32_t(key), k1 = uint32_t(key >> 32);
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+            uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+            c1 = uint32_t(p1);
+            c3 = uint32_t(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    /**
+     * @brief 由两个32位随机数生成[0, 1)上均匀分布的double，精度53位
+     */
+    static double ToUniform(uint32_t hi, uint32_t lo)
+    {
+        return double(((uint64_t(hi) << 32) | lo) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief 设置全局种子，此后不指定种子的随机填充结果可复现
+     *
+     * @param seed 种子
+     */
+    static void Seed(uint64_t seed)
+    {
+        State &s = GetState();
+        std::lock_guard<std::mutex> lock(s.mtx);
+        s.base = seed;
+        s.next = 0;
+    }
+
+    /**
+     * @brief 从全局种子序列中取得下一个种子
+     *
+     * @return uint64_t 种子
+     */
+    static uint64_t NextSeed()
+    {
+        State &s = GetState();
+        std::lock_guard<std::mutex> lock(s.mtx);
+        //SplitMix64，保证相邻序号的种子互不相关
+        uint64_t z = s.base + 0x9E3779B97F4A7C15ull * ++s.next;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    struct State
+    {
+        std::mutex mtx;
+        uint64_t base = uint64_t(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        uint64_t next = 0;
+    };
+
+    static State &GetState()
+    {
+        static State state;
+        return state;
+    }
+};
+
+/**
+ * @brief 向量视图
+ *
+ * 不拥有数据的跨步向量，可以引用 Vector<T> 的数据或矩阵的一行、一列，
+ * 通过视图修改元素会直接修改被引用的数据。视图的生命周期不得超过被引用的对象。
+ * VectorView<const T> 为只读视图，VectorView<T> 可隐式转换为只读视图。
+ *
+ * 元素下标从0开始。
+ *
+ * @tparam T 元素类型，可为const限定
+ */
+template <typename T>
+class VectorView
+{
+private:
+    T *pData;       //首元素指针
+    size_t uSize;   //元素个数
+    size_t uStride; //相邻元素的间距
+
+public:
+    /**
+     * @brief 向量视图构造函数
+     *
+     * @param data   首元素指针
+     * @param size   元素个数
+     * @param stride 相邻元素的间距
+     */
+    VectorView(T *data, size_t size, size_t stride = 1) : pData(data), uSize(size), uStride(stride) {}
+
+    /**
+     * @brief 从可写视图构造只读视图
+     *
+     * @param view 元素类型可以转换为T的视图
+     */
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U *, T *>::value>::type>
+    VectorView(const VectorView<U> &view) : pData(view.Data()), uSize(view.Size()), uStride(view.Stride())
+    {
+    }
+
+    //元素个数
+    size_t Size() const
+    {
+        return uSize;
+    }
+
+    //相邻元素的间距
+    size_t Stride() const
+    {
+        return uStride;
+    }
+
+    //首元素指针
+    T *Data() const
+    {
+        return pData;
+    }
+
+    /**
+     * @brief 元素访问，下标从0开始
+     *
+     * @param i 下标
+     * @return T& 元素的引用
+     */
+    T &operator[](size_t i) const
+    {
+        assert(i < uSize);
+        return pData[i * uStride];
+    }
+};
+
+/**
+    @brief 矩阵类
+    
+    矩阵基类，提供基础的矩阵运算与输入输出功能
+
+    @tparam T	                矩阵数据类型
+    @tparam _CapacityIncrement	矩阵扩增系数
+*/
+template <typename T, size_t _CapacityIncrement>
+class Matrix
+{
+    //声明
+    friend Determinant<T>;
+    template <typename U, size_t _Inc>
+    friend class Matrix;
+
+protected:
+    size_t uRow; //行数
+    size_t uCol; //列数
+
+    T *pData = nullptr; //矩阵数据
+    size_t uCapacity;   //数据容量
+    MatrixMemory::Policy memPolicy = MatrixMemory::DefaultPolicy(); //数据的内存放置策略
+#ifdef MATRIX_COPY_ON_WRITE
+    //共享数据的引用计数，数据从未被共享时为空。拷贝源为常量对象，故声明为mutable
+    mutable std::atomic<std::atomic<size_t> *> pRefCount{nullptr};
+#endif
+private:
+    static const size_t uCapacityIncrement = _CapacityIncrement > 1 ? _CapacityIncrement : 2; //容量倍增系数
+    static const size_t uParallelGrain = 16384; //PARALLEL 策略下逐元素运算的分段大小
+    static const size_t uReductionSegment = 32768; //归约并行时的分段大小
+
+public:
+    typedef typename MatrixScalar<T>::Real Real; //元素对应的实数类型，复数元素的范数等以此表示
+
+    enum Direction
+    {
+        LEFT,
+        RIGHT,
+        ABOVE,
+        BELOW,
+        TOPLEFT,
+        TOPRIGHT,
+        BOTLEFT,
+        BOTRIGHT,
+    };
+
+    //矩阵乘法算法
+    enum MultiplyMode
+    {
+        CLASSICAL, //分块GEMM，O(n³)
+        STRASSEN,  //Strassen-Winograd，O(n^2.81)，误差界较大
+    };
+
+    //逐元素运算的执行策略
+    enum ExecutionPolicy
+    {
+        SEQUENTIAL, //在调用线程中顺序执行
+        PARALLEL,   //按固定大小分段，由线程池并行执行
+    };
+
+public:
+    //构造函数
+
+    /**
+     * @brief   无参构造函数
+     * 
+     * 构造0行0列无数据的空矩阵
+     */
+    Matrix() : Matrix(0, 0)
+    {
+    }
+
+    /**
+        @brief 无数据构造函数：
+
+        构造一个row × col大小的矩阵
+        @param row 矩阵的行数
+        @param col 矩阵的列数
+    */
+    Matrix(size_t row, size_t col) : uRow(row), uCol(col)
+    {
+        uCapacity = uCapacityIncrement * row * col;
+        pData = AllocData(uCapacity, row, col);
+    }
+
+    /**
+        @brief 矩阵构造函数：指定所有元素为某值
+
+        构造一个row × col大小的，元素全为同一值的矩阵
+        @param row 矩阵的行数
+        @param col 矩阵的列数
+    */
+    Matrix(size_t row, size_t col, const T &value) : uRow(row), uCol(col)
+    {
+        uCapacity = uCapacityIncrement * row * col;
+        pData = AllocData(uCapacity, row, col);
+        for (size_t i = 0; i < row * col; ++i)
+            pData[i] = value;
+    }
+
+    /**
+        @brief 矩阵构造函数：数组指针
+
+        构造一个row × col大小的矩阵，复制线性数组data的数据
+        @param row	矩阵的行数
+        @param col	矩阵的列数
+        @param data	矩阵数据
+        @param dataLen  数组元素个数
+    */
+    Matrix(size_t row, size_t col, const T *data, size_t dataLen) : Matrix(row, col)
+    {
+        size_t elemCount = row * col;
+        std::copy_n(data, dataLen > elemCount ? elemCount : dataLen, pData);
+    }
+
+    /**
+     * @brief 矩阵构造函数：从字符串
+     * 
+     * 使用类似于MATLAB中使用的矩阵定义字符串创建矩阵对象.
+     * 例如："[ 1 2, 5; 2.5 0 -1.3e2; 3, 2 6 ]"将转换为矩阵
+     * 
+     * 1    2   5
+     * 2.5  0   -1.3e2
+     * 3    2   6
+     * 
+     * 按行指定，每个元素间用分隔符' '或','且多余的空白（包括制表符与换行）自动忽略，
+     * 因此流输出的结果也可以作为输入，但流输出只保留4位有效数字。
+     * 该函数将检查表达式是否合法，第一行元素个数决定矩阵有多少列，
+     * 若后续行中缺项，将报错。
+     * 
+     * @param expr 类MATLAB的矩阵定义字符串
+     */
+    explicit Matrix(const std::string &expr)
+    {
+        //空白字符
+        static const char *blanks = " \t\n\r\f\v";
+        auto isBlank = [](char c)
+        {
+            return c != '\0' && strchr(blanks, c) != nullptr;
+        };
+
+        //错误标识打印
+        auto flagPrint = [](const std::string &str, size_t flagPos)
+        {
+            std::cout << '\n'
+                      << str << '\n';
+            for (size_t i = 0; i < flagPos; ++i)
+                std::cout << ' ';
+            std::cout << "^\n";
+        };
+
+        //转换矩阵行：传入rowStr需保证没有'[', ';', ']'
+        auto parseRow = [&](const std::string &rowStr, int &errIdx)
+        {
+            std::string str = ' ' + rowStr + ' ';
+
+            std::vector<T> values;
+            size_t numStartIdx = 0;
+            bool inNumber = false;
+
+            for (size_t i = 0; i < str.size(); ++i)
+            {
+                if (!isBlank(str[i]) && str[i] != ',' && !inNumber)
+                {
+                    numStartIdx = i;
+                    inNumber = true;
+                }
+                if (inNumber && (isBlank(str[i]) || str[i] == ','))
+                {
+                    inNumber = false;
+                    T num = T(0);
+                    if (!MatrixScalar<T>::Parse(str.substr(numStartIdx, i - numStartIdx), num))
+                    {
+                        errIdx = numStartIdx;
+                        return std::vector<T>();
+                    }
+                    values.push_back(num);
+                }
+            }
+
+            errIdx = -1;
+            return values;
+        };
+
+        //开始转换矩阵字符串
+
+        size_t lbraIdx = expr.find('[');
+        //保证开始符‘[’前不存在除空白以外的符号
+        for (size_t i = 0; i < lbraIdx; ++i)
+        {
+            if (!isBlank(expr[i]))
+            {
+                std::cout << "Error parsing matrix expression (unrecognized character before '['):\n";
+                flagPrint(expr, i);
+                assert(0);
+            }
+        }
+
+        size_t rbraIdx = expr.find(']');
+        //保证结束符']'后不存在除空白以外的符号
+        for (size_t i = rbraIdx + 1; i < expr.size(); ++i)
+        {
+            if (!isBlank(expr[i]))
+            {
+                std::cout << "Error parsing matrix expression (unrecognized character after ']'):\n";
+                flagPrint(expr, i);
+                assert(0);
+            }
+        }
+
+        ////////////逐行字符检查
+
+        std::vector<std::vector<T>> dataVec;
+
+        //检查第一行
+        size_t rowDelimIdx = expr.find(';');
+        if (rowDelimIdx == std::string::npos)
+            rowDelimIdx = rbraIdx;
+
+        int errIdx = -1;
+        dataVec.push_back(parseRow(expr.substr(lbraIdx + 1, rowDelimIdx - lbraIdx - 1), errIdx));
+        if (errIdx != -1)
+        {
+            std::cout << "Error parsing matrix expression (unable to parse row element):\n";
+            flagPrint(expr, errIdx + lbraIdx);
+            assert(0);
+        }
+
+        uCol = dataVec.front().size();
+
+        //检查接下来的行，只有一行时没有后续行
+
+        bool onEnd = rowDelimIdx == rbraIdx;
+
+        while (!onEnd)
+        {
+            size_t rowNextDelimIdx = expr.find(';', rowDelimIdx + 1);
+            if (rowNextDelimIdx == std::string::npos)
+            {
+                rowNextDelimIdx = rbraIdx;
+                onEnd = true;
+                //允许最后一行以';'结尾（与流输出的格式相同）
+                if (expr.find_first_not_of(blanks, rowDelimIdx + 1) == rbraIdx)
+                    break;
+            }
+
+            dataVec.push_back(parseRow(expr.substr(rowDelimIdx + 1, rowNextDelimIdx - rowDelimIdx - 1), errIdx));
+            if (errIdx != -1)
+            {
+                std::cout << "Error parsing matrix expression (unable to parse row element):\n";
+                flagPrint(expr, errIdx + rowDelimIdx);
+                assert(0);
+            }
+
+            //保证列数相同
+            if (dataVec.back().size() != uCol)
+            {
+                std::cout << "Error parsing matrix expression (matrix rows must have consistent number of elements):\n";
+                flagPrint(expr, rowNextDelimIdx);
+                assert(0);
+            }
+
+            rowDelimIdx = rowNextDelimIdx;
+        }
+
+        //确定行数，输入数据
+        uRow = dataVec.size();
+        uCapacity = uCol * uRow;
+        pData = AllocData(uCapacity, uRow, uCol);
+        for (size_t i = 0; i < dataVec.size(); ++i)
+            std::copy_n(dataVec[i].data(), uCol, pData + i * uCol);
+    }
+
+    /**
+     * @brief 矩阵构造函数：从初始化列表
+     * 
+     * 使用嵌套的初始化列表构造矩阵
+     * 格式如 { {2, 5, 9}, {1.0, 22, 6}, {0, 98, 6}, ...}
+     * 每个内列表指定行元素，第一个内列表的元素个数指定矩阵列数
+     * 若后续内列表缺项，将报错。
+     * 
+     * @param iList 嵌套的初始化列表
+     */
+    explicit Matrix(std::initializer_list<std::initializer_list<T>> iList)
+    {
+        uCol = (*iList.begin()).size();
+        uRow = iList.size();
+        uCapacity = uCol * uRow;
+        pData = AllocData(uCapacity, uRow, uCol);
+
+        for (size_t i = 0; i < uRow; ++i)
+        {
+            auto &inner = iList.begin()[i];
+            assert(uCol == inner.size());
+            std::copy_n(inner.begin(), uCol, pData + i * uCol);
+        }
+    }
+
+    /**
+     * @brief  矩阵构造函数：从变长数组
+     * 
+     * @param row 行数
+     * @param col 列数
+     * @param vec 数据
+     */
+    Matrix(size_t row, size_t col, const std::vector<T> &vec) : Matrix(row, col, vec.data(), vec.size()) {}
+
+    /**
+        @brief  拷贝构造函数：
+
+        使用现有矩阵复制构造。定义了 MATRIX_COPY_ON_WRITE 时只共享数据，
+        不分配内存，复制推迟到某一方第一次修改数据时
+        @param mat 矩阵对象的引用
+    */
+#ifdef MATRIX_COPY_ON_WRITE
+    Matrix(const Matrix &mat)
+    {
+        Share(mat);
+    }
+#else
+    Matrix(const Matrix &mat) : Matrix(mat.uRow, mat.uCol, mat.pData, mat.uRow * mat.uCol)
+    {
+        MATRIX_PROFILE_EVENT(RecordCopyConstruct());
+    }
+#endif
+
+    /**
+        @brief  类型转换构造函数：
+
+        将其它元素类型的矩阵逐元素转换为T类型，要求U可以static_cast到T。
+        Half、BFloat16与float之间的转换成批进行，见 ReducedPrecision::Convert()
+        @param mat 其它元素类型的矩阵
+    */
+    template <typename U, size_t _Inc>
+    explicit Matrix(const Matrix<U, _Inc> &mat) : Matrix(mat.uRow, mat.uCol)
+    {
+        MATRIX_PROFILE_SCOPE("Convert");
+        ReducedPrecision::Convert(mat.pData, pData, uRow * uCol);
+    }
+
+    /**
+        @brief  移动拷贝构造函数：
+        右值引用构造
+        @param mat 矩阵对象的右值引用，其数据指针会被置空，行列数置0
+    */
+    Matrix(Matrix<T> &&mat) noexcept : uRow(mat.uRow), uCol(mat.uCol), pData(mat.pData), uCapacity(mat.uCapacity), memPolicy(mat.memPolicy)
+    {
+        MATRIX_PROFILE_EVENT(RecordMoveConstruct());
+#ifdef MATRIX_COPY_ON_WRITE
+        pRefCount.store(mat.pRefCount.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+        mat.pData = nullptr;
+        mat.uRow = mat.uCol = mat.uCapacity = 0;
+    }
+
+    /**
+        @brief  赋值运算符函数
+
+        @param mat 矩阵对象的引用
+        @return 返回被赋值对象的引用
+    */
+    Matrix<T> &operator=(const Matrix<T> &mat)
+    {
+        if (this == &mat)
+            return *this;
+#ifdef MATRIX_COPY_ON_WRITE
+        //已与mat共享同一份数据时，释放后引用计数仍大于0
+        ReleaseData();
+        Share(mat);
+#else
+        MATRIX_PROFILE_EVENT(RecordCopyAssign());
+        //容量足够时复用现有内存，否则释放后重新分配
+        Reshape(mat.uRow, mat.uCol);
+        std::copy_n(mat.pData, mat.uRow * mat.uCol, this->pData);
+#endif
+        return *this;
+    }
+
+    /**
+        @brief  移动赋值运算符函数：
+
+        使用右值移动赋值
+        @param mat 矩阵对象的右值引用，其数据指针会被置空，行列数置0
+        @return 被赋值对象的引用
+    */
+    Matrix<T> &operator=(Matrix<T> &&mat) noexcept
+    {
+        if (&mat == this)
+            return *this;
+        MATRIX_PROFILE_EVENT(RecordMoveAssign());
+        ReleaseData();
+#ifdef MATRIX_COPY_ON_WRITE
+        pRefCount.store(mat.pRefCount.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+        this->uRow = mat.uRow;
+        this->uCol = mat.uCol;
+        this->uCapacity = mat.uCapacity;
+        this->pData = mat.pData;
+        this->memPolicy = mat.memPolicy;
+        mat.pData = nullptr;
+        mat.uRow = mat.uCol = mat.uCapacity = 0;
+        return *this;
+    }
+
+    //析构函数
+    virtual ~Matrix()
+    {
+        ReleaseData();
+    }
+
+public:
+    //矩阵输出
+    template <typename E>
+    friend std::ostream &operator<<(std::ostream &os, const Matrix<E> &mat);
+
+public:
+    /**
+        获取矩阵的数据
+
+        定义了 MATRIX_COPY_ON_WRITE 时，若数据被共享则先复制一份私有数据，
+        返回的指针在之后拷贝本矩阵前有效。只读访问请使用常量版本
+        @return 矩阵数据的头指针
+    */
+    inline T *Data()
+    {
+        Detach();
+        return this->pData;
+    }
+
+    /**
+        获取矩阵的只读数据
+        @return 矩阵数据的头指针
+    */
+    inline const T *Data() const
+    {
+        return this->pData;
+    }
+
+public:
+    /**
+        获取矩阵的行数
+        @return 矩阵的行数
+    */
+    size_t RowSize() const
+    {
+        return uRow;
+    }
+
+public:
+    /**
+        获取矩阵的列数
+        @return 矩阵的列数
+    */
+    size_t ColumnSize() const
+    {
+        return uCol;
+    }
+
+private:
+    /**
+     * @brief 分配矩阵数据内存，所有数据分配都经过本函数
+     *
+     * 按本矩阵的内存放置策略由相应的线程初始化，见 MatrixMemory。
+     * BLOCK_ROWS 策略与逐元素运算使用相同的 grain 划分行。
+     *
+     * @param count 元素个数
+     * @param rows  数据表示的矩阵行数
+     * @param cols  数据表示的矩阵列数
+     * @return T* 值初始化的数据指针
+     */
+    T *AllocData(size_t count, size_t rows, size_t cols) const
+    {
+        MATRIX_PROFILE_EVENT(RecordAlloc(count * sizeof(T)));
+        T *p = MatrixMemory::Allocate<T>(count, rows, cols, memPolicy, uParallelGrain / (cols > 0 ? cols : 1) + 1);
+        assert(p);
+        return p;
+    }
+
+public:
+    /**
+     * @brief 设置本矩阵数据的内存放置策略，并按新策略重新放置现有数据
+     *
+     * 之后本矩阵重新分配数据（扩容、改变形状等）时也使用该策略；拷贝得到的矩阵
+     * 使用 MatrixMemory::DefaultPolicy()，移动时策略随数据转移。
+     *
+     * @param policy 放置策略
+     * @return Matrix<T>& 本对象的引用
+     */
+    Matrix<T> &SetMemoryPolicy(MatrixMemory::Policy policy)
+    {
+        MATRIX_PROFILE_SCOPE("SetMemoryPolicy");
+        memPolicy = policy;
+        T *pNewData = AllocData(uCapacity, uRow, uCol);
+        const T *pOld = pData;
+        size_t cols = uCol;
+        MatrixThreadPool::ParallelFor(0, uRow, uParallelGrain / (cols > 0 ? cols : 1) + 1, [=](size_t b, size_t e)
+                                      { std::copy(pOld + b * cols, pOld + e * cols, pNewData + b * cols); });
+        ReleaseData();
+        pData = pNewData;
+        return *this;
+    }
+
+    //本矩阵数据的内存放置策略
+    MatrixMemory::Policy MemoryPolicy() const
+    {
+        return memPolicy;
+    }
+
+private:
+    //数据扩增
+    void Expand()
+    {
+        T *pNewData = AllocData(uCapacityIncrement * uCapacity, uRow, uCol);
+        std::copy_n(pData, uCapacity, pNewData);
+        ReleaseData();
+        pData = pNewData;
+        uCapacity *= uCapacityIncrement;
+    }
+
+public:
+    /**
+     * @brief 共享本矩阵数据的矩阵个数
+     *
+     * 未定义 MATRIX_COPY_ON_WRITE 或数据未被共享时为1
+     *
+     * @return size_t 引用计数
+     */
+    size_t UseCount() const
+    {
+#ifdef MATRIX_COPY_ON_WRITE
+        std::atomic<size_t> *pCount = pRefCount.load(std::memory_order_acquire);
+        if (pCount != nullptr)
+            return pCount->load(std::memory_order_acquire);
+#endif
+        return 1;
+    }
+
+private:
+    //写时复制：数据被其它矩阵共享时先复制出私有的一份，所有修改数据的接口都先调用本函数
+    inline void Detach()
+    {
+#ifdef MATRIX_COPY_ON_WRITE
+        if (UseCount() > 1)
+        {
+            MATRIX_PROFILE_EVENT(RecordCopyConstruct());
+            T *pNewData = AllocData(uCapacity, uRow, uCol);
+            std::copy_n(pData, uRow * uCol, pNewData);
+            ReleaseData();
+            pData = pNewData;
+        }
+#endif
+    }
+
+private:
+    //释放数据：共享时只减少引用计数，由最后一个持有者释放
+    void ReleaseData()
+    {
+#ifdef MATRIX_COPY_ON_WRITE
+        std::atomic<size_t> *pCount = pRefCount.exchange(nullptr, std::memory_order_relaxed);
+        if (pCount != nullptr)
+        {
+            if (pCount->fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                pData = nullptr;
+                return;
+            }
+            delete pCount;
+        }
+#endif
+        delete[] pData;
+        pData = nullptr;
+    }
+
+#ifdef MATRIX_COPY_ON_WRITE
+private:
+    //与mat共享数据，本对象不得持有数据。mat的引用计数在第一次被拷贝时创建
+    void Share(const Matrix &mat)
+    {
+        uRow = mat.uRow;
+        uCol = mat.uCol;
+        uCapacity = mat.uCapacity;
+        memPolicy = mat.memPolicy;
+        pData = mat.pData;
+        if (pData == nullptr)
+            return;
+        std::atomic<size_t> *pCount = mat.pRefCount.load(std::memory_order_acquire);
+        if (pCount == nullptr)
+        {
+            std::atomic<size_t> *pNewCount = new std::atomic<size_t>(1);
+            if (mat.pRefCount.compare_exchange_strong(pCount, pNewCount, std::memory_order_acq_rel))
+                pCount = pNewCount;
+            else
+                delete pNewCount;
+        }
+        pCount->fetch_add(1, std::memory_order_relaxed);
+        pRefCount.store(pCount, std::memory_order_relaxed);
+    }
+#endif
+
+protected:
+    /**
+     * @brief 访问矩阵元素，下标从1开始。
+     * 
+     * @param row 行号，从1开始
+     * @param col 列号，从1开始
+     * @return const T& 元素的常引用
+     */
+    inline const T &ElementAt(size_t row, size_t col) const
+    {
+        return pData[(row - 1) * uCol + col - 1];
+    }
+
+public:
+#ifdef MATRIX_INDEX_START_AT_0
+    /**
+     * @brief 获取矩阵元素的引用，下标从0开始。
+     * 
+     * 因为已经定义 MATRIX_INDEX_START_AT_0 ,本函数启用。若要
+     * 使该函数下标从1开始，请勿定义 MATRIX_INDEX_START_AT_0
+     * 
+     * @param row 行号，从0开始
+     * @param col 列号，从0开始
+     * @return T& 元素的引用
+     */
+    inline T &operator()(size_t row, size_t col)
+    {
+        assert(row < uRow && col < uCol);
+        Detach();
+        return pData[row * uCol + col];
+    }
+#else
+    /**
+     * @brief 获取矩阵元素的引用，行列序号从1开始。
+     * 
+     * 因为未定义 MATRIX_INDEX_START_AT_0 ,本函数启用。若要
+     * 使该函数行列序号从0开始，请在包含本头文件前定义 MATRIX_INDEX_START_AT_0
+     * 
+     * @param row 行号，从1开始
+     * @param col 列号，从1开始
+     * @return T& 元素的引用
+     */
+    inline T &operator()(size_t row, size_t col)
+    {
+        assert(row > 0 && col > 0 && row <= uRow && col <= uCol);
+        Detach();
+        return pData[(row - 1) * uCol + col - 1];
+    }
+#endif
+
+public:
+    /**
+        @brief 元素访问与修改，行列序号从1开始
+
+        该函数的行列序号始终从1开始，无论 MATRIX_INDEX_START_AT_0
+        是否被定义
+
+        @param row 元素所在的行数，从1开始
+        @param col 元素所在的列数，从1开始
+        @return 矩阵元素的引用
+    */
+    inline T &ElemAt(size_t row, size_t col)
+    {
+        assert(row > 0 && col > 0 && row <= uRow && col <= uCol);
+        Detach();
+        return pData[(row - 1) * uCol + col - 1];
+    }
+
+public:
+    /**
+        @brief 元素访问与修改，行列序号从1开始
+
+        该函数的行列序号始终从1开始，无论 MATRIX_INDEX_START_AT_0
+        是否被定义
+
+        @param row 元素所在的行数，从1开始
+        @param col 元素所在的列数，从1开始
+        @return 矩阵元素的引用
+    */
+    inline const T &ElemAt(size_t row, size_t col) const
+    {
+        assert(row > 0 && col > 0 && row <= uRow && col <= uCol);
+        return pData[(row - 1) * uCol + col - 1];
+    }
+
+public:
+    /**
+        @brief 元素访问与修改，行列序号从0开始
+
+        该函数的行列序号始终从0开始，无论 MATRIX_INDEX_START_AT_0
+        是否被定义
+
+        @param row 元素所在的行数，从0开始
+        @param col 元素所在的列数，从0开始
+        @return 矩阵元素的引用
+    */
+    inline T &ElemAt0(size_t row, size_t col)
+    {
+        assert(row < uRow && col < uCol);
+        Detach();
+        return pData[row * uCol + col];
+    }
+
+public:
+    /**
+        @brief 元素访问与修改，行列序号从0开始
+
+        该函数的行列序号始终从0开始，无论 MATRIX_INDEX_START_AT_0
+        是否被定义
+
+        @param row 元素所在的行数，从0开始
+        @param col 元素所在的列数，从0开始
+        @return 矩阵元素的引用
+    */
+    inline const T &ElemAt0(size_t row, size_t col) const
+    {
+        assert(row < uRow && col < uCol);
+        return pData[row * uCol + col];
+    }
+
+public:
+    /**
+        @brief 获取矩阵一行的视图
+
+        行号起始与 operator()() 一致，由 MATRIX_INDEX_START_AT_0 决定。
+        视图直接引用矩阵数据，矩阵改变形状或被销毁后视图失效
+
+        @param row 行号
+        @return 连续的行向量视图
+    */
+    VectorView<T> Row(size_t row)
+    {
+        size_t r = ToZeroBasedIndex(row);
+        assert(r < uRow);
+        Detach();
+        return VectorView<T>(pData + r * uCol, uCol, 1);
+    }
+
+public:
+    /**
+        @brief 获取矩阵一行的只读视图
+
+        @param row 行号，起始同 operator()()
+        @return 连续的只读行向量视图
+    */
+    VectorView<const T> Row(size_t row) const
+    {
+        size_t r = ToZeroBasedIndex(row);
+        assert(r < uRow);
+        return VectorView<const T>(pData + r * uCol, uCol, 1);
+    }
+
+public:
+    /**
+        @brief 获取矩阵一列的视图
+
+        列号起始与 operator()() 一致，由 MATRIX_INDEX_START_AT_0 决定。
+        列视图的元素间距为矩阵的列数
+
+        @param col 列号
+        @return 跨步的列向量视图
+    */
+    VectorView<T> Column(size_t col)
+    {
+        size_t c = ToZeroBasedIndex(col);
+        assert(c < uCol);
+        Detach();
+        return VectorView<T>(pData + c, uRow, uCol);
+    }
+
+public:
+    /**
+        @brief 获取矩阵一列的只读视图
+
+        @param col 列号，起始同 operator()()
+        @return 跨步的只读列向量视图
+    */
+    VectorView<const T> Column(size_t col) const
+    {
+        size_t c = ToZeroBasedIndex(col);
+        assert(c < uCol);
+        return VectorView<const T>(pData + c, uRow, uCol);
+    }
+
+private:
+    //将 operator()() 约定的序号转换为从0开始的下标
+    static size_t ToZeroBasedIndex(size_t index)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        return index;
+#else
+        assert(index > 0);
+        return index - 1;
+#endif
+    }
+
+private:
+    /**
+     * @brief 求元素在线性数组中的下标
+     * 
+     * @param row 行号，从1开始
+     * @param col 列号，从1开始
+     * @return size_t 元素在数据中的下标
+     */
+    inline size_t IndexAt(size_t row, size_t col) const
+    {
+        return (row - 1) * uCol + col - 1;
+    }
+
+public:
+    /**
+     * @brief 遍历矩阵元素
+     * 
+     * 只接受函数指针，返回false时停止遍历。无需中途退出时请使用 Apply()
+     * 
+     * @param pOps 对每个元素执行的操作
+     * @return Matrix<T>& 本对象的引用
+     */
+    Matrix<T> &ForEach(bool (*pOps)(T &))
+    {
+        Detach();
+        auto ps = pData - 1;
+        auto pe = pData + uCol * uRow;
+        while (ps != pe)
+            if (!pOps(*(++ps)))
+                break;
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 遍历矩阵元素
+     * 
+     * @param pOps 对每个元素执行的操作(函数指针)
+     * @return Matrix<T>& 本对象的引用
+     */
+    Matrix<T> &ForEach(bool (*pOps)(T &, size_t))
+    {
+        Detach();
+        auto ps = pData - 1;
+        auto pe = pData + uCol * uRow;
+#ifdef MATRIX_INDEX_START_AT_0
+        size_t idx = -1;
+#else
+        size_t idx = 0;
+#endif
+        while (ps != pe)
+            if (!pOps(*(++ps), ++idx))
+                break;
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 对每个元素原地执行操作 f(elem)
+     *
+     * f可以是任意可调用对象（包括捕获变量的lambda），调用可被内联与向量化。
+     * 与 ForEach() 不同，不支持中途退出。PARALLEL 策略下f会被多个线程同时调用，
+     * 各元素的操作必须相互独立。
+     *
+     * @param f         对元素执行的操作 void f(T &)
+     * @param policy    执行策略
+     * @return Matrix<T>& 本对象的引用
+     */
+    template <typename F>
+    Matrix<T> &Apply(F f, ExecutionPolicy policy = SEQUENTIAL)
+    {
+        MATRIX_PROFILE_SCOPE("Apply");
+        Detach();
+        T *data = pData;
+        ForEachRange(policy, [&](size_t b, size_t e)
+                     {
+                         T *MATRIX_RESTRICT p = data;
+                         for (size_t i = b; i < e; ++i)
+                             f(p[i]);
+                     });
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 逐元素变换，返回新矩阵 r(i, j) = f(this(i, j))
+     *
+     * 结果的元素类型为f的返回值类型。
+     *
+     * @param f         变换函数 U f(const T &)
+     * @param policy    执行策略
+     * @return 变换后的矩阵
+     */
+    template <typename F, typename U = typename std::decay<decltype(std::declval<F &>()(std::declval<const T &>()))>::type>
+    Matrix<U> Map(F f, ExecutionPolicy policy = SEQUENTIAL) const
+    {
+        MATRIX_PROFILE_SCOPE("Map");
+        Matrix<U> r(uRow, uCol);
+        const T *src = pData;
+        U *dst = r.pData;
+        ForEachRange(policy, [&](size_t b, size_t e)
+                     {
+                         const T *MATRIX_RESTRICT ps = src;
+                         U *MATRIX_RESTRICT pd = dst;
+                         for (size_t i = b; i < e; ++i)
+                             pd[i] = f(ps[i]);
+                     });
+        return r;
+    }
+
+public:
+    /**
+     * @brief 两个同型矩阵逐元素组合，返回新矩阵 r(i, j) = f(this(i, j), other(i, j))
+     *
+     * @param other     同型矩阵，元素类型可以不同
+     * @param f         组合函数 R f(const T &, const U &)
+     * @param policy    执行策略
+     * @return 组合后的矩阵
+     */
+    template <typename U, size_t _Inc, typename F,
+              typename R = typename std::decay<decltype(std::declval<F &>()(std::declval<const T &>(), std::declval<const U &>()))>::type>
+    Matrix<R> Zip(const Matrix<U, _Inc> &other, F f, ExecutionPolicy policy = SEQUENTIAL) const
+    {
+        MATRIX_PROFILE_SCOPE("Zip");
+        assert(uRow == other.uRow && uCol == other.uCol);
+        Matrix<R> r(uRow, uCol);
+        const T *srcA = pData;
+        const U *srcB = other.pData;
+        R *dst = r.pData;
+        ForEachRange(policy, [&](size_t b, size_t e)
+                     {
+                         const T *MATRIX_RESTRICT pa = srcA;
+                         const U *MATRIX_RESTRICT pb = srcB;
+                         R *MATRIX_RESTRICT pd = dst;
+                         for (size_t i = b; i < e; ++i)
+                             pd[i] = f(pa[i], pb[i]);
+                     });
+        return r;
+    }
+
+public:
+    /**
+     * @brief 按行主序归约所有元素 init ⊕ a₀ ⊕ a₁ ⊕ ...
+     *
+     * SEQUENTIAL 策略从左到右逐个累积，op可以是任意 A op(const A &, const T &)。
+     * PARALLEL 策略把元素按固定大小（与线程数无关）分段，每段以段首元素转换为A作为初值
+     * 累积，各段结果再按顺序与init合并，因此要求A可由T构造、op满足结合律且可以
+     * op(A, A) 调用（如加法、乘法、最大最小值）。结果与线程数无关，但浮点加法
+     * 只近似满足结合律，与 SEQUENTIAL 的结果可能相差舍入误差。
+     *
+     * @param init      初值
+     * @param op        二元操作
+     * @param policy    执行策略
+     * @return 归约结果
+     */
+    template <typename A, typename Op>
+    A Reduce(A init, Op op, ExecutionPolicy policy = SEQUENTIAL) const
+    {
+        MATRIX_PROFILE_SCOPE("Reduce");
+        size_t n = uRow * uCol;
+        if (policy == SEQUENTIAL)
+        {
+            for (size_t i = 0; i < n; ++i)
+                init = op(init, pData[i]);
+            return init;
+        }
+        if (n == 0)
+            return init;
+
+        size_t segments = (n + uParallelGrain - 1) / uParallelGrain;
+        std::vector<A> partial(segments, init);
+        const T *data = pData;
+        auto body = [&](size_t s0, size_t s1)
+        {
+            for (size_t s = s0; s < s1; ++s)
+            {
+                size_t b = s * uParallelGrain, e = b + uParallelGrain;
+                if (e > n)
+                    e = n;
+                A acc = A(data[b]);
+                for (size_t i = b + 1; i < e; ++i)
+                    acc = op(acc, data[i]);
+                partial[s] = acc;
+            }
+        };
+        MatrixThreadPool::ParallelFor(0, segments, 1, body);
+
+        for (size_t s = 0; s < segments; ++s)
+            init = op(init, partial[s]);
+        return init;
+    }
+
+private:
+    //按执行策略把元素区间[0, n)交给 body(b, e)
+    template <typename Body>
+    void ForEachRange(ExecutionPolicy policy, const Body &body) const
+    {
+        size_t n = uRow * uCol;
+        if (policy == PARALLEL)
+            MatrixThreadPool::ParallelFor(0, n, uParallelGrain, body);
+        else
+            body(0, n);
+    }
+
+public:
+    //求和方法
+    enum SummationMethod
+    {
+        PAIRWISE, //成对求和，误差随log₂n增长，速度与逐个累加相当
+        KAHAN,    //Neumaier补偿求和，误差与元素个数无关，较慢
+    };
+
+public:
+    /**
+     * @brief 所有元素之和
+     *
+     * 元素个数超过阈值时按固定大小分段并行求和，各段的和再以同一方法合并，
+     * 分段与线程数无关，因此结果可复现。
+     *
+     * @param method 求和方法
+     * @return T 元素之和
+     */
+    T Sum(SummationMethod method = PAIRWISE) const
+    {
+        MATRIX_PROFILE_SCOPE("Sum");
+        return SumOf(pData, uRow * uCol, 1, method, [](const T &v)
+                     { return v; });
+    }
+
+public:
+    /**
+     * @brief 所有元素的平均值
+     *
+     * @param method 求和方法
+     * @return T 平均值，要求矩阵非空
+     */
+    T Mean(SummationMethod method = PAIRWISE) const
+    {
+        assert(uRow * uCol > 0);
+        return Sum(method) / T(uRow * uCol);
+    }
+
+public:
+    /**
+     * @brief 方阵的迹
+     *
+     * @param method 求和方法
+     * @return T 对角元素之和
+     */
+    T Trace(SummationMethod method = PAIRWISE) const
+    {
+        MATRIX_PROFILE_SCOPE("Trace");
+        assert(uRow == uCol);
+        return MatrixKernel<T>::Sum(uRow, pData, uCol + 1, method == KAHAN, [](const T &v)
+                                    { return v; });
+    }
+
+public:
+    /**
+     * @brief 各行元素之和
+     *
+     * 每行连续存储，按行并行。
+     *
+     * @param method 求和方法
+     * @return Vector<T> 长度为行数的向量
+     */
+    Vector<T> RowSums(SummationMethod method = PAIRWISE) const
+    {
+        MATRIX_PROFILE_SCOPE("RowSums");
+        return RowReduceSum(method, [](const T &v)
+                            { return v; });
+    }
+
+public:
+    /**
+     * @brief 各列元素之和
+     *
+     * 不按列跨步访问：把行分成每128行一块，块内逐行累加到长度为列数的部分和上
+     * （行内连续、可向量化），各块按块并行，块的部分和再按列以同一方法合并。
+     *
+     * @param method 求和方法
+     * @return Vector<T> 长度为列数的向量
+     */
+    Vector<T> ColSums(SummationMethod method = PAIRWISE) const
+    {
+        MATRIX_PROFILE_SCOPE("ColSums");
+        return ColumnReduceSum(method, [](const T &v)
+                               { return v; });
+    }
+
+public:
+    /**
+     * @brief 最小元素
+     *
+     * @return T 最小元素的值，要求矩阵非空
+     */
+    T Min() const
+    {
+        MATRIX_PROFILE_SCOPE("Min");
+        return pData[ArgExtreme(false)];
+    }
+
+public:
+    /**
+     * @brief 最大元素
+     *
+     * @return T 最大元素的值，要求矩阵非空
+     */
+    T Max() const
+    {
+        MATRIX_PROFILE_SCOPE("Max");
+        return pData[ArgExtreme(true)];
+    }
+
+public:
+    /**
+     * @brief 最小元素的位置
+     *
+     * 若有多个最小元素，返回按行主序的第一个。行列序号起始同 operator()()。
+     *
+     * @return std::pair<size_t, size_t> 行号与列号
+     */
+    std::pair<size_t, size_t> ArgMin() const
+    {
+        MATRIX_PROFILE_SCOPE("ArgMin");
+        return ToPosition(ArgExtreme(false));
+    }
+
+public:
+    /**
+     * @brief 最大元素的位置
+     *
+     * 若有多个最大元素，返回按行主序的第一个。行列序号起始同 operator()()。
+     *
+     * @return std::pair<size_t, size_t> 行号与列号
+     */
+    std::pair<size_t, size_t> ArgMax() const
+    {
+        MATRIX_PROFILE_SCOPE("ArgMax");
+        return ToPosition(ArgExtreme(true));
+    }
+
+public:
+    /**
+     * @brief Frobenius范数 sqrt(Σ|aᵢⱼ|²)
+     *
+     * 平方和上溢或下溢时以最大元素的绝对值缩放后重新计算。复数元素的结果为实数。
+     *
+     * @param method 求和方法
+     * @return Frobenius范数
+     */
+    typename MatrixScalar<T>::Real FrobeniusNorm(SummationMethod method = PAIRWISE) const
+    {
+        MATRIX_PROFILE_SCOPE("FrobeniusNorm");
+        typedef typename MatrixScalar<T>::Real R;
+        size_t n = uRow * uCol;
+        R ssq = MatrixScalar<T>::RealPart(SumOf(pData, n, 1, method, [](const T &v)
+                                                { return T(MatrixScalar<T>::AbsSquare(v)); }));
+        if (ssq > R(0) && ssq <= std::numeric_limits<R>::max() && ssq >= std::numeric_limits<R>::min())
+            return std::sqrt(ssq);
+
+        //上溢、下溢或全为0
+        R scale = R(0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            R a = MatrixScalar<T>::Abs(pData[i]);
+            if (a > scale)
+                scale = a;
+        }
+        if (scale == R(0) || !(scale <= std::numeric_limits<R>::max()))
+            return scale;
+        ssq = MatrixScalar<T>::RealPart(SumOf(pData, n, 1, method, [scale](const T &v)
+                                              { return T(MatrixScalar<T>::AbsSquare(v / scale)); }));
+        return scale * std::sqrt(ssq);
+    }
+
+public:
+    /**
+     * @brief 1范数：各列元素绝对值之和的最大值
+     *
+     * @return 1范数
+     */
+    typename MatrixScalar<T>::Real Norm1() const
+    {
+        MATRIX_PROFILE_SCOPE("Norm1");
+        typedef typename MatrixScalar<T>::Real R;
+        Vector<T> sums = ColumnReduceSum(PAIRWISE, [](const T &v)
+                                         { return T(MatrixScalar<T>::Abs(v)); });
+        R norm = R(0);
+        for (size_t j = 0; j < sums.Size(); ++j)
+            if (MatrixScalar<T>::RealPart(sums[j]) > norm)
+                norm = MatrixScalar<T>::RealPart(sums[j]);
+        return norm;
+    }
+
+public:
+    /**
+     * @brief 无穷范数：各行元素绝对值之和的最大值
+     *
+     * @return 无穷范数
+     */
+    typename MatrixScalar<T>::Real NormInf() const
+    {
+        MATRIX_PROFILE_SCOPE("NormInf");
+        typedef typename MatrixScalar<T>::Real R;
+        Vector<T> sums = RowReduceSum(PAIRWISE, [](const T &v)
+                                      { return T(MatrixScalar<T>::Abs(v)); });
+        R norm = R(0);
+        for (size_t i = 0; i < sums.Size(); ++i)
+            if (MatrixScalar<T>::RealPart(sums[i]) > norm)
+                norm = MatrixScalar<T>::RealPart(sums[i]);
+        return norm;
+    }
+
+private:
+    /**
+     * @brief 求 Σ f(xᵢ)，长向量按固定大小分段并行
+     *
+     * @param x         数据
+     * @param n         元素个数
+     * @param incx      元素间距
+     * @param method    求和方法
+     * @param f         对每个元素的变换
+     * @return T        和
+     */
+    template <typename F>
+    static T SumOf(const T *x, size_t n, size_t incx, SummationMethod method, const F &f)
+    {
+        typedef typename MatrixScalar<T>::Accumulator A;
+        bool compensated = method == KAHAN;
+        if (n < 2 * uReductionSegment)
+            return MatrixKernel<T>::Sum(n, x, incx, compensated, f);
+
+        //各段的部分和以Accumulator保存，合并后只舍入一次
+        size_t segments = (n + uReductionSegment - 1) / uReductionSegment;
+        std::vector<A> partial(segments);
+        MatrixThreadPool::ParallelFor(0, segments, 1, [&](size_t s0, size_t s1)
+                                      {
+                                          for (size_t s = s0; s < s1; ++s)
+                                          {
+                                              size_t b = s * uReductionSegment, len = uReductionSegment;
+                                              if (b + len > n)
+                                                  len = n - b;
+                                              partial[s] = MatrixKernel<T>::AccumulateSum(len, x + b * incx, incx, compensated, f);
+                                          }
+                                      });
+        return T(MatrixKernel<A>::Sum(segments, partial.data(), 1, compensated, [](const A &v)
+                                      { return v; }));
+    }
+
+private:
+    //各行 Σ f(aᵢⱼ)，按行并行
+    template <typename F>
+    Vector<T> RowReduceSum(SummationMethod method, const F &f) const
+    {
+        Vector<T> sums(uRow);
+        T *out = sums.Data();
+        const T *data = pData;
+        size_t cols = uCol;
+        bool compensated = method == KAHAN;
+        size_t grain = cols >= uReductionSegment ? 1 : uReductionSegment / (cols > 0 ? cols : 1);
+        MatrixThreadPool::ParallelFor(0, uRow, grain, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                              out[i] = MatrixKernel<T>::Sum(cols, data + i * cols, 1, compensated, f);
+                                      });
+        return sums;
+    }
+
+private:
+    //各列 Σ f(aᵢⱼ)，按128行分块逐行累加，块间按列合并
+    template <typename F>
+    Vector<T> ColumnReduceSum(SummationMethod method, const F &f) const
+    {
+        typedef typename MatrixScalar<T>::Accumulator A;
+        const size_t blockRows = 128;
+        size_t rows = uRow, cols = uCol;
+        size_t blocks = (rows + blockRows - 1) / blockRows;
+        bool compensated = method == KAHAN;
+        const T *data = pData;
+
+        //第b块的部分和以Accumulator存放于partial的第b行
+        std::vector<A> partial(blocks * cols, A(0));
+        size_t grain = blockRows * cols >= uReductionSegment ? 1 : uReductionSegment / (blockRows * cols > 0 ? blockRows * cols : 1);
+        MatrixThreadPool::ParallelFor(0, blocks, grain, [&](size_t b0, size_t b1)
+                                      {
+                                          std::vector<A> comp(compensated ? cols : 0, A(0));
+                                          for (size_t blk = b0; blk < b1; ++blk)
+                                          {
+                                              A *MATRIX_RESTRICT ps = partial.data() + blk * cols;
+                                              size_t i1 = (blk + 1) * blockRows < rows ? (blk + 1) * blockRows : rows;
+                                              if (compensated)
+                                                  std::fill(comp.begin(), comp.end(), A(0));
+                                              for (size_t i = blk * blockRows; i < i1; ++i)
+                                              {
+                                                  const T *MATRIX_RESTRICT pr = data + i * cols;
+                                                  if (compensated)
+                                                      for (size_t j = 0; j < cols; ++j)
+                                                          MatrixKernel<T>::NeumaierAdd(ps[j], comp[j], f(pr[j]));
+                                                  else
+                                                      for (size_t j = 0; j < cols; ++j)
+                                                          ps[j] += f(pr[j]);
+                                              }
+                                              if (compensated)
+                                                  for (size_t j = 0; j < cols; ++j)
+                                                      ps[j] += comp[j];
+                                          }
+                                      });
+
+        Vector<T> sums(cols);
+        for (size_t j = 0; j < cols; ++j)
+            sums[j] = T(blocks == 1 ? partial[j]
+                                    : MatrixKernel<A>::Sum(blocks, partial.data() + j, cols, compensated, [](const A &v)
+                                                           { return v; }));
+        return sums;
+    }
+
+private:
+    /**
+     * @brief 最大或最小元素的线性下标，相等时取最小的下标
+     *
+     * @param max       为真时求最大元素，否则求最小元素
+     * @param absolute  是否比较绝对值
+     * @return size_t   线性下标
+     */
+    size_t ArgExtreme(bool max, bool absolute = false) const
+    {
+        using std::abs;
+        size_t n = uRow * uCol;
+        assert(n > 0);
+        size_t segments = (n + uReductionSegment - 1) / uReductionSegment;
+        std::vector<size_t> best(segments);
+        const T *data = pData;
+        auto key = [=](size_t i)
+        { return absolute ? T(abs(data[i])) : data[i]; };
+        MatrixThreadPool::ParallelFor(0, segments, 1, [&](size_t s0, size_t s1)
+                                      {
+                                          for (size_t s = s0; s < s1; ++s)
+                                          {
+                                              size_t b = s * uReductionSegment, e = b + uReductionSegment;
+                                              if (e > n)
+                                                  e = n;
+                                              size_t k = b;
+                                              T v = key(b);
+                                              for (size_t i = b + 1; i < e; ++i)
+                                              {
+                                                  T x = key(i);
+                                                  if (max ? x > v : x < v)
+                                                  {
+                                                      v = x;
+                                                      k = i;
+                                                  }
+                                              }
+                                              best[s] = k;
+                                          }
+                                      });
+        size_t k = best[0];
+        for (size_t s = 1; s < segments; ++s)
+            if (max ? key(best[s]) > key(k) : key(best[s]) < key(k))
+                k = best[s];
+        return k;
+    }
+
+private:
+    //线性下标转换为 operator()() 约定的行号与列号
+    std::pair<size_t, size_t> ToPosition(size_t index) const
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        return std::make_pair(index / uCol, index % uCol);
+#else
+        return std::make_pair(index / uCol + 1, index % uCol + 1);
+#endif
+    }
+
+public:
+    /**
+        @brief 在矩阵中插入一行数据，可能会引起数据扩增
+
+        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+        否则从1开始。
+
+        @param pos			要插入到的行序号
+        @param pNewRowData	要插入的行数据的指针
+        @param dataSize		要插入的行数据的个数，若少于列数，将使用0补齐
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &InsertRow(size_t pos, const T *pNewRowData, size_t dataSize)
+    {
+        MATRIX_PROFILE_SCOPE("InsertRow");
+        size_t p = ToZeroBasedIndex(pos);
+        //检查位置是否合法
+        assert(p <= uRow);
+
+        //实际添加的数据个数n
+        size_t n = uCol < dataSize ? uCol : dataSize;
+
+        T *pNewRowHead = OpenRows(p, 1);
+        std::copy_n(pNewRowData, n, pNewRowHead); //复制数据
+        std::fill(pNewRowHead + n, pNewRowHead + uCol, T(0)); //用0把这行填满
+
+        return *this;
+    }
+
+public:
+    /**
+        @brief 在矩阵中插入一行数据，可能会引起数据扩增
+
+        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+        否则从1开始。
+
+        @param pos			要插入到的行序号
+        @param pNewRowData	要插入的行数据的指针
+        @param dataSize		要插入的行数据的个数，若少于列数，将使用0补齐
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &InsertRow(size_t pos, const std::vector<T> &rowData)
+    {
+        return InsertRow(pos, rowData.data(), rowData.size());
+    }
+
+public:
+    /**
+        @brief 在矩阵中插入一列数据，可能会引起数据扩增
+
+        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+        否则从1开始。
+
+        @param pos			要插入到的列序号
+        @param pNewRowData	要插入的列数据的指针
+        @param dataSize		要插入的列数据的个数，若少于行数，将使用0补齐
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &InsertColumn(size_t pos, const T *pNewColData, size_t dataSize)
+    {
+        MATRIX_PROFILE_SCOPE("InsertColumn");
+        size_t p = ToZeroBasedIndex(pos);
+        //检查插入位置是否合法
+        assert(p <= uCol);
+
+        //实际添加的数据个数n
+        size_t n = uRow < dataSize ? uRow : dataSize;
+
+        //获取空出的第一个位置的指针
+        T *pBlankPos = OpenColumns(p, 1);
+        for (size_t i = 0; i < n; ++i)
+            *(pBlankPos + i * uCol) = pNewColData[i];
+        for (size_t i = n; i < uRow; ++i)
+            *(pBlankPos + i * uCol) = T(0);
+
+        return *this;
+    }
+
+public:
+    /**
+        @brief 在矩阵中插入一列数据，可能会引起数据扩增
+
+        若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+        否则从1开始。
+
+        @param pos		要插入到的列序号
+        @param colData	要插入的列数据
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &InsertColumn(size_t pos, const std::vector<T> &colData)
+    {
+        return InsertColumn(pos, colData.data(), colData.size());
+    }
+
+public:
+    /**
+     * @brief 在矩阵中插入若干行
+     *
+     * 一次移动插入位置之后的所有行，容量不足或数据被共享时只重新分配一次。
+     * 矩阵没有行时，列数取为block的列数。
+     *
+     * 若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，否则从1开始。
+     *
+     * @param pos   插入后block第一行的行序号，取行数+1（从0开始时为行数）表示追加到末尾
+     * @param block 要插入的行，列数与本矩阵相同，可以是本矩阵自身
+     * @return Matrix<T>&  本对象的引用
+     */
+    Matrix<T> &InsertRows(size_t pos, const Matrix<T> &block)
+    {
+        MATRIX_PROFILE_SCOPE("InsertRows");
+        if (block.pData == pData && block.uRow > 0)
+            return InsertRows(pos, Matrix<T>(block.uRow, block.uCol, block.Data(), block.uRow * block.uCol));
+        size_t p = ToZeroBasedIndex(pos);
+        assert(p <= uRow);
+        if (uRow == 0)
+            uCol = block.uCol;
+        assert(block.uCol == uCol);
+
+        T *pDst = OpenRows(p, block.uRow);
+        std::copy_n(block.pData, block.uRow * block.uCol, pDst);
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 在矩阵中插入若干列
+     *
+     * 每行只移动一次，容量不足或数据被共享时只重新分配一次，重新分配时按行并行复制。
+     * 矩阵没有列时，行数取为block的行数。
+     *
+     * 若定义了MATRIX_INDEX_START_AT_0,则列序号从0开始，否则从1开始。
+     *
+     * @param pos   插入后block第一列的列序号，取列数+1（从0开始时为列数）表示追加到最右侧
+     * @param block 要插入的列，行数与本矩阵相同，可以是本矩阵自身
+     * @return Matrix<T>&  本对象的引用
+     */
+    Matrix<T> &InsertColumns(size_t pos, const Matrix<T> &block)
+    {
+        MATRIX_PROFILE_SCOPE("InsertColumns");
+        if (block.pData == pData && block.uCol > 0)
+            return InsertColumns(pos, Matrix<T>(block.uRow, block.uCol, block.Data(), block.uRow * block.uCol));
+        size_t p = ToZeroBasedIndex(pos);
+        assert(p <= uCol);
+        if (uCol == 0)
+            uRow = block.uRow;
+        assert(block.uRow == uRow);
+
+        size_t k = block.uCol;
+        T *pDst = OpenColumns(p, k);
+        for (size_t i = 0; i < uRow; ++i)
+            std::copy_n(block.pData + i * k, k, pDst + i * uCol);
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 删除若干行
+     *
+     * 保留的连续行整段前移，一遍完成，不重新分配内存。
+     *
+     * 若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，否则从1开始。
+     *
+     * @param rows  要删除的行序号，顺序任意，重复的序号只删除一次
+     * @return Matrix<T>&  本对象的引用
+     */
+    Matrix<T> &RemoveRows(const std::vector<size_t> &rows)
+    {
+        MATRIX_PROFILE_SCOPE("RemoveRows");
+        Detach();
+        std::vector<char> removed = RemovalMask(rows, uRow);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < uRow;)
+        {
+            if (removed[i])
+            {
+                ++i;
+                continue;
+            }
+            //保留的连续行[i, j)
+            size_t j = i;
+            while (j < uRow && !removed[j])
+                ++j;
+            if (kept != i)
+                std::copy(pData + i * uCol, pData + j * uCol, pData + kept * uCol);
+            kept += j - i;
+            i = j;
+        }
+        uRow = kept;
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 删除若干列
+     *
+     * 先求出保留的连续列段，再逐行把各段前移，一遍完成，不重新分配内存。
+     *
+     * 若定义了MATRIX_INDEX_START_AT_0,则列序号从0开始，否则从1开始。
+     *
+     * @param cols  要删除的列序号，顺序任意，重复的序号只删除一次
+     * @return Matrix<T>&  本对象的引用
+     */
+    Matrix<T> &RemoveColumns(const std::vector<size_t> &cols)
+    {
+        MATRIX_PROFILE_SCOPE("RemoveColumns");
+        Detach();
+        std::vector<char> removed = RemovalMask(cols, uCol);
+
+        //保留的连续列段（起始列，列数）
+        std::vector<std::pair<size_t, size_t>> runs;
+        for (size_t j = 0; j < uCol;)
+        {
+            if (removed[j])
+            {
+                ++j;
+                continue;
+            }
+            size_t e = j;
+            while (e < uCol && !removed[e])
+                ++e;
+            runs.emplace_back(j, e - j);
+            j = e;
+        }
+        size_t newCol = 0;
+        for (const auto &run : runs)
+            newCol += run.second;
+
+        T *pDst = pData;
+        for (size_t i = 0; i < uRow; ++i)
+        {
+            const T *pRow = pData + i * uCol;
+            for (const auto &run : runs)
+            {
+                if (pDst != pRow + run.first)
+                    std::copy_n(pRow + run.first, run.second, pDst);
+                pDst += run.second;
+            }
+        }
+        uCol = newCol;
+        return *this;
+    }
+
+private:
+    //把要删除的序号转换为标记数组，mask[i]非0表示删除第i个（从0开始）
+    static std::vector<char> RemovalMask(const std::vector<size_t> &indices, size_t count)
+    {
+        std::vector<char> mask(count, 0);
+        for (size_t index : indices)
+        {
+            size_t i = ToZeroBasedIndex(index);
+            assert(i < count);
+            mask[i] = 1;
+        }
+        return mask;
+    }
+
+private:
+    /**
+     * @brief 在第p行（从0开始）之前空出k行，空出的元素由调用者写入
+     *
+     * 容量足够且数据未被共享时整段后移，否则只分配一次新内存并复制两段。
+     *
+     * @return T* 空出的第一个元素
+     */
+    T *OpenRows(size_t p, size_t k)
+    {
+        size_t oldSize = uRow * uCol, newSize = (uRow + k) * uCol;
+        if (newSize > uCapacity || UseCount() > 1)
+        {
+            size_t capacity = uCapacityIncrement * newSize;
+            T *pNewData = AllocData(capacity, uRow + k, uCol);
+            std::copy_n(pData, p * uCol, pNewData);
+            std::copy_n(pData + p * uCol, oldSize - p * uCol, pNewData + (p + k) * uCol);
+            ReleaseData();
+            pData = pNewData;
+            uCapacity = capacity;
+        }
+        else
+            std::copy_backward(pData + p * uCol, pData + oldSize, pData + newSize);
+        uRow += k;
+        return pData + p * uCol;
+    }
+
+private:
+    /**
+     * @brief 在第p列（从0开始）之前空出k列，空出的元素由调用者写入
+     *
+     * 容量足够且数据未被共享时从最后一行起逐行后移，每行只移动一次；
+     * 否则只分配一次新内存，按行并行复制。
+     *
+     * @return T* 新布局中第0行第p列的元素
+     */
+    T *OpenColumns(size_t p, size_t k)
+    {
+        size_t oldCol = uCol, newCol = uCol + k, newSize = uRow * newCol;
+        if (newSize > uCapacity || UseCount() > 1)
+        {
+            size_t capacity = uCapacityIncrement * newSize;
+            T *pNewData = AllocData(capacity, uRow, newCol);
+            const T *pOld = pData;
+            MatrixThreadPool::ParallelFor(0, uRow, uParallelGrain / (newCol > 0 ? newCol : 1) + 1, [=](size_t b, size_t e)
+                                          {
+                                              for (size_t i = b; i < e; ++i)
+                                              {
+                                                  std::copy_n(pOld + i * oldCol, p, pNewData + i * newCol);
+                                                  std::copy_n(pOld + i * oldCol + p, oldCol - p, pNewData + i * newCol + p + k);
+                                              }
+                                          });
+            ReleaseData();
+            pData = pNewData;
+            uCapacity = capacity;
+        }
+        else
+        {
+            //新位置不在旧位置之前，从后向前移动不会覆盖尚未移动的数据
+            for (size_t i = uRow; i-- > 1;)
+            {
+                T *pSrc = pData + i * oldCol, *pDst = pData + i * newCol;
+                std::copy_backward(pSrc + p, pSrc + oldCol, pDst + newCol);
+                std::copy_backward(pSrc, pSrc + p, pDst + p);
+            }
+            if (uRow > 0)
+                std::copy_backward(pData + p, pData + oldCol, pData + newCol);
+        }
+        uCol = newCol;
+        return pData + p;
+    }
+
+public:
+    /**
+        @brief 矩阵最下方添加一行数据，可能会引起数据扩增
+
+        @param pNewRowData	要添加的行数据的指针
+        @param dataSize		要添加的行数据的个数，若少于列数，将使用0补齐
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &AddRow(const T *pNewRowData, size_t dataSize)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        return InsertRow(uRow, pNewRowData, dataSize);
+#else
+        return InsertRow(uRow + 1, pNewRowData, dataSize);
+#endif
+    }
+
+public:
+    /**
+        @brief 矩阵最下方添加一行数据，可能会引起数据扩增
+
         @param rowData	要添加的行数据
         @return Matrix<T>&  本对象的引用
     */
-    Matrix<T> &AddRow(const std::vector<T> &rowData)
+    Matrix<T> &AddRow(const std::vector<T> &rowData)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        return InsertRow(uRow, rowData.data(), rowData.size());
+#else
+        return InsertRow(uRow + 1, rowData.data(), rowData.size());
+#endif
+    }
+
+public:
+    /**
+        @brief 矩阵最右侧添加一列数据，可能会引起数据扩增
+
+        @param pNewColData	要添加的列数据的指针
+        @param dataSize		要添加的列数据的个数，若少于行数，将使用0补齐
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &AddColumn(const T *pNewColData, size_t dataSize)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        return InsertColumn(uCol, pNewColData, dataSize);
+#else
+        return InsertColumn(uCol + 1, pNewColData, dataSize);
+#endif
+    }
+
+public:
+    /**
+        @brief 矩阵最右侧添加一列数据，可能会引起数据扩增
+
+        @param colData	要添加的列数据的指针
+        @return Matrix<T>&  本对象的引用
+    */
+    Matrix<T> &AddColumn(const std::vector<T> &colData)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        return InsertColumn(uCol, colData.data(), colData.size());
+#else
+        return InsertColumn(uCol + 1, colData.data(), colData.size());
+#endif
+    }
+
+public:
+    /**
+     * @brief 获取矩阵区块
+     * 
+     *  若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+     *  否则从1开始。
+     * 
+     * @param rowStart      区块行起始序号
+     * @param colStart      区块列起始序号
+     * @param rowSpan       区块行数
+     * @param colSpan       区块列数
+     * @return Matrix<T>    区块拷贝得到的矩阵
+     */
+    Matrix<T> Block(size_t rowStart, size_t colStart, size_t rowSpan, size_t colSpan)
+    {
+        MATRIX_PROFILE_SCOPE("Block");
+        //这个V0.3新加的函数用0为序号基准
+#ifndef MATRIX_INDEX_START_AT_0
+        --rowStart;
+        --colStart;
+#endif
+        assert(rowStart < uRow && colStart < uCol);
+        rowSpan = rowSpan + rowStart > uRow ? uRow - rowStart : rowSpan;
+        colSpan = colSpan + colStart > uCol ? uCol - colStart : colSpan;
+
+        Matrix<T> blockMat(rowSpan, colSpan);
+        for (size_t i = 0; i < rowSpan; ++i)
+            for (size_t j = 0; j < colSpan; ++j)
+                blockMat.ElemAt0(i, j) = pData[(i + rowStart) * uCol + j + colStart];
+
+        return blockMat;
+    }
+
+public:
+    static const size_t uInferred = size_t(-1); //零块的行列数由所在块行、块列决定
+
+    /**
+     * @brief Concat() 的一个块：整个矩阵、矩阵的子块或零块
+     *
+     * 矩阵与子块只保存数据指针，不复制，其生存期必须覆盖 Concat() 的调用。
+     * nullptr 可隐式转换为大小待定的零块。
+     */
+    class ConcatBlock
+    {
+        friend class Matrix;
+
+    private:
+        const T *pSrc = nullptr; //首元素，零块为空
+        size_t uLd = 0;          //行跨度
+        size_t uRows;            //行数
+        size_t uCols;            //列数
+
+    public:
+        //整个矩阵
+        template <size_t _I>
+        ConcatBlock(const Matrix<T, _I> &mat) : pSrc(mat.Data()), uLd(mat.ColumnSize()), uRows(mat.RowSize()), uCols(mat.ColumnSize()) {}
+
+        /**
+         * @brief 矩阵的子块，序号起始与 Block() 一致，超出矩阵的部分被截去
+         *
+         * @param mat       矩阵
+         * @param rowStart  子块行起始序号
+         * @param colStart  子块列起始序号
+         * @param rowSpan   子块行数
+         * @param colSpan   子块列数
+         */
+        template <size_t _I>
+        ConcatBlock(const Matrix<T, _I> &mat, size_t rowStart, size_t colStart, size_t rowSpan, size_t colSpan)
+        {
+            size_t r0 = ToZeroBasedIndex(rowStart), c0 = ToZeroBasedIndex(colStart);
+            assert(r0 < mat.RowSize() && c0 < mat.ColumnSize());
+            uRows = rowSpan + r0 > mat.RowSize() ? mat.RowSize() - r0 : rowSpan;
+            uCols = colSpan + c0 > mat.ColumnSize() ? mat.ColumnSize() - c0 : colSpan;
+            uLd = mat.ColumnSize();
+            pSrc = mat.Data() + r0 * uLd + c0;
+        }
+
+        //大小待定的零块
+        ConcatBlock(std::nullptr_t) : uRows(uInferred), uCols(uInferred) {}
+
+        /**
+         * @brief 零块
+         *
+         * @param rows  行数，uInferred 表示由所在块行决定
+         * @param cols  列数，uInferred 表示由所在块列决定
+         */
+        static ConcatBlock Zero(size_t rows = uInferred, size_t cols = uInferred)
+        {
+            ConcatBlock blk(nullptr);
+            blk.uRows = rows;
+            blk.uCols = cols;
+            return blk;
+        }
+    };
+
+public:
+    /**
+     * @brief 由块网格拼接矩阵
+     *
+     * 每个块行的块数必须相同；同一块行中的块行数相同，同一块列中的块列数相同，
+     * 零块的大小可由其他块推出，全为待定零块的块行或块列为空。
+     * 先求出结果的形状，只分配一次，再按结果的行（较大时并行）把各块的行整段复制进去，
+     * 零块不写入。
+     *
+     * @param grid  块网格，如 {{H, Aᵀ}, {A, nullptr}}
+     * @return Matrix<T> 拼接得到的矩阵
+     */
+    static Matrix<T> Concat(const std::vector<std::vector<ConcatBlock>> &grid)
+    {
+        MATRIX_PROFILE_SCOPE("Concat");
+        size_t br = grid.size(), bc = br > 0 ? grid[0].size() : 0;
+
+        //各块行的行数与各块列的列数
+        std::vector<size_t> heights(br, size_t(uInferred)), widths(bc, size_t(uInferred));
+        for (size_t i = 0; i < br; ++i)
+        {
+            assert(grid[i].size() == bc);
+            for (size_t j = 0; j < bc; ++j)
+            {
+                const ConcatBlock &blk = grid[i][j];
+                if (blk.uRows != uInferred)
+                {
+                    assert(heights[i] == uInferred || heights[i] == blk.uRows);
+                    heights[i] = blk.uRows;
+                }
+                if (blk.uCols != uInferred)
+                {
+                    assert(widths[j] == uInferred || widths[j] == blk.uCols);
+                    widths[j] = blk.uCols;
+                }
+            }
+        }
+        std::vector<size_t> rowOff(br + 1, 0), colOff(bc + 1, 0);
+        for (size_t i = 0; i < br; ++i)
+            rowOff[i + 1] = rowOff[i] + (heights[i] == uInferred ? 0 : heights[i]);
+        for (size_t j = 0; j < bc; ++j)
+            colOff[j + 1] = colOff[j] + (widths[j] == uInferred ? 0 : widths[j]);
+
+        Matrix<T> r(rowOff[br], colOff[bc]);
+        size_t cols = r.uCol;
+        T *pr = r.pData;
+        MatrixThreadPool::ParallelFor(0, r.uRow, uParallelGrain / (cols > 0 ? cols : 1) + 1, [&](size_t b, size_t e)
+                                      {
+                                          //b所在的块行
+                                          size_t bi = std::upper_bound(rowOff.begin(), rowOff.end(), b) - rowOff.begin() - 1;
+                                          for (size_t row = b; row < e; ++row)
+                                          {
+                                              while (row >= rowOff[bi + 1])
+                                                  ++bi;
+                                              size_t local = row - rowOff[bi];
+                                              for (size_t j = 0; j < bc; ++j)
+                                              {
+                                                  const ConcatBlock &blk = grid[bi][j];
+                                                  if (blk.pSrc)
+                                                      std::copy_n(blk.pSrc + local * blk.uLd, blk.uCols, pr + row * cols + colOff[j]);
+                                              }
+                                          }
+                                      });
+        return r;
+    }
+
+    //由初始化列表形式的块网格拼接矩阵
+    static Matrix<T> Concat(std::initializer_list<std::initializer_list<ConcatBlock>> grid)
+    {
+        std::vector<std::vector<ConcatBlock>> rows;
+        rows.reserve(grid.size());
+        for (const auto &row : grid)
+            rows.emplace_back(row);
+        return Concat(rows);
+    }
+
+public:
+    /**
+        @brief 将该矩阵与参数中的矩阵合并
+
+        LEFT	    将mat置于左侧合并，要求行数相同
+        RIGHT	    将mat置于右侧合并，要求行数相同
+        ABOVE	    将mat置于上方合并，要求列数相同
+        BELOW	    将mat置于下方合并，要求列数相同
+        TOPLEFT	    将mat置于左上角合并，其余位置补0
+        TOPRIGHT    将mat置于右上角合并，其余位置补0
+        BOTLEFT	    将mat置于左下角合并，其余位置补0
+        BOTRIGHT	将mat置于右下角合并，其余位置补0
+
+        多于两个矩阵时使用 Concat()，避免逐次合并产生的中间矩阵。
+
+        @param mat	要合并的第二个矩阵
+        @param d	第二个矩阵的相对位置
+
+        @return				合并的矩阵
+    */
+    Matrix<T> CombineWith(const Matrix<T> &mat, Direction d) const
+    {
+        MATRIX_PROFILE_SCOPE("CombineWith");
+        switch (d)
+        {
+        case LEFT:
+            assert(uRow == mat.uRow);
+            return Concat({{mat, *this}});
+        case RIGHT:
+            assert(uRow == mat.uRow);
+            return Concat({{*this, mat}});
+        case ABOVE:
+            assert(uCol == mat.uCol);
+            return Concat({{mat}, {*this}});
+        case BELOW:
+            assert(uCol == mat.uCol);
+            return Concat({{*this}, {mat}});
+        case TOPLEFT:
+            return Concat({{mat, nullptr}, {nullptr, *this}});
+        case TOPRIGHT:
+            return Concat({{nullptr, mat}, {*this, nullptr}});
+        case BOTLEFT:
+            return Concat({{nullptr, *this}, {mat, nullptr}});
+        case BOTRIGHT:
+            return Concat({{*this, nullptr}, {nullptr, mat}});
+        default:
+            assert(0);
+        }
+        return Matrix<T>();
+    }
+
+public:
+    /**
+     *  @brief 矩阵按行分解，保留指定方向的矩阵
+     *  
+     *  取值：
+     *  ABOVE	保留分割行和其上方的部分
+     *  BELOW	保留分割行和其下方的部分
+     * 
+     *  若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+     *  否则从1开始。
+     * 
+     *  @param SplitterRowIndex		分割行的序号，该行将被保留在返回的矩阵中
+     *  @param d			        分割保留的方向
+     *   
+     *  @return		分割后保留的部分构成的矩阵
+     */
+    Matrix<T> RowSplit(size_t SplitterRowIndex, Direction d) const
+    {
+        MATRIX_PROFILE_SCOPE("RowSplit");
+        //n：结果矩阵的行数
+        size_t n = SplitterRowIndex <= this->uRow ? SplitterRowIndex : this->uRow;
+
+        if (d == ABOVE)
+        {
+            Matrix<T> r(n, this->uCol);
+            std::copy_n(this->pData, r.uRow * r.uCol, r.pData);
+            return r;
+        }
+        else if (d == BELOW)
+        {
+            Matrix<T> r(this->uRow - n + 1, this->uCol);
+            std::copy_n(&this->ElemAt(n, 1), r.uRow * r.uCol, r.pData);
+            return r;
+        }
+
+        assert(0);
+        return Matrix<T>();
+    }
+
+public:
+    /**
+     *  @brief 矩阵按列分解，保留指定方向的矩阵
+     * 
+     *  取值：
+     *  ON_LFET		0	保留分割列和其左边的部分
+     *  ON_RIGHT	1	保留分割列和其右边的部分
+     *   
+     *  若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
+     *  否则从1开始。
+     *
+     *  @param SplitterRowIndex		分割列的序号，该列将被保留在返回的矩阵中
+     *  @param d			分割保留的方向
+     *   
+     *  @return		分割后保留的部分构成的矩阵
+     */
+    Matrix<T> ColumnSplit(size_t SplitterColIndex, Direction d) const
+    {
+        MATRIX_PROFILE_SCOPE("ColumnSplit");
+        //n：结果矩阵的列数
+        size_t n = SplitterColIndex <= this->uCol ? SplitterColIndex : this->uCol;
+
+        if (d == LEFT)
+        {
+            Matrix<T> r(uRow, n);
+            T *pSubRowHead = r.pData;
+            T *pRowHead = this->pData;
+
+            for (size_t i = 1; i <= uRow; ++i)
+            {
+                for (size_t j = 0; j < n; ++j)
+                    pSubRowHead[j] = pRowHead[j];
+                pSubRowHead += r.uCol;
+                pRowHead += this->uCol;
+            }
+            return r;
+        }
+        else if (d == RIGHT)
+        {
+            Matrix<T> r(uRow, this->uCol - n + 1);
+            T *pSubRowHead = r.pData;
+            T *pRowHead = this->pData + n - 1;
+
+            for (size_t i = 1; i <= uRow; ++i)
+            {
+                for (size_t j = 0; j < r.uCol; ++j)
+                    pSubRowHead[j] = pRowHead[j];
+                pSubRowHead += r.uCol;
+                pRowHead += this->uCol;
+            }
+            return r;
+        }
+
+        assert(0);
+        return Matrix<T>();
+    }
+
+public:
+    /**
+        @brief 矩阵同型检查：检查矩阵1和矩阵2是否为同型矩阵
+
+        @param mat1		矩阵1
+        @param mat2		矩阵2
+        @return		若mat1和mat2为同型矩阵，则返回true，否则返回false
+    */
+    static bool Varify_Homo(const Matrix<T> &mat1, const Matrix<T> &mat2)
+    {
+        if ((mat1.uRow - mat2.uRow) || (mat1.uCol - mat2.uCol)) //如果行数列数不等
+            return false;
+        return true;
+    }
+
+public:
+    //矩阵取负
+    Matrix<T> operator-() const &
+    {
+        MATRIX_PROFILE_SCOPE("Negate");
+        Matrix<T> resMat(uRow, uCol);
+        ElementWise(uRow * uCol, pData, resMat.pData, [](const T &a)
+                    { return -a; });
+        return resMat;
+    }
+
+public:
+    //右值矩阵取负：直接在临时对象的数据上计算并移出，不分配内存
+    Matrix<T> operator-() &&
+    {
+        MATRIX_PROFILE_SCOPE("Negate");
+        Detach();
+        ElementWise(uRow * uCol, pData, pData, [](const T &a)
+                    { return -a; });
+        return std::move(*this);
+    }
+
+public:
+    //矩阵加法
+    Matrix<T> operator+(const Matrix<T> &mat) const &
+    {
+        MATRIX_PROFILE_SCOPE("Add");
+        //同型检查
+        assert(Varify_Homo(*this, mat));
+
+        Matrix<T> r(uRow, uCol);
+        ElementWise(uRow * uCol, pData, mat.pData, r.pData, [](const T &a, const T &b)
+                    { return a + b; });
+        return r;
+    }
+
+public:
+    //矩阵加法（左操作数为右值）：结果写入左操作数的数据
+    Matrix<T> operator+(const Matrix<T> &mat) &&
+    {
+        *this += mat;
+        return std::move(*this);
+    }
+
+public:
+    //矩阵加法（右操作数为右值）：结果写入右操作数的数据
+    Matrix<T> operator+(Matrix<T> &&mat) const &
+    {
+        mat += *this;
+        return std::move(mat);
+    }
+
+public:
+    //矩阵加法（两个操作数均为右值）：结果写入左操作数的数据
+    Matrix<T> operator+(Matrix<T> &&mat) &&
+    {
+        *this += mat;
+        return std::move(*this);
+    }
+
+public:
+    //矩阵减法
+    Matrix<T> operator-(const Matrix<T> &mat) const &
+    {
+        MATRIX_PROFILE_SCOPE("Subtract");
+        //同型检查
+        assert(Varify_Homo(*this, mat));
+
+        Matrix<T> r(uRow, uCol);
+        ElementWise(uRow * uCol, pData, mat.pData, r.pData, [](const T &a, const T &b)
+                    { return a - b; });
+        return r;
+    }
+
+public:
+    //矩阵减法（左操作数为右值）：结果写入左操作数的数据
+    Matrix<T> operator-(const Matrix<T> &mat) &&
+    {
+        *this -= mat;
+        return std::move(*this);
+    }
+
+public:
+    //矩阵减法（右操作数为右值）：结果写入右操作数的数据
+    Matrix<T> operator-(Matrix<T> &&mat) const &
+    {
+        MATRIX_PROFILE_SCOPE("Subtract");
+        //同型检查
+        assert(Varify_Homo(*this, mat));
+
+        mat.Detach();
+        ElementWise(uRow * uCol, mat.pData, pData, mat.pData, [](const T &b, const T &a)
+                    { return a - b; });
+        return std::move(mat);
+    }
+
+public:
+    //矩阵减法（两个操作数均为右值）：结果写入左操作数的数据
+    Matrix<T> operator-(Matrix<T> &&mat) &&
+    {
+        *this -= mat;
+        return std::move(*this);
+    }
+
+public:
+    //矩阵数乘（数在右）
+    Matrix<T> operator*(const T &c) const &
+    {
+        MATRIX_PROFILE_SCOPE("ScalarMultiply");
+        Matrix<T> r(uRow, uCol);
+        ElementWise(uRow * uCol, pData, r.pData, [c](const T &a)
+                    { return a * c; });
+        return r;
+    }
+
+public:
+    //右值矩阵数乘（数在右）：结果写入临时对象的数据
+    Matrix<T> operator*(const T &c) &&
+    {
+        *this *= c;
+        return std::move(*this);
+    }
+
+public:
+    //矩阵数乘（数在左）
+    template <typename E>
+    friend Matrix<E> operator*(const T &c, const Matrix<E> &mat);
+
+public:
+    //矩阵点乘
+    Matrix<T> operator*(const Matrix<T> &mat) const
+    {
+        MATRIX_PROFILE_SCOPE("Multiply");
+        assert(this->uCol == mat.uRow);
+
+        Matrix<T> r(this->uRow, mat.uCol);
+        if (!MatrixJobControl::InJob())
+        {
+            MatrixKernel<T>::Gemm(uRow, mat.uCol, uCol, T(1), pData, uCol, mat.pData, mat.uCol, T(0), r.pData, r.uCol);
+            return r;
+        }
+
+        //作业中按行块计算，每块约2^24次乘加且不少于线程数行，块之间为检查点
+        size_t rowWork = mat.uCol * (uCol > 0 ? uCol : 1);
+        size_t block = (size_t(1) << 24) / rowWork + 1;
+        if (block < MatrixThreadPool::ThreadCount())
+            block = MatrixThreadPool::ThreadCount();
+        for (size_t i0 = 0; i0 < uRow; i0 += block)
+        {
+            MatrixJobControl::Checkpoint(double(i0) / uRow);
+            size_t i1 = i0 + block < uRow ? i0 + block : uRow;
+            MatrixKernel<T>::Gemm(i1 - i0, mat.uCol, uCol, T(1), pData + i0 * uCol, uCol, mat.pData, mat.uCol,
+                                  T(0), r.pData + i0 * r.uCol, r.uCol);
+        }
+        return r;
+    }
+
+public:
+    /**
+     * @brief 在线程池的作业线程上计算矩阵乘积，见 MatrixJobControl
+     *
+     * 两个矩阵各被复制一次（定义 MATRIX_COPY_ON_WRITE 时共享数据）并移入作业中，调用者随后可以修改或销毁它们。
+     * 乘积按行块计算，每块之后报告进度并检查是否被取消。
+     *
+     * @param mat     右乘的矩阵
+     * @param control 作业控制对象
+     * @return std::future<Matrix<T>> 乘积矩阵
+     */
+    std::future<Matrix<T>> MultiplyAsync(const Matrix<T> &mat, MatrixJobControl control = MatrixJobControl()) const
+    {
+        assert(this->uCol == mat.uRow);
+        return control.Async([a = Matrix<T>(*this), b = Matrix<T>(mat)]
+                             { return a * b; });
+    }
+
+public:
+    /**
+     * @brief 开始一个延迟求值的连乘表达式
+     *
+     * 例如 Matrix<T> R = A.Lazy() * B * C; 或 Vector<T> y = A.Lazy() * B * C * x;
+     * 求值时按各因子的维度选取运算量最少的结合顺序，见 MatrixChain<T>。
+     * 左值矩阵只被引用，其生存期必须覆盖求值。
+     *
+     * @return MatrixChain<T> 以本矩阵为第一个因子的表达式
+     */
+    MatrixChain<T> Lazy() const &
+    {
+        return MatrixChain<T>(*this);
+    }
+
+    /**
+     * @brief 以右值矩阵开始延迟求值的连乘表达式，例如 (A + B).Lazy() * C
+     *
+     * 本矩阵被移入表达式中保存，不会在求值前析构。
+     *
+     * @return MatrixChain<T> 以本矩阵为第一个因子的表达式
+     */
+    MatrixChain<T> Lazy() &&
+    {
+        return MatrixChain<T>(Matrix<T>(std::move(*this)));
+    }
+
+public:
+    /**
+        @brief 指定算法的矩阵乘法
+
+        STRASSEN 模式递归地把乘积拆成7个子乘积，直到最小维度不大于cutoff后
+        交给分块GEMM，适用于数千阶以上的方阵；奇数维度补0处理，工作空间在调用时
+        一次性分配（约为结果矩阵的2/3到1倍大小，需补齐时另加三个矩阵）。
+
+        误差界（见Higham《Accuracy and Stability of Numerical Algorithms》第23章）：
+        经典算法逐元素满足 |C - Ĉ| ≤ γₖ|A||B|，γₖ ≈ k·u；
+        Winograd变体只有范数意义下的界，约为
+        ||C - Ĉ||ₘ ≤ [(n/n₀)^log₂18 · (n₀² + 6n₀) - 6n] · u · ||A||ₘ||B||ₘ，
+        其中 ||·||ₘ 为最大元素绝对值，n₀为截止维度，u为单位舍入误差。
+        每减少一层递归（增大cutoff一倍）误差界约缩小到1/18，但速度约降低1/8。
+        对元素数量级相差悬殊的矩阵，相对误差可能远大于经典算法。
+
+        @param mat      右乘的矩阵
+        @param mode     乘法算法
+        @param cutoff   STRASSEN 模式的递归截止维度
+        @return	        乘积矩阵
+    */
+    Matrix<T> Multiply(const Matrix<T> &mat, MultiplyMode mode = CLASSICAL, size_t cutoff = 512) const
+    {
+        if (mode == CLASSICAL)
+            return (*this) * mat;
+
+        MATRIX_PROFILE_SCOPE("MultiplyStrassen");
+        assert(this->uCol == mat.uRow);
+        Matrix<T> r(this->uRow, mat.uCol);
+        MatrixKernel<T>::Strassen(uRow, mat.uCol, uCol, pData, uCol, mat.pData, mat.uCol, r.pData, r.uCol, cutoff);
+        return r;
+    }
+
+public:
+    //矩阵原地加法，不分配内存
+    Matrix<T> &operator+=(const Matrix<T> &mat)
+    {
+        MATRIX_PROFILE_SCOPE("AddInPlace");
+        //同型检查
+        assert(Varify_Homo(*this, mat));
+
+        Detach();
+        ElementWise(uRow * uCol, pData, mat.pData, pData, [](const T &a, const T &b)
+                    { return a + b; });
+        return *this;
+    }
+
+public:
+    //矩阵原地减法，不分配内存
+    Matrix<T> &operator-=(const Matrix<T> &mat)
+    {
+        MATRIX_PROFILE_SCOPE("SubtractInPlace");
+        //同型检查
+        assert(Varify_Homo(*this, mat));
+
+        Detach();
+        ElementWise(uRow * uCol, pData, mat.pData, pData, [](const T &a, const T &b)
+                    { return a - b; });
+        return *this;
+    }
+
+public:
+    //矩阵原地数乘，不分配内存
+    Matrix<T> &operator*=(const T &c)
+    {
+        MATRIX_PROFILE_SCOPE("ScalarMultiplyInPlace");
+        Detach();
+        ElementWise(uRow * uCol, pData, pData, [c](const T &a)
+                    { return a * c; });
+        return *this;
+    }
+
+public:
+    //矩阵原地数除，不分配内存
+    Matrix<T> &operator/=(const T &c)
+    {
+        MATRIX_PROFILE_SCOPE("ScalarDivideInPlace");
+        Detach();
+        ElementWise(uRow * uCol, pData, pData, [c](const T &a)
+                    { return a / c; });
+        return *this;
+    }
+
+public:
+    /**
+        @brief 输出参数形式的矩阵乘法 C = αAB + βC
+
+        语义同BLAS的GEMM。β为0时C的原有内容被忽略，若C的形状与乘积不同，
+        则在容量足够时直接复用C的数据内存，否则重新分配；β不为0时C必须与乘积同型。
+        在迭代中重复使用同一个C时不再发生内存分配。C不得与A或B为同一对象。
+
+        @param C        结果矩阵
+        @param A        左矩阵
+        @param B        右矩阵
+        @param alpha    系数α
+        @param beta     系数β
+        @return         结果矩阵C的引用
+    */
+    static Matrix<T> &MultiplyInto(Matrix<T> &C, const Matrix<T> &A, const Matrix<T> &B,
+                                   const T &alpha = T(1), const T &beta = T(0))
+    {
+        MATRIX_PROFILE_SCOPE("MultiplyInto");
+        assert(A.uCol == B.uRow);
+        assert(&C != &A && &C != &B);
+
+        if (beta == T(0))
+            C.Reshape(A.uRow, B.uCol);
+        else
+        {
+            assert(C.uRow == A.uRow && C.uCol == B.uCol);
+            C.Detach();
+        }
+
+        MatrixKernel<T>::Gemm(A.uRow, B.uCol, A.uCol, alpha, A.pData, A.uCol, B.pData, B.uCol, beta, C.pData, C.uCol);
+        return C;
+    }
+
+public:
+    /**
+     * @brief Kronecker积 A⊗B
+     *
+     * 结果为 (mp)×(nq) 矩阵，第 (i, j) 块为 A(i, j)·B。只分配一次，按结果的行并行，
+     * 每行由n段 A(i, j)·B的一行 组成，内层循环是连续的数乘拷贝。
+     *
+     * @param A m×n矩阵
+     * @param B p×q矩阵
+     * @return Matrix<T> A⊗B
+     */
+    static Matrix<T> Kronecker(const Matrix<T> &A, const Matrix<T> &B)
+    {
+        MATRIX_PROFILE_SCOPE("Kronecker");
+        size_t n = A.uCol, p = B.uRow, q = B.uCol;
+        Matrix<T> r(A.uRow * p, n * q);
+        MATRIX_PROFILE_EVENT(RecordFlops(r.uRow * r.uCol));
+        size_t cols = r.uCol;
+        const T *pa = A.pData, *pb = B.pData;
+        T *pr = r.pData;
+        MatrixThreadPool::ParallelFor(0, r.uRow, uParallelGrain / (cols > 0 ? cols : 1) + 1, [=](size_t b, size_t e)
+                                      {
+                                          for (size_t row = b; row < e; ++row)
+                                          {
+                                              const T *ai = pa + row / p * n;
+                                              const T *MATRIX_RESTRICT bk = pb + row % p * q;
+                                              for (size_t j = 0; j < n; ++j)
+                                              {
+                                                  T a = ai[j];
+                                                  T *MATRIX_RESTRICT dst = pr + row * cols + j * q;
+                                                  for (size_t l = 0; l < q; ++l)
+                                                      dst[l] = a * bk[l];
+                                              }
+                                          }
+                                      });
+        return r;
+    }
+
+public:
+    /**
+     * @brief 外积 uvᵀ
+     *
+     * v不取共轭，复数向量需要 uvᴴ 时先对v取共轭。
+     *
+     * @param u 长度为m的向量或视图
+     * @param v 长度为n的向量或视图
+     * @return Matrix<T> m×n矩阵，r(i, j) = uᵢvⱼ
+     */
+    static Matrix<T> Outer(VectorView<const T> u, VectorView<const T> v)
+    {
+        MATRIX_PROFILE_SCOPE("Outer");
+        size_t m = u.Size(), n = v.Size();
+        Matrix<T> r(m, n);
+        MATRIX_PROFILE_EVENT(RecordFlops(m * n));
+        //v连续时直接读取，否则先复制
+        std::vector<T> vBuf;
+        const T *pv = v.Data();
+        if (v.Stride() != 1)
+        {
+            vBuf.resize(n);
+            for (size_t j = 0; j < n; ++j)
+                vBuf[j] = v[j];
+            pv = vBuf.data();
+        }
+        T *pr = r.pData;
+        MatrixThreadPool::ParallelFor(0, m, uParallelGrain / (n > 0 ? n : 1) + 1, [=](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                          {
+                                              T ui = u[i];
+                                              const T *MATRIX_RESTRICT src = pv;
+                                              T *MATRIX_RESTRICT dst = pr + i * n;
+                                              for (size_t j = 0; j < n; ++j)
+                                                  dst[j] = ui * src[j];
+                                          }
+                                      });
+        return r;
+    }
+
+public:
+    /**
+     * @brief Hadamard积（逐元素乘积）A∘B
+     *
+     * 只分配一次，元素较多时并行。
+     *
+     * @param A 矩阵
+     * @param B 与A同型的矩阵
+     * @return Matrix<T> r(i, j) = A(i, j)·B(i, j)
+     */
+    static Matrix<T> Hadamard(const Matrix<T> &A, const Matrix<T> &B)
+    {
+        MATRIX_PROFILE_SCOPE("Hadamard");
+        assert(Varify_Homo(A, B));
+        Matrix<T> r(A.uRow, A.uCol);
+        ElementWise(A.uRow * A.uCol, A.pData, B.pData, r.pData, [](const T &a, const T &b)
+                    { return a * b; });
+        return r;
+    }
+
+public:
+    //Hadamard积（左操作数为右值）：结果写入A的数据，不分配内存
+    static Matrix<T> Hadamard(Matrix<T> &&A, const Matrix<T> &B)
+    {
+        MATRIX_PROFILE_SCOPE("Hadamard");
+        assert(Varify_Homo(A, B));
+        A.Detach();
+        ElementWise(A.uRow * A.uCol, A.pData, B.pData, A.pData, [](const T &a, const T &b)
+                    { return a * b; });
+        return std::move(A);
+    }
+
+public:
+    /**
+     * @brief 逐元素除法 A⊘B
+     *
+     * @param A 矩阵
+     * @param B 与A同型的矩阵
+     * @return Matrix<T> r(i, j) = A(i, j) / B(i, j)
+     */
+    static Matrix<T> HadamardDivide(const Matrix<T> &A, const Matrix<T> &B)
+    {
+        MATRIX_PROFILE_SCOPE("HadamardDivide");
+        assert(Varify_Homo(A, B));
+        Matrix<T> r(A.uRow, A.uCol);
+        ElementWise(A.uRow * A.uCol, A.pData, B.pData, r.pData, [](const T &a, const T &b)
+                    { return a / b; });
+        return r;
+    }
+
+public:
+    //逐元素除法（左操作数为右值）：结果写入A的数据，不分配内存
+    static Matrix<T> HadamardDivide(Matrix<T> &&A, const Matrix<T> &B)
+    {
+        MATRIX_PROFILE_SCOPE("HadamardDivide");
+        assert(Varify_Homo(A, B));
+        A.Detach();
+        ElementWise(A.uRow * A.uCol, A.pData, B.pData, A.pData, [](const T &a, const T &b)
+                    { return a / b; });
+        return std::move(A);
+    }
+
+private:
+    //r[i] = op(a[i], b[i])，按 uParallelGrain 分段并行。r可以与a为同一数组
+    template <typename Op>
+    static void ElementWise(size_t n, const T *a, const T *b, T *r, Op op)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(n));
+        MatrixThreadPool::ParallelFor(0, n, uParallelGrain, [=](size_t s, size_t e)
+                                      {
+                                          const T *pb = b;
+                                          for (size_t i = s; i < e; ++i)
+                                              r[i] = op(a[i], pb[i]);
+                                      });
+    }
+
+    //r[i] = op(a[i])，按 uParallelGrain 分段并行。r可以与a为同一数组
+    template <typename Op>
+    static void ElementWise(size_t n, const T *a, T *r, Op op)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(n));
+        MatrixThreadPool::ParallelFor(0, n, uParallelGrain, [=](size_t s, size_t e)
+                                      {
+                                          for (size_t i = s; i < e; ++i)
+                                              r[i] = op(a[i]);
+                                      });
+    }
+
+private:
+    /**
+        @brief 改变矩阵形状，不保留原有数据
+
+        容量足够且数据未被共享时复用现有内存，否则按新大小重新分配。
+
+        @param row 新的行数
+        @param col 新的列数
+    */
+    void Reshape(size_t row, size_t col)
+    {
+        if (row * col > uCapacity || pData == nullptr || UseCount() > 1)
+        {
+            ReleaseData();
+            uCapacity = uCapacityIncrement * row * col;
+            pData = AllocData(uCapacity, row, col);
+        }
+        uRow = row;
+        uCol = col;
+    }
+
+private:
+    /**
+        @brief 矩阵初等变换：行交换：交换两行的数据。
+
+        使用初等变换函数相比左乘变换方阵更加高效
+
+        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
+        否则从1开始。
+
+        @param RowIndex1	第一个行序号
+        @param RowIndex2	第二个行序号
+    */
+    void RowInterchange(size_t RowIndex1, size_t RowIndex2)
+    {
+        assert(RowIndex1 <= uRow && RowIndex2 <= uRow);
+
+        T *pRow1Head = &ElemAt(RowIndex1, 1);
+        T *pRow2Head = &ElemAt(RowIndex2, 1);
+        T tmp;
+        for (size_t i = 0; i < uCol; ++i)
+        {
+            tmp = pRow1Head[i];
+            pRow1Head[i] = pRow2Head[i];
+            pRow2Head[i] = tmp;
+        }
+    }
+
+private:
+    /**
+        @brief 矩阵初等变换：倍乘行：将目标行乘以k倍。
+        
+        使用初等变换函数相比左乘变换方阵更加高效
+
+        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
+        否则从1开始。
+
+        @param RowIndex	目标行序号
+        @param k		系数，不可为0
+    */
+    void RowScaling(size_t RowIndex, const T &k)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(uCol));
+        assert(RowIndex <= uRow && k != T(0));
+
+        T *pRowHead = &ElemAt(RowIndex, 1);
+        for (size_t i = 0; i < uCol; ++i)
+            pRowHead[i] *= k;
+    }
+
+private:
+    /**
+        @brief 矩阵初等变换：倍加行：将源行各数据乘以系数加到目标行对应数据。
+        
+        使用初等变换函数相比左乘变换方阵更加高效.
+        
+        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
+        否则从1开始。
+        
+        @param SrcRowIndex	源行序号
+        @param k			系数，可以为0
+        @param TagRowIndex	目标行序号
+    */
+    void RowAddition(size_t SrcRowIndex, const T &k, size_t TrgRowIndex)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * uCol));
+        assert(SrcRowIndex <= uRow && TrgRowIndex <= uRow);
+
+        T *pSrcRowHead = &ElemAt(SrcRowIndex, 1);
+        T *pTrgRowHead = &ElemAt(TrgRowIndex, 1);
+
+        for (size_t i = 0; i < uCol; ++i)
+            pTrgRowHead[i] += k * pSrcRowHead[i];
+    }
+
+public:
+    /**
+        @brief 清除某一行的数据
+
+        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
+        否则从1开始。
+
+        @param RowIndex	要清除的行序号
+    */
+    void ClearRow(size_t RowIndex)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        ++RowIndex;
+#endif
+        assert(RowIndex <= uRow);
+
+        T *pRowHead = &ElemAt(RowIndex, 1);
+        for (size_t i = 0; i < uCol; ++i)
+            pRowHead[i] = T(0);
+    }
+
+public:
+    /**
+        @brief 清除某一列的数据
+
+        若定义了MATRIX_INDEX_START_AT_0,则列序号从0开始，
+        否则从1开始。
+
+        @param ColIndex	要清除的列序号
+    */
+    void ClearColumn(size_t ColIndex)
+    {
+#ifdef MATRIX_INDEX_START_AT_0
+        ++ColIndex;
+#endif
+        assert(ColIndex <= uCol);
+
+        T *pColHead = &ElemAt(1, ColIndex);
+        for (size_t i = 0; i < uRow; ++i)
+            pColHead[i * uCol] = T(0);
+    }
+
+public:
+    /**
+        @brief 矩阵求幂
+
+        @param n	幂阶数
+        @return		矩阵的n次幂矩阵
+    */
+    Matrix<T> Power(size_t n) const
+    {
+        MATRIX_PROFILE_SCOPE("Power");
+        assert(uRow == uCol);
+
+        Matrix<T> r(uRow, uCol);
+        for (size_t i = 1; i <= uRow; ++i)
+            r.ElemAt(i, i) = T(1);
+
+        for (size_t i = 0; i < n; ++i)
+            r = r * (*this);
+
+        return r;
+    }
+
+public:
+    /**
+        @brief 矩阵转置
+        @return	矩阵的转置矩阵
+    */
+    Matrix<T> Transpose() const
+    {
+        MATRIX_PROFILE_SCOPE("Transpose");
+        Matrix<T> r(this->uCol, this->uRow);
+        for (size_t i = 1; i <= r.uRow; ++i)
+            for (size_t j = 1; j <= r.uCol; ++j)
+                r.ElemAt(i, j) = this->ElementAt(j, i);
+        return r;
+    }
+
+public:
+    /**
+        @brief 共轭转置 Aᴴ
+
+        实数元素时与 Transpose() 相同
+        @return	矩阵的共轭转置矩阵
+    */
+    Matrix<T> Adjoint() const
+    {
+        MATRIX_PROFILE_SCOPE("Adjoint");
+        Matrix<T> r(uCol, uRow);
+        T *pr = r.pData;
+        for (size_t i = 0; i < uRow; ++i)
+            for (size_t j = 0; j < uCol; ++j)
+                pr[j * uRow + i] = MatrixScalar<T>::Conj(pData[i * uCol + j]);
+        return r;
+    }
+
+public:
+    /**
+        @brief 余子式矩阵
+        @param m	元素所在的行数
+        @param n	元素所在的列数
+        @return		若为方阵，返回第m行第n列元素的余子式矩阵；否则返回空矩阵
+    */
+    Matrix<T> MinorOf(size_t m, size_t n) const
+    {
+        MATRIX_PROFILE_SCOPE("MinorOf");
+        assert(uRow == uCol);
+
+        Matrix<T> r(this->uRow - 1, this->uCol - 1);
+        size_t index = 0;
+        for (size_t i = 1; i <= uRow; ++i)
+            for (size_t j = 1; j <= uCol; ++j)
+                if (i != m && j != n)
+                    r.pData[index++] = this->ElementAt(i, j);
+        return r;
+    }
+
+public:
+    /**
+        @brief 行约化矩阵
+
+        使用分块右视高斯消元（按列绝对值最大选主元，尾部矩阵以并行GEMM更新）
+        化为行阶梯形，再分块回代得到行最简形。绝对值不大于
+        max(行数, 列数) · ε · ||A||∞ 的主元视为0。
+
+        整数类型使用分数无关消元（BareissElimination），返回行最简形的最小整数倍，
+        行最简形本身为整数矩阵时即为行最简形，倍数由 RowReduce(denominator) 给出。
+
+        @return		矩阵的行约化结果矩阵
+    */
+    Matrix<T> RowReduce() const
+    {
+        T denominator;
+        return RowReduce(denominator);
+    }
+
+public:
+    /**
+        @brief 行约化矩阵，并给出公分母
+
+        行最简形 = 返回的矩阵 / denominator。非整数类型的denominator总为1
+
+        @param denominator	输出：公分母
+        @return		行最简形的分子
+    */
+    Matrix<T> RowReduce(T &denominator) const
+    {
+        MATRIX_PROFILE_SCOPE("RowReduce");
+        return RowReduceImpl(denominator, IsInteger());
+    }
+
+private:
+    //按元素类型分派：整数类型（std::numeric_limits<T>::is_integer）使用分数无关消元
+    typedef std::integral_constant<bool, std::numeric_limits<T>::is_integer> IsInteger;
+
+    Matrix<T> RowReduceImpl(T &denominator, std::true_type) const
+    {
+        return BareissElimination<T>(*this).ReducedEchelon(denominator);
+    }
+
+    Matrix<T> RowReduceImpl(T &denominator, std::false_type) const
+    {
+        denominator = T(1);
+        std::vector<size_t> pivCols;
+        return RowReduce(pivCols);
+    }
+
+private:
+    /**
+     * @brief 行约化矩阵，并输出主元列
+     *
+     * @param pivCols   输出：各主元所在的列（从0开始）
+     * @return Matrix<T> 行最简形
+     */
+    Matrix<T> RowReduce(std::vector<size_t> &pivCols) const
+    {
+        Matrix<T> r(*this);
+        r.Detach();
+        std::vector<size_t> swaps;
+        {
+            MatrixJobControl::Phase phase(0.0, 0.6);
+            MatrixKernel<T>::Eliminate(r.pData, uRow, uCol, uCol, EliminationTolerance(), true, pivCols, swaps);
+        }
+        MatrixJobControl::Phase phase(0.6, 1.0);
+        MatrixKernel<T>::ReduceEchelon(r.pData, uRow, uCol, uCol, pivCols);
+        return r;
+    }
+
+private:
+    //消元时判定主元为0的阈值（与MATLAB的rref相同）：max(行数, 列数) · ε · ||A||∞
+    typename MatrixScalar<T>::Real EliminationTolerance() const
+    {
+        typedef typename MatrixScalar<T>::Real R;
+        return R(uRow > uCol ? uRow : uCol) * std::numeric_limits<R>::epsilon() * NormInf();
+    }
+
+public:
+    /**
+        @brief 矩阵求秩
+
+        浮点类型使用列选主元QR分解（PivotedQRDecomposition），剩余子块的Frobenius范数
+        不大于 tol·||A||F 时停止，已完成的步数即为数值秩；整数类型的结果精确，内置整数类型
+        使用多模消元（ModularElimination），其它整数类型使用分数无关消元（BareissElimination）；
+        其他类型只进行分块消元的前向部分，主元个数即为秩
+        @param tol 相对容限，为负时使用 max(m, n)·ε，只对浮点类型有效
+        @return	矩阵的秩
+    */
+    size_t Rank(T tol = T(-1)) const
+    {
+        MATRIX_PROFILE_SCOPE("Rank");
+        return RankImpl(tol, std::is_floating_point<T>());
+    }
+
+public:
+    /**
+        @brief 判断当前矩阵是否可逆
+
+        与 Inverse() 使用同一判据：非整数类型以相同的消元判断主元是否为0，返回true时
+        Inverse() 一定返回逆矩阵。该判据可能与 Rank() 的列选主元QR不一致；
+        整数类型判断精确的秩
+        @return	若可逆，返回true；否则返回false
+    */
+    bool Invertible() const
+    {
+        if (this->uRow != this->uCol)
+            return false;
+        return InvertibleImpl(IsInteger());
+    }
+
+private:
+    size_t RankImpl(T tol, std::true_type) const
+    {
+        return PivotedQRDecomposition<T>(*this, tol).Rank();
+    }
+
+    size_t RankImpl(T, std::false_type) const
+    {
+        return EliminationRank(IsInteger());
+    }
+
+    //内置整数类型以多模消元避免中间结果溢出，大整数类型使用分数无关消元
+    size_t EliminationRank(std::true_type) const
+    {
+        if (std::is_integral<T>::value)
+            return ModularElimination<T>::ExactRank(*this);
+        return BareissElimination<T>(*this).Rank();
+    }
+
+    //stopAtZeroColumn 为true时在第一个零主元列处返回，此时结果只用于判断是否满列秩
+    size_t EliminationRank(std::false_type, bool stopAtZeroColumn = false) const
+    {
+        Matrix<T> r(*this);
+        r.Detach();
+        std::vector<size_t> pivCols, swaps;
+        return MatrixKernel<T>::Eliminate(r.pData, uRow, uCol, uCol, EliminationTolerance(), true, pivCols, swaps,
+                                          stopAtZeroColumn);
+    }
+
+public:
+    /**
+        @brief 矩阵求逆
+
+        整数类型的结果精确（内置整数类型使用多模消元，其它整数类型使用分数无关消元），
+        逆矩阵只在行列式为±1时是整数矩阵，其它情况请使用 Inverse(denominator)
+        @return 若矩阵可逆，返回逆矩阵；否则返回空矩阵
+    */
+    Matrix<T> Inverse() const
+    {
+        MATRIX_PROFILE_SCOPE("Inverse");
+        //判断是否为方阵
+        assert(uRow == uCol);
+        return InverseImpl(IsInteger());
+    }
+
+public:
+    /**
+        @brief 矩阵求逆，并给出公分母
+
+        逆矩阵 = 返回的矩阵 / denominator。整数类型的结果精确且已约分，内置整数类型
+        只要求结果的元素能用T表示；非整数类型的denominator总为1。矩阵奇异时返回空矩阵
+        @param denominator	输出：公分母
+        @return 逆矩阵的分子
+    */
+    Matrix<T> Inverse(T &denominator) const
+    {
+        MATRIX_PROFILE_SCOPE("Inverse");
+        assert(uRow == uCol);
+        return InverseImpl(denominator, IsInteger());
+    }
+
+public:
+    /**
+     * @brief 在线程池的作业线程上求逆，见 Inverse() 与 MatrixJobControl
+     *
+     * 矩阵被复制一次（定义 MATRIX_COPY_ON_WRITE 时共享数据）并移入作业中，调用者随后可以修改或销毁本矩阵。
+     * 非整数类型在消元的每个面板与回代的每个块之后报告进度并检查是否被取消；
+     * 整数类型的精确求逆只在开始前检查。
+     *
+     * @param control 作业控制对象
+     * @return std::future<Matrix<T>> 逆矩阵
+     */
+    std::future<Matrix<T>> InverseAsync(MatrixJobControl control = MatrixJobControl()) const
+    {
+        assert(uRow == uCol);
+        return control.Async([a = Matrix<T>(*this)]
+                             { return a.Inverse(); });
+    }
+
+    /**
+     * @brief 在线程池的作业线程上计算行最简形，见 RowReduce() 与 InverseAsync()
+     *
+     * @param control 作业控制对象
+     * @return std::future<Matrix<T>> 行最简形
+     */
+    std::future<Matrix<T>> RowReduceAsync(MatrixJobControl control = MatrixJobControl()) const
+    {
+        return control.Async([a = Matrix<T>(*this)]
+                             { return a.RowReduce(); });
+    }
+
+    /**
+     * @brief 在线程池的作业线程上进行LU分解，每个消元面板之后报告进度并检查是否被取消
+     *
+     * @param control 作业控制对象
+     * @return std::future<LUDecomposition<T>> 分解结果
+     */
+    std::future<LUDecomposition<T>> LUAsync(MatrixJobControl control = MatrixJobControl()) const
+    {
+        assert(uRow == uCol);
+        return control.Async([a = Matrix<T>(*this)]
+                             { return LUDecomposition<T>(a); });
+    }
+
+    /**
+     * @brief 在线程池的作业线程上进行Cholesky分解，每64行报告进度并检查是否被取消
+     *
+     * 其它分解（QR、特征值、奇异值分解）可以用 MatrixJobControl::Async() 提交，只在开始前检查是否被取消。
+     *
+     * @param control 作业控制对象
+     * @return std::future<CholeskyDecomposition<T>> 分解结果
+     */
+    std::future<CholeskyDecomposition<T>> CholeskyAsync(MatrixJobControl control = MatrixJobControl()) const
+    {
+        assert(uRow == uCol);
+        return control.Async([a = Matrix<T>(*this)]
+                             { return CholeskyDecomposition<T>(a); });
+    }
+
+public:
+    /**
+        @brief 伴随矩阵 adj(A)，满足 A·adj(A) = det(A)·I
+
+        整数类型的结果精确，内置整数类型使用多模消元，其它整数类型使用分数无关消元；其它类型非奇异时为 det(A)·A⁻¹，奇异时逐个计算代数余子式
+        @return 伴随矩阵
+    */
+    Matrix<T> Adjugate() const
+    {
+        assert(uRow == uCol);
+        return AdjugateImpl(IsInteger());
+    }
+
+private:
+    Matrix<T> InverseImpl(std::true_type) const
+    {
+        T denominator;
+        Matrix<T> r = InverseImpl(denominator, std::true_type());
+        //奇异（denominator为0）或逆矩阵不是整数矩阵
+        if (denominator != T(1))
+        {
+            assert(0);
+            return Matrix<T>();
+        }
+        return r;
+    }
+
+    //内置整数类型以多模消元避免中间结果溢出，大整数类型使用分数无关消元
+    Matrix<T> InverseImpl(T &denominator, std::true_type) const
+    {
+        if (std::is_integral<T>::value)
+            return ModularElimination<T>::ExactInverse(*this, denominator);
+        BareissElimination<T> be(*this);
+        if (be.Rank() < uRow)
+        {
+            assert(0);
+            denominator = T(0);
+            return Matrix<T>();
+        }
+        return be.Inverse(denominator);
+    }
+
+    Matrix<T> InverseImpl(T &denominator, std::false_type) const
+    {
+        denominator = T(1);
+        return InverseImpl(std::false_type());
+    }
+
+    Matrix<T> AdjugateImpl(std::true_type) const
+    {
+        if (std::is_integral<T>::value)
+            return ModularElimination<T>::ExactAdjugate(*this);
+        return BareissElimination<T>(*this).Adjugate();
+    }
+
+    Matrix<T> AdjugateImpl(std::false_type) const
+    {
+        LUDecomposition<T> lu(*this);
+        if (lu.IsSingular())
+            return BareissElimination<T>(*this).Adjugate();
+        return lu.Inverse() * lu.Determinant();
+    }
+
+    Matrix<T> InverseImpl(std::false_type) const
+    {
+        Matrix<T> combined;
+        std::vector<size_t> pivCols;
+        {
+            MatrixJobControl::Phase phase(0.0, 0.6);
+            if (!EliminateWithIdentity(combined, pivCols))
+            {
+                assert(0);
+                return Matrix<T>();
+            }
+        }
+        MatrixJobControl::Phase phase(0.6, 1.0);
+        MatrixKernel<T>::ReduceEchelon(combined.pData, uRow, 2 * uRow, 2 * uRow, pivCols);
+
+        //将右侧部分分割并返回
+        return combined.ColumnSplit(this->uCol + 1, RIGHT);
+    }
+
+    /**
+     * @brief 把单位阵合并在矩阵右侧并前向消元，供 Inverse() 使用
+     *
+     * 主元阈值取自本矩阵的 EliminationTolerance()，不受右侧单位阵影响。右侧各列不影响
+     * 左侧主元的选取，因此判据与 Invertible() 只对本矩阵消元的结果相同。
+     *
+     * @param combined 输出：消元后的 [A | I]
+     * @param pivCols  输出：主元列
+     * @return bool    左侧每一列都是主元列（可逆）时返回true
+     */
+    bool EliminateWithIdentity(Matrix<T> &combined, std::vector<size_t> &pivCols) const
+    {
+        //生成单位矩阵
+        Matrix<T> E(uRow, uRow);
+        for (size_t i = 1; i <= E.uRow; ++i)
+            E.ElemAt(i, i) = T(1);
+        combined = this->CombineWith(E, RIGHT);
+        std::vector<size_t> swaps;
+        MatrixKernel<T>::Eliminate(combined.pData, uRow, 2 * uRow, 2 * uRow, EliminationTolerance(), true, pivCols, swaps);
+        return uRow == 0 || (pivCols.size() >= uRow && pivCols[uRow - 1] == uRow - 1);
+    }
+
+    //整数类型的逆是精确的，满秩即可逆
+    bool InvertibleImpl(std::true_type) const
+    {
+        return Rank() == uRow;
+    }
+
+    //与 EliminateWithIdentity() 的左侧消元相同，但不合并单位阵，遇到零主元列即返回
+    bool InvertibleImpl(std::false_type) const
+    {
+        return EliminationRank(std::false_type(), true) == uRow;
+    }
+
+public:
+    /**
+     * @brief 基于奇异值分解的Moore-Penrose伪逆
+     *
+     * 适用于任意形状与秩亏的矩阵，不大于 max(m, n)·ε·σ₁ 的奇异值视为0。
+     *
+     * @return Matrix<T> n×m伪逆矩阵
+     */
+    Matrix<T> PseudoInverse() const
+    {
+        return SingularValueDecomposition<T>(*this).PseudoInverse();
+    }
+
+public:
+    /**
+     * @brief 转换矩阵的元素类型
+     *
+     * 例如 Matrix<float> f = mat.Cast<float>();
+     *
+     * @tparam U 目标元素类型
+     * @return Matrix<U> 逐元素转换后的矩阵
+     */
+    template <typename U>
+    Matrix<U> Cast() const
+    {
+        return Matrix<U>(*this);
+    }
+
+public:
+    /**
+     *  @brief 矩阵输出为字符串
+     *  @return 矩阵流输出的字符串
+     */
+    std::string toString()
+    {
+        std::stringstream s;
+        s << *this;
+        return s.str();
+    }
+
+public:
+    /**
+     * @brief 生成一个全0矩阵
+     * 
+     * @param size 矩阵的阶数
+     * @return Matrix<T> size * size 大小的全0矩阵
+     */
+    static Matrix<T> Zeroes(size_t size)
+    {
+        return Matrix<T>(size, size, T(0));
+    }
+
+public:
+    /**
+     * @brief 生成一个单位矩阵
+     * 
+     * @param size 矩阵的阶数
+     * @return Matrix<T> size * size 大小的单位矩阵
+     */
+    static Matrix<T> Identity(size_t size)
+    {
+        Matrix<T> &&mat = Zeroes(size);
+        for (size_t i = 1; i <= size; ++i)
+            mat.ElemAt(i, i) = T(1);
+        return mat;
+    }
+
+public:
+    /**
+     * @brief 生成一个全1矩阵
+     * 
+     * @param size 矩阵的阶数
+     * @return Matrix<T> size * size 大小的全1矩阵
+     */
+    static Matrix<T> Ones(size_t size)
+    {
+        return Matrix<T>(size, size, T(1));
+    }
+
+public:
+    /**
+     * @brief 以[lo, hi)上的均匀分布随机数原地填充矩阵
+     *
+     * 使用Philox计数器随机数并行填充，结果只由种子决定，与线程数无关。
+     * 不指定种子时从 MatrixRandom 的全局种子序列中取得，调用 MatrixRandom::Seed()
+     * 后可复现。要求double类型可以转换到T类型。复数元素的实部与虚部分别独立取值。
+     * 转换到精度较低的类型（如float、Half）时舍入到hi的取值改为小于hi的最大值。
+     *
+     * @param lo    下界
+     * @param hi    上界
+     * @param seed  种子
+     * @return Matrix<T>& 本对象的引用
+     */
+    Matrix<T> &FillUniform(double lo = 0.0, double hi = 1.0, uint64_t seed = MatrixRandom::NextSeed())
+    {
+        MATRIX_PROFILE_SCOPE("FillUniform");
+        double width = hi - lo;
+        Real upper = static_cast<Real>(hi), top = LargestBelow(lo, hi);
+        bool clamp = static_cast<Real>(lo) < upper;
+        FillRandom(seed, [=](const uint32_t r[4], Real *dst, size_t count)
+                   {
+                       for (size_t h = 0; h < count; ++h)
+                       {
+                           Real v = static_cast<Real>(lo + width * MatrixRandom::ToUniform(r[2 * h], r[2 * h + 1]));
+                           dst[h] = !clamp || v < upper ? v : top;
+                       }
+                   });
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 以正态分布随机数原地填充矩阵
+     *
+     * 每两个相邻元素由同一组Philox输出经Box-Muller变换得到，
+     * 其余约定同 FillUniform()。
+     *
+     * @param mean      均值
+     * @param stddev    标准差
+     * @param seed      种子
+     * @return Matrix<T>& 本对象的引用
+     */
+    Matrix<T> &FillNormal(double mean = 0.0, double stddev = 1.0, uint64_t seed = MatrixRandom::NextSeed())
+    {
+        MATRIX_PROFILE_SCOPE("FillNormal");
+        FillRandom(seed, [=](const uint32_t r[4], Real *dst, size_t count)
+                   {
+                       //1 - u 在(0, 1]上，避免对0取对数
+                       double radius = std::sqrt(-2.0 * std::log(1.0 - MatrixRandom::ToUniform(r[0], r[1])));
+                       double theta = 6.283185307179586 * MatrixRandom::ToUniform(r[2], r[3]);
+                       dst[0] = static_cast<Real>(mean + stddev * radius * std::cos(theta));
+                       if (count > 1)
+                           dst[1] = static_cast<Real>(mean + stddev * radius * std::sin(theta));
+                   });
+        return *this;
+    }
+
+public:
+    /**
+     * @brief 以[lo, hi]上均匀分布的随机整数原地填充矩阵
+     *
+     * 由64位随机数取模得到，偏差不超过 (hi - lo + 1) / 2⁶⁴。
+     * 其余约定同 FillUniform()，要求long long类型可以转换到T类型。
+     *
+     * @param lo    下界（包含）
+     * @param hi    上界（包含）
+     * @param seed  种子
+     * @return Matrix<T>& 本对象的引用
+     */
+    Matrix<T> &FillInteger(long long lo, long long hi, uint64_t seed = MatrixRandom::NextSeed())
+    {
+        MATRIX_PROFILE_SCOPE("FillInteger");
+        assert(lo <= hi);
+        //区间长度为2⁶⁴时range为0，此时不取模
+        uint64_t range = uint64_t(hi) - uint64_t(lo) + 1;
+        FillRandom(seed, [=](const uint32_t r[4], Real *dst, size_t count)
+                   {
+                       for (size_t h = 0; h < count; ++h)
+                       {
+                           uint64_t v = (uint64_t(r[2 * h]) << 32) | r[2 * h + 1];
+                           if (range != 0)
+                               v %= range;
+                           dst[h] = static_cast<Real>(static_cast<long long>(uint64_t(lo) + v));
+                       }
+                   });
+        return *this;
+    }
+
+private:
+    /**
+     * @brief 并行随机填充的公共部分
+     *
+     * 第k组Philox输出（计数器为k）对应第2k与2k+1个元素，按组并行。
+     * 复数矩阵视为实部与虚部交替存放的实数数组填充。
+     *
+     * @param seed  种子
+     * @param gen   由一组输出生成元素的函数 gen(r[4], dst, count)，count为1或2
+     */
+    template <typename Gen>
+    void FillRandom(uint64_t seed, const Gen &gen)
+    {
+        size_t n = uRow * uCol * MatrixScalar<T>::uParts;
+        Detach();
+        Real *data = reinterpret_cast<Real *>(pData);
+        MatrixThreadPool::ParallelFor(0, (n + 1) / 2, 4096, [&](size_t b, size_t e)
+                                      {
+                                          uint32_t r[4];
+                                          for (size_t k = b; k < e; ++k)
+                                          {
+                                              MatrixRandom::Philox(seed, k, r);
+                                              gen(r, data + 2 * k, 2 * k + 1 < n ? 2 : 1);
+                                          }
+                                      });
+    }
+
+    //[lo, hi)中转换到Real后小于Real(hi)的最大值，对double二分求得；区间为空时返回Real(lo)
+    static Real LargestBelow(double lo, double hi)
+    {
+        Real upper = static_cast<Real>(hi);
+        if (!(static_cast<Real>(lo) < upper))
+            return static_cast<Real>(lo);
+        double a = lo, b = hi;
+        for (int i = 0; i < 2200; ++i)
+        {
+            double m = a + (b - a) / 2;
+            if (m <= a || m >= b)
+                break;
+            (static_cast<Real>(m) < upper ? a : b) = m;
+        }
+        return static_cast<Real>(a);
+    }
+
+public:
+    /**
+     * @brief 生成一个随机元素矩阵
+     * 
+     * 矩阵的元素在0~1之间随机取值，该函数要求double类型可以转换到模板参数T类型。
+     * 不指定种子时从全局种子序列取得，见 FillUniform()
+     * 
+     * @param rows  行数
+     * @param cols  列数
+     * @param seed  种子
+     * @return Matrix<T> rows * cols 大小的随机矩阵
+     */
+    static Matrix<T> Rand(size_t rows, size_t cols, uint64_t seed = MatrixRandom::NextSeed())
+    {
+        MATRIX_PROFILE_SCOPE("Rand");
+        Matrix<T> mat(rows, cols);
+        mat.FillUniform(0.0, 1.0, seed);
+        return mat;
+    }
+
+public:
+    /**
+     * @brief 生成一个随机元素矩阵
+     * 
+     * 矩阵的元素在0~1之间随机取值，该函数要求double类型可以转换到模板参数T类型
+     * 
+     * @param size  阶数
+     * @return Matrix<T> size * size 大小的随机方阵
+     */
+    static Matrix<T> Rand(size_t size)
+    {
+        return Matrix<T>::Rand(size, size);
+    }
+};
+
+/**
+    @brief 矩阵流输出运算符重载
+
+    要求矩阵数据T类已重载流输出运算符，复数元素以 a+bi 的形式输出。
+    每个元素保留4位有效数字，输出可以由字符串构造函数解析，但不能精确还原矩阵
+*/
+#include <iomanip>
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const Matrix<T> &mat)
+{
+    T *pRowHead = mat.pData;
+    os << "[\n";
+    for (size_t i = 1; i <= mat.uRow; ++i)
+    {
+        for (size_t j = 0; j < mat.uCol; ++j)
+        {
+            os << std::setw(12) << std::setfill(' ') << std::setprecision(4);
+            MatrixScalar<T>::Print(os, pRowHead[j]);
+        }
+        os << ";\n";
+        pRowHead += mat.uCol;
+    }
+    os << "]\n";
+    return os;
+}
+
+/**
+    矩阵数乘（数在左）：
+    返回数左乘矩阵的结果
+*/
+template <typename T>
+inline Matrix<T> operator*(const T &c, const Matrix<T> &mat)
+{
+    return mat * c;
+}
+
+/**
+    右值矩阵数乘（数在左）：
+    结果写入临时矩阵的数据并返回
+*/
+template <typename T>
+inline Matrix<T> operator*(const T &c, Matrix<T> &&mat)
+{
+    return std::move(mat) * c;
+}
+
+/**
+ * @brief 向量类
+ *
+ * 连续存储的稠密列向量，元素下标从0开始。可隐式转换为 VectorView<T>，
+ * 因此矩阵的行、列视图与向量可以混合参与 Dot、Axpy、Gemv 等运算。
+ * 矩阵向量乘法不构造 n×1 矩阵，直接调用 MatrixKernel 的 GEMV 内核。
+ *
+ * @tparam T 元素类型
+ */
+template <typename T>
+class Vector
+{
+private:
+    std::vector<T> data; //向量数据
+
+public:
+    /**
+     * @brief 构造指定长度的零向量
+     *
+     * @param size 向量长度
+     */
+    explicit Vector(size_t size = 0) : data(size, T(0))
+    {
+        MATRIX_PROFILE_EVENT(RecordAlloc(size * sizeof(T)));
+    }
+
+    /**
+     * @brief 构造所有元素为同一值的向量
+     *
+     * @param size  向量长度
+     * @param value 元素值
+     */
+    Vector(size_t size, const T &value) : data(size, value)
+    {
+        MATRIX_PROFILE_EVENT(RecordAlloc(size * sizeof(T)));
+    }
+
+    /**
+     * @brief 使用初始化列表构造向量
+     *
+     * @param list 元素列表
+     */
+    Vector(std::initializer_list<T> list) : data(list)
+    {
+        MATRIX_PROFILE_EVENT(RecordAlloc(list.size() * sizeof(T)));
+    }
+
+    /**
+     * @brief 复制视图中的元素构造向量
+     *
+     * @param view 向量视图，例如矩阵的一行或一列
+     */
+    explicit Vector(VectorView<const T> view) : data(view.Size())
+    {
+        MATRIX_PROFILE_EVENT(RecordAlloc(view.Size() * sizeof(T)));
+        for (size_t i = 0; i < view.Size(); ++i)
+            data[i] = view[i];
+    }
+
+    Vector(const Vector &other) : data(other.data)
+    {
+        MATRIX_PROFILE_EVENT(RecordAlloc(data.size() * sizeof(T)));
+    }
+
+    Vector(Vector &&other) = default;
+    Vector &operator=(const Vector &other) = default;
+    Vector &operator=(Vector &&other) = default;
+
+public:
+    //向量长度
+    size_t Size() const
+    {
+        return data.size();
+    }
+
+    //向量数据
+    T *Data()
+    {
+        return data.data();
+    }
+
+    //向量只读数据
+    const T *Data() const
+    {
+        return data.data();
+    }
+
+    /**
+     * @brief 元素访问，下标从0开始
+     *
+     * @param i 下标
+     * @return T& 元素的引用
+     */
+    T &operator[](size_t i)
+    {
+        assert(i < data.size());
+        return data[i];
+    }
+
+    const T &operator[](size_t i) const
+    {
+        assert(i < data.size());
+        return data[i];
+    }
+
+    //转换为可写视图
+    operator VectorView<T>()
+    {
+        return VectorView<T>(data.data(), data.size(), 1);
+    }
+
+    //转换为只读视图
+    operator VectorView<const T>() const
+    {
+        return VectorView<const T>(data.data(), data.size(), 1);
+    }
+
+public:
+    /**
+     * @brief 向量内积
+     *
+     * @param x 向量或视图
+     * @param y 与x等长的向量或视图
+     * @return T 内积 Σ xᵢyᵢ
+     */
+    static T Dot(VectorView<const T> x, VectorView<const T> y)
+    {
+        MATRIX_PROFILE_SCOPE("Vector::Dot");
+        assert(x.Size() == y.Size());
+        return MatrixKernel<T>::Dot(x.Size(), x.Data(), x.Stride(), y.Data(), y.Stride());
+    }
+
+    /**
+     * @brief y = αx + y
+     *
+     * @param alpha 系数α
+     * @param x     向量或视图
+     * @param y     与x等长的向量或视图，结果写回y
+     */
+    static void Axpy(const T &alpha, VectorView<const T> x, VectorView<T> y)
+    {
+        MATRIX_PROFILE_SCOPE("Vector::Axpy");
+        assert(x.Size() == y.Size());
+        MatrixKernel<T>::Axpy(x.Size(), alpha, x.Data(), x.Stride(), y.Data(), y.Stride());
+    }
+
+    /**
+     * @brief 向量的2范数
+     *
+     * 逐元素缩放累加，元素很大或很小时不会上溢或下溢。复数元素的结果为实数。
+     *
+     * @param x 向量或视图
+     * @return ‖x‖₂
+     */
+    static typename MatrixScalar<T>::Real Norm(VectorView<const T> x)
+    {
+        MATRIX_PROFILE_SCOPE("Vector::Norm");
+        typedef typename MatrixScalar<T>::Real R;
+        R scale = R(0), ssq = R(1);
+        for (size_t i = 0; i < x.Size(); ++i)
+        {
+            R a = MatrixScalar<T>::Abs(x[i]);
+            if (a == R(0))
+                continue;
+            if (scale < a)
+            {
+                ssq = R(1) + ssq * (scale / a) * (scale / a);
+                scale = a;
+            }
+            else
+                ssq += (a / scale) * (a / scale);
+        }
+        return scale * std::sqrt(ssq);
+    }
+
+    /**
+     * @brief 矩阵向量乘法 y = αAx + βy，transpose为真时计算 y = αAᵀx + βy
+     *
+     * 转置情形不生成Aᵀ。y不得与x或A的数据重叠。
+     *
+     * @param alpha     系数α
+     * @param mat       矩阵A
+     * @param x         长度为A的列数（转置时为行数）的向量或视图
+     * @param beta      系数β，为0时忽略y的原有值
+     * @param y         长度为A的行数（转置时为列数）的向量或视图
+     * @param transpose 是否使用Aᵀ
+     */
+    template <size_t _Inc>
+    static void Gemv(const T &alpha, const Matrix<T, _Inc> &mat, VectorView<const T> x,
+                     const T &beta, VectorView<T> y, bool transpose = false)
+    {
+        MATRIX_PROFILE_SCOPE("Vector::Gemv");
+        size_t m = mat.RowSize(), n = mat.ColumnSize();
+        assert(x.Size() == (transpose ? m : n));
+        assert(y.Size() == (transpose ? n : m));
+        MatrixKernel<T>::Gemv(transpose, m, n, alpha, mat.Data(), n,
+                              x.Data(), x.Stride(), beta, y.Data(), y.Stride());
+    }
+
+public:
+    //与另一向量的内积
+    T Dot(VectorView<const T> other) const
+    {
+        return Dot(*this, other);
+    }
+
+    //本向量的2范数
+    typename MatrixScalar<T>::Real Norm() const
+    {
+        return Norm(*this);
+    }
+
+    //本向量加上αx
+    Vector &Axpy(const T &alpha, VectorView<const T> x)
+    {
+        Axpy(alpha, x, *this);
+        return *this;
+    }
+};
+
+/**
+    矩阵向量乘法：
+    返回 Ax，不构造 n×1 矩阵
+*/
+template <typename T, size_t _Inc>
+inline Vector<T> operator*(const Matrix<T, _Inc> &mat, const Vector<T> &vec)
+{
+    Vector<T> result(mat.RowSize());
+    Vector<T>::Gemv(T(1), mat, vec, T(0), result);
+    return result;
+}
+
+/**
+    @brief 向量流输出运算符重载
+
+    以行的形式输出向量，要求T类已重载流输出运算符
+*/
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const Vector<T> &vec)
+{
+    os << "[";
+    for (size_t i = 0; i < vec.Size(); ++i)
+    {
+        os << std::setw(12) << std::setfill(' ') << std::setprecision(4);
+        MatrixScalar<T>::Print(os, vec[i]);
+    }
+    os << " ]\n";
+    return os;
+}
+
+/**
+ * @brief 延迟求值的矩阵连乘表达式
+ *
+ * 由 A.Lazy() * B * C ... 构造，构造时只记录各因子的数据与维度。求值时按维度以
+ * 动态规划求出浮点运算次数最少的结合顺序（矩阵链乘问题，O(k³)，k为因子个数），
+ * 再按该顺序计算：中间结果放在可复用的临时缓冲中，乘积为向量时使用GEMV。
+ * 以 * Vector<T> 结尾时立即求值并返回向量，此时向量也参与顺序的选择，
+ * 例如 A * B * v 会按 A * (B * v) 计算。
+ *
+ * 左值因子只保存引用，其生存期必须覆盖求值；右值因子被移入表达式中保存。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class MatrixChain
+{
+private:
+    //一个因子
+    struct Operand
+    {
+        const T *data;
+        size_t rows;
+        size_t cols;
+    };
+
+    std::vector<Operand> operands;                 //各因子
+    std::vector<std::shared_ptr<Matrix<T>>> owned; //以右值传入的因子
+    T scale = T(1);                                //整个乘积的系数
+
+    //中间结果的缓冲池，释放的缓冲可被后续中间结果复用
+    struct ScratchPool
+    {
+        std::vector<std::vector<T>> buffers;
+        std::vector<bool> inUse;
+
+        T *Acquire(size_t size)
+        {
+            size_t best = buffers.size();
+            for (size_t i = 0; i < buffers.size(); ++i)
+                if (!inUse[i] && buffers[i].size() >= size && (best == buffers.size() || buffers[i].size() < buffers[best].size()))
+                    best = i;
+            if (best == buffers.size())
+            {
+                //没有足够大的空闲缓冲时扩大最大的空闲缓冲，否则新建
+                for (size_t i = 0; i < buffers.size(); ++i)
+                    if (!inUse[i] && (best == buffers.size() || buffers[i].size() > buffers[best].size()))
+                        best = i;
+                if (best == buffers.size())
+                {
+                    buffers.emplace_back();
+                    inUse.push_back(false);
+                }
+                buffers[best].resize(size);
+            }
+            inUse[best] = true;
+            return buffers[best].data();
+        }
+
+        void Release(const T *p)
+        {
+            for (size_t i = 0; i < buffers.size(); ++i)
+                if (buffers[i].data() == p)
+                    inUse[i] = false;
+        }
+    };
+
+public:
+    /**
+     * @brief 以第一个因子构造表达式，通常通过 Matrix<T>::Lazy() 调用
+     *
+     * @param first 第一个因子
+     */
+    template <size_t _Inc>
+    explicit MatrixChain(const Matrix<T, _Inc> &first)
+    {
+        Append(first);
+    }
+
+    /**
+     * @brief 以右值作为第一个因子构造表达式，因子被移入表达式中保存
+     *
+     * @param first 第一个因子
+     */
+    explicit MatrixChain(Matrix<T> &&first)
+    {
+        owned.push_back(std::make_shared<Matrix<T>>(std::move(first)));
+        Append(*owned.back());
+    }
+
+    /**
+     * @brief 在右侧追加一个因子
+     *
+     * @param mat 因子，行数必须等于当前表达式的列数
+     * @return MatrixChain<T> 追加后的表达式
+     */
+    template <size_t _Inc>
+    MatrixChain<T> operator*(const Matrix<T, _Inc> &mat) &&
+    {
+        Append(mat);
+        return std::move(*this);
+    }
+
+    template <size_t _Inc>
+    MatrixChain<T> operator*(const Matrix<T, _Inc> &mat) const &
+    {
+        MatrixChain<T> chain(*this);
+        chain.Append(mat);
+        return chain;
+    }
+
+    /**
+     * @brief 在右侧追加一个右值因子，因子被移入表达式中保存
+     */
+    MatrixChain<T> operator*(Matrix<T> &&mat) &&
+    {
+        owned.push_back(std::make_shared<Matrix<T>>(std::move(mat)));
+        Append(*owned.back());
+        return std::move(*this);
+    }
+
+    MatrixChain<T> operator*(Matrix<T> &&mat) const &
+    {
+        MatrixChain<T> chain(*this);
+        return std::move(chain) * std::move(mat);
+    }
+
+    /**
+     * @brief 整个乘积乘以数c，在最后一次乘法中完成
+     */
+    MatrixChain<T> operator*(const T &c) &&
+    {
+        scale *= c;
+        return std::move(*this);
+    }
+
+    MatrixChain<T> operator*(const T &c) const &
+    {
+        MatrixChain<T> chain(*this);
+        chain.scale *= c;
+        return chain;
+    }
+
+    /**
+     * @brief 乘以列向量并立即求值
+     *
+     * @param vec 列向量，长度必须等于表达式的列数
+     * @return Vector<T> 乘积向量
+     */
+    Vector<T> operator*(const Vector<T> &vec) const
+    {
+        MATRIX_PROFILE_SCOPE("MatrixChain");
+        assert(vec.Size() == ColumnSize());
+        std::vector<Operand> ops(operands);
+        ops.push_back(Operand{vec.Data(), vec.Size(), 1});
+        Vector<T> result(RowSize());
+        EvaluateInto(ops, result.Data());
+        return result;
+    }
+
+    /**
+     * @brief 按最优结合顺序求值
+     *
+     * @return Matrix<T> 乘积矩阵
+     */
+    Matrix<T> Evaluate() const
+    {
+        MATRIX_PROFILE_SCOPE("MatrixChain");
+        Matrix<T> result(RowSize(), ColumnSize());
+        EvaluateInto(operands, result.Data());
+        return result;
+    }
+
+    operator Matrix<T>() const
+    {
+        return Evaluate();
+    }
+
+    size_t RowSize() const
+    {
+        return operands.front().rows;
+    }
+
+    size_t ColumnSize() const
+    {
+        return operands.back().cols;
+    }
+
+    /**
+     * @brief 按最优顺序求值所需的浮点运算次数
+     */
+    unsigned long long Flops() const
+    {
+        std::vector<size_t> split;
+        return 2 * Optimize(operands, split);
+    }
+
+    /**
+     * @brief 最优结合顺序，因子以序号表示，例如 "(0 (1 2))"
+     */
+    std::string Order() const
+    {
+        std::vector<size_t> split;
+        Optimize(operands, split);
+        return OrderString(split, operands.size(), 0, operands.size() - 1);
+    }
+
+private:
+    template <size_t _Inc>
+    void Append(const Matrix<T, _Inc> &mat)
+    {
+        assert(operands.empty() || operands.back().cols == mat.RowSize());
+        operands.push_back(Operand{mat.Data(), mat.RowSize(), mat.ColumnSize()});
+    }
+
+    /**
+     * @brief 矩阵链乘的动态规划
+     *
+     * @param ops   各因子
+     * @param split 输出，split[i * k + j] 为因子i..j的最优分割点s：(i..s)(s+1..j)
+     * @return      最少的乘法次数
+     */
+    static unsigned long long Optimize(const std::vector<Operand> &ops, std::vector<size_t> &split)
+    {
+        size_t k = ops.size();
+        std::vector<unsigned long long> cost(k * k, 0);
+        split.assign(k * k, 0);
+        for (size_t len = 2; len <= k; ++len)
+            for (size_t i = 0; i + len <= k; ++i)
+            {
+                size_t j = i + len - 1;
+                cost[i * k + j] = std::numeric_limits<unsigned long long>::max();
+                for (size_t s = i; s < j; ++s)
+                {
+                    unsigned long long c = cost[i * k + s] + cost[(s + 1) * k + j] +
+                                           (unsigned long long)ops[i].rows * ops[s].cols * ops[j].cols;
+                    if (c < cost[i * k + j])
+                    {
+                        cost[i * k + j] = c;
+                        split[i * k + j] = s;
+                    }
+                }
+            }
+        return cost[k - 1];
+    }
+
+    static std::string OrderString(const std::vector<size_t> &split, size_t k, size_t i, size_t j)
+    {
+        if (i == j)
+            return std::to_string(i);
+        size_t s = split[i * k + j];
+        return "(" + OrderString(split, k, i, s) + " " + OrderString(split, k, s + 1, j) + ")";
+    }
+
+    void EvaluateInto(const std::vector<Operand> &ops, T *out) const
+    {
+        std::vector<size_t> split;
+        Optimize(ops, split);
+        ScratchPool pool;
+        Compute(ops, split, 0, ops.size() - 1, scale, out, pool);
+    }
+
+    //计算 α·(因子i..j的乘积)，写入out
+    static void Compute(const std::vector<Operand> &ops, const std::vector<size_t> &split, size_t i, size_t j,
+                        const T &alpha, T *out, ScratchPool &pool)
+    {
+        size_t k = ops.size();
+        if (i == j)
+        {
+            size_t size = ops[i].rows * ops[i].cols;
+            for (size_t e = 0; e < size; ++e)
+                out[e] = alpha * ops[i].data[e];
+            return;
+        }
+
+        size_t s = split[i * k + j];
+        size_t m = ops[i].rows, inner = ops[s].cols, n = ops[j].cols;
+        const T *left = ops[i].data, *right = ops[j].data;
+        T *leftBuf = nullptr, *rightBuf = nullptr;
+        if (s > i)
+        {
+            leftBuf = pool.Acquire(m * inner);
+            Compute(ops, split, i, s, T(1), leftBuf, pool);
+            left = leftBuf;
+        }
+        if (s + 1 < j)
+        {
+            rightBuf = pool.Acquire(inner * n);
+            Compute(ops, split, s + 1, j, T(1), rightBuf, pool);
+            right = rightBuf;
+        }
+
+        if (n == 1)
+            MatrixKernel<T>::Gemv(false, m, inner, alpha, left, inner, right, 1, T(0), out, 1);
+        else if (m == 1)
+            MatrixKernel<T>::Gemv(true, inner, n, alpha, right, n, left, 1, T(0), out, 1);
+        else
+            MatrixKernel<T>::Gemm(m, n, inner, alpha, left, inner, right, n, T(0), out, n);
+
+        if (leftBuf)
+            pool.Release(leftBuf);
+        if (rightBuf)
+            pool.Release(rightBuf);
+    }
+};
+
+/**
+ * @brief 行列式
+ * 
+ * @tparam T 行列式数据类型 
+ */
+template <typename T>
+class Determinant
+{
+private:
+    Matrix<T> *pMat;
+    size_t size = 0;
+
+public:
+    //构造函数
+
+    /**
+     * @brief 行列式构造函数：无参
+     * 
+     */
+    Determinant() : Determinant(0) {}
+
+    /**
+     * @brief 行列式构造函数：定义阶数
+     * 
+     * @param _size 行列式阶数
+     */
+    Determinant(size_t _size) : size(_size)
+    {
+        pMat = new Matrix<T>(size, size);
+    }
+
+    /**
+     * @brief 行列式构造函数：定义阶数,数据
+     * 
+     * @param _size     行列式阶数
+     * @param data      行列式数据
+     * @param dataLen   行列式数据长度
+     */
+    Determinant(size_t _size, const T *data, size_t dataLen) : Determinant(_size)
+    {
+        size_t elemCount = _size * _size;
+        std::copy_n(data, dataLen > elemCount ? elemCount : dataLen, pMat->pData);
+    }
+
+    /**
+     * @brief 行列式构造函数: 由方阵构造
+     * 
+     * @param mat 方阵
+     */
+    Determinant(const Matrix<T> &mat)
+    {
+        assert(mat.uRow == mat.uCol);
+        pMat = new Matrix<T>(mat);
+        size = mat.uRow;
+    }
+
+    /**
+     * @brief 行列式拷贝构造函数
+     * 
+     * @param det 
+     */
+    Determinant(const Determinant<T> &det) : Determinant(*det.pMat) {}
+
+    /**
+     * @brief 行列式移动拷贝函数
+     * 
+     * @param det 
+     */
+    Determinant(Determinant<T> &&det) noexcept
+    {
+        this->size = det.size;
+        this->pMat = det.pMat;
+        det.pMat = nullptr;
+    }
+
+    //析构函数
+    virtual ~Determinant()
+    {
+        if (pMat)
+            delete pMat;
+    }
+
+    /**
+     * @brief 行列式赋值运算符函数
+     * 
+     * @param det 
+     * @return Determinant<T>& 
+     */
+    Determinant<T> &operator=(const Determinant<T> &det)
+    {
+        if (&det == this)
+            return *this;
+
+        if (pMat)
+            *pMat = *det.pMat;
+        else
+            pMat = new Matrix<T>(*det.pMat);
+
+        this->size = pMat->uRow;
+
+        return *this;
+    }
+
+    /**
+     * @brief 行列式移动赋值函数
+     * 
+     * @param det 
+     * @return Determinant<T>& 
+     */
+    Determinant<T> &operator=(Determinant<T> &&det) noexcept
+    {
+        if (&det == this)
+            return *this;
+        std::swap(pMat, det.pMat);
+        std::swap(size, det.size);
+
+        return *this;
+    }
+
+    /**
+     * @brief 行列式求值
+     * 
+     * 整数类型的结果精确（ModularElimination 或 BareissElimination），其它类型按第一行展开
+     * 
+     * @return T 行列式的值
+     */
+    T Value() const
+    {
+        MATRIX_PROFILE_SCOPE("Determinant");
+        return ValueImpl(std::integral_constant<bool, std::numeric_limits<T>::is_integer>());
+    }
+
+private:
+    //整数类型：O(n³)且结果精确。内置整数类型用多模消元，只要行列式能用T表示就不会溢出
+    T ValueImpl(std::true_type) const
+    {
+        if (std::is_integral<T>::value)
+            return ModularElimination<T>::ExactDeterminant(*pMat);
+        return BareissElimination<T>(*pMat).Determinant();
+    }
+
+    //按第一行展开
+    T ValueImpl(std::false_type) const
+    {
+        if (this->size == 1)
+            return this->pMat->pData[0];
+
+        T sum = T(0), sign = T(1);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            Matrix<T> &&minorMat = pMat->MinorOf(1, i + 1);
+            Determinant minorDet(minorMat);
+            sum += sign * minorDet.Value() * pMat->pData[i];
+            sign = -sign;
+        }
+
+        return sum;
+    }
+};
+
+/**
+ * @brief LU分解
+ *
+ * 对方阵进行部分选主元（按列绝对值最大）的LU分解 PA = LU，
+ * L为单位下三角矩阵，U为上三角矩阵，二者合并存储在同一个矩阵中。
+ * 分解一次后可重复用于求解线性方程组、求行列式和逆矩阵。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class LUDecomposition
+{
+private:
+    Matrix<T> lu;            //L（严格下三角部分）与U（上三角部分）
+    std::vector<size_t> piv; //行置换：分解后第i行来自原矩阵第piv[i]行（从0开始）
+    int sign = 1;            //置换的奇偶性
+    bool singular = false;   //是否奇异
+
+public:
+    /**
+     * @brief LU分解构造函数：分解方阵
+     *
+     * @param mat 要分解的方阵
+     */
+    explicit LUDecomposition(const Matrix<T> &mat) : lu(mat), piv(mat.RowSize())
+    {
+        MATRIX_PROFILE_SCOPE("LU");
+        assert(mat.RowSize() == mat.ColumnSize());
+
+        size_t n = lu.RowSize();
+        T *a = lu.Data();
+        for (size_t i = 0; i < n; ++i)
+            piv[i] = i;
+
+        //分块消元，零主元列不跳过
+        std::vector<size_t> pivCols, swaps;
+        MatrixKernel<T>::Eliminate(a, n, n, n, typename MatrixScalar<T>::Real(0), false, pivCols, swaps);
+        for (size_t k = 0; k < n; ++k)
+        {
+            if (swaps[k] != k)
+            {
+                size_t tmp = piv[k];
+                piv[k] = piv[swaps[k]];
+                piv[swaps[k]] = tmp;
+                sign = -sign;
+            }
+            if (a[k * n + k] == T(0))
+                singular = true;
+        }
+    }
+
+    /**
+     * @brief 矩阵是否奇异
+     *
+     * @return 若分解过程中出现全0主元列，返回true
+     */
+    bool IsSingular() const
+    {
+        return singular;
+    }
+
+    /**
+     * @brief 求解线性方程组 AX = B
+     *
+     * @param b 右端矩阵，行数与A相同，每一列为一个右端向量
+     * @return Matrix<T> 解矩阵X
+     */
+    Matrix<T> Solve(const Matrix<T> &b) const
+    {
+        MATRIX_PROFILE_SCOPE("LUSolve");
+        assert(!singular && b.RowSize() == lu.RowSize());
+
+        size_t n = lu.RowSize(), m = b.ColumnSize();
+        const T *a = lu.Data();
+        Matrix<T> x(n, m);
+        T *px = x.Data();
+        const T *pb = b.Data();
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < m; ++j)
+                px[i * m + j] = pb[piv[i] * m + j];
+
+        //前代：LY = PB
+        for (size_t i = 0; i < n; ++i)
+            for (size_t k = 0; k < i; ++k)
+            {
+                T l = a[i * n + k];
+                if (l == T(0))
+                    continue;
+                for (size_t j = 0; j < m; ++j)
+                    px[i * m + j] -= l * px[k * m + j];
+            }
+
+        //回代：UX = Y
+        for (size_t i = n; i-- > 0;)
+        {
+            for (size_t k = i + 1; k < n; ++k)
+            {
+                T u = a[i * n + k];
+                if (u == T(0))
+                    continue;
+                for (size_t j = 0; j < m; ++j)
+                    px[i * m + j] -= u * px[k * m + j];
+            }
+            for (size_t j = 0; j < m; ++j)
+                px[i * m + j] /= a[i * n + i];
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * n * n * m));
+        return x;
+    }
+
+    /**
+     * @brief 由分解结果求行列式
+     *
+     * @return T 行列式的值
+     */
+    T Determinant() const
+    {
+        if (singular)
+            return T(0);
+        T det = sign > 0 ? T(1) : T(-1);
+        for (size_t i = 0; i < lu.RowSize(); ++i)
+            det *= lu.ElemAt0(i, i);
+        return det;
+    }
+
+    /**
+     * @brief 由分解结果求逆矩阵
+     *
+     * @return Matrix<T> 逆矩阵
+     */
+    Matrix<T> Inverse() const
+    {
+        return Solve(Matrix<T>::Identity(lu.RowSize()));
+    }
+};
+
+/**
+ * @brief 分数无关（Bareiss）消元
+ *
+ * 整数类型的高斯消元。第k步以 a(i, j) ← (a(k, k)·a(i, j) - a(i, k)·a(k, j)) / p 更新，p为上一步的主元，
+ * 除法总能整除。消元后每个元素都是原矩阵的一个子式，中间结果的位数不超过最终行列式位数的两倍，
+ * 可用于满足 std::numeric_limits<T>::is_integer 的大整数类型；用于int、long long等内置整数类型时，
+ * 更新中两个子式的乘积也须能用T表示，否则结果错误。
+ * 大整数类型的 Matrix<T> 的 Inverse()、Adjugate()、RowReduce()、Rank() 与 Determinant<T>::Value()
+ * 自动使用本类；内置整数类型只有 RowReduce() 使用本类，其余改用不会溢出的 ModularElimination。
+ *
+ * 逆矩阵、方程组的解与行最简形一般不是整数矩阵，以“整数矩阵 / 公分母”的形式给出，
+ * 公分母为正，且与矩阵的所有元素已约去公因子。
+ *
+ * @tparam T 整数类型，须支持 +、-、*、/ 与 %
+ */
+template <typename T>
+class BareissElimination
+{
+private:
+    Matrix<T> a;                 //原矩阵
+    Matrix<T> r;                 //分数无关的行阶梯形
+    std::vector<size_t> pivCols; //主元列（从0开始）
+    int sign = 1;                //行交换的奇偶性
+
+public:
+    /**
+     * @brief 分数无关消元构造函数：化为行阶梯形
+     *
+     * @param mat 任意形状的矩阵
+     */
+    explicit BareissElimination(const Matrix<T> &mat) : a(mat), r(mat)
+    {
+        MATRIX_PROFILE_SCOPE("Bareiss");
+        Eliminate(r.Data(), r.RowSize(), r.ColumnSize(), r.ColumnSize(), pivCols, sign);
+    }
+
+    /**
+     * @brief 矩阵的秩（精确）
+     *
+     * @return size_t 主元个数
+     */
+    size_t Rank() const
+    {
+        return pivCols.size();
+    }
+
+    /**
+     * @brief 各主元所在的列
+     *
+     * @return const std::vector<size_t>& 主元列，从0开始
+     */
+    const std::vector<size_t> &PivotColumns() const
+    {
+        return pivCols;
+    }
+
+    /**
+     * @brief 分数无关的行阶梯形
+     *
+     * 第k个主元等于原矩阵（行交换后）前k + 1个主元行与主元列构成的子式
+     *
+     * @return const Matrix<T>& 行阶梯形
+     */
+    const Matrix<T> &Echelon() const
+    {
+        return r;
+    }
+
+    /**
+     * @brief 行列式（精确）
+     *
+     * @return T 行列式的值，0阶时为1
+     */
+    T Determinant() const
+    {
+        size_t n = r.RowSize();
+        assert(n == r.ColumnSize());
+        if (n == 0)
+            return T(1);
+        if (pivCols.size() < n)
+            return T(0);
+        T det = r.ElemAt0(n - 1, n - 1);
+        return sign > 0 ? det : -det;
+    }
+
+    /**
+     * @brief 行最简形
+     *
+     * 行最简形 = 返回的矩阵 / denominator。行最简形本身为整数矩阵时denominator为1
+     *
+     * @param denominator 输出：公分母
+     * @return Matrix<T> 行最简形的分子
+     */
+    Matrix<T> ReducedEchelon(T &denominator) const
+    {
+        MATRIX_PROFILE_SCOPE("BareissReduce");
+        Matrix<T> y(r);
+        denominator = T(1);
+        size_t rank = pivCols.size(), n = y.ColumnSize();
+        if (rank == 0)
+            return y;
+        T *py = y.Data();
+        T d = py[(rank - 1) * n + pivCols.back()];
+        BackSubstitute(py, rank, n, pivCols);
+        denominator = Normalize(py, rank * n, d);
+        return y;
+    }
+
+    /**
+     * @brief 求解线性方程组 AX = B（精确）
+     *
+     * 要求A为非奇异方阵。X = 返回的矩阵 / denominator
+     *
+     * @param b             右端矩阵，行数与A相同
+     * @param denominator   输出：公分母
+     * @return Matrix<T> 解的分子
+     */
+    Matrix<T> Solve(const Matrix<T> &b, T &denominator) const
+    {
+        MATRIX_PROFILE_SCOPE("BareissSolve");
+        T d;
+        Matrix<T> x = SolveScaled(b, d);
+        denominator = Normalize(x.Data(), x.RowSize() * x.ColumnSize(), d);
+        return x;
+    }
+
+    /**
+     * @brief 逆矩阵（精确）
+     *
+     * 要求A为非奇异方阵。A⁻¹ = 返回的矩阵 / denominator，行列式为±1时denominator为1
+     *
+     * @param denominator 输出：公分母
+     * @return Matrix<T> 逆矩阵的分子
+     */
+    Matrix<T> Inverse(T &denominator) const
+    {
+        return Solve(Matrix<T>::Identity(a.RowSize()), denominator);
+    }
+
+    /**
+     * @brief 伴随矩阵 adj(A)，满足 A·adj(A) = det(A)·I
+     *
+     * 非奇异时由一次分数无关求解得到；秩为n - 1时逐个计算代数余子式（O(n⁵)），
+     * 秩更低时伴随矩阵为0
+     *
+     * @return Matrix<T> 伴随矩阵
+     */
+    Matrix<T> Adjugate() const
+    {
+        MATRIX_PROFILE_SCOPE("Adjugate");
+        size_t n = a.RowSize();
+        assert(n == a.ColumnSize());
+        size_t rank = pivCols.size();
+        if (n == 0)
+            return Matrix<T>(0, 0);
+        if (rank == n)
+        {
+            //SolveScaled给出 d·A⁻¹，d = sign·det(A)
+            T d;
+            Matrix<T> x = SolveScaled(Matrix<T>::Identity(n), d);
+            return sign > 0 ? x : -std::move(x);
+        }
+
+        Matrix<T> adj(n, n, T(0));
+        if (rank + 1 < n)
+            return adj;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+            {
+                T c = BareissElimination<T>(a.MinorOf(i + 1, j + 1)).Determinant();
+                adj.ElemAt0(j, i) = (i + j) % 2 == 0 ? c : -c;
+            }
+        return adj;
+    }
+
+private:
+    //求解 AX = B，返回 d·X，d为最后一个主元（sign·det(A)）
+    Matrix<T> SolveScaled(const Matrix<T> &b, T &d) const
+    {
+        size_t n = a.RowSize(), m = b.ColumnSize(), w = n + m;
+        assert(n == a.ColumnSize() && b.RowSize() == n && pivCols.size() == n);
+
+        //增广矩阵[A | B]，只在A的列中选主元
+        std::vector<T> aug(n * w);
+        const T *pa = a.Data(), *pb = b.Data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::copy(pa + i * n, pa + (i + 1) * n, aug.begin() + i * w);
+            std::copy(pb + i * m, pb + (i + 1) * m, aug.begin() + i * w + n);
+        }
+        std::vector<size_t> piv;
+        int s = 1;
+        Eliminate(aug.data(), n, w, n, piv, s);
+        d = aug[(n - 1) * w + n - 1];
+        BackSubstitute(aug.data(), n, w, piv);
+
+        Matrix<T> x(n, m);
+        T *px = x.Data();
+        for (size_t i = 0; i < n; ++i)
+            std::copy(aug.begin() + i * w + n, aug.begin() + (i + 1) * w, px + i * m);
+        return x;
+    }
+
+    /**
+     * @brief 分数无关的前向消元
+     *
+     * @param a             行主序数据，原地化为行阶梯形
+     * @param m             行数
+     * @param n             列数（行距）
+     * @param pivotLimit    只在前pivotLimit列中选主元，其余列只参与更新
+     * @param pivCols       输出：主元列
+     * @param sign          输出：行交换的奇偶性
+     */
+    static void Eliminate(T *a, size_t m, size_t n, size_t pivotLimit, std::vector<size_t> &pivCols, int &sign)
+    {
+        T prev = T(1);
+        size_t r = 0;
+        for (size_t k = 0; k < pivotLimit && r < m; ++k)
+        {
+            size_t p = r;
+            while (p < m && a[p * n + k] == T(0))
+                ++p;
+            if (p == m)
+                continue;
+            if (p != r)
+            {
+                //左侧各列在第r行及以下均已为0
+                for (size_t j = k; j < n; ++j)
+                    std::swap(a[p * n + j], a[r * n + j]);
+                sign = -sign;
+            }
+
+            const T *pivRow = a + r * n;
+            T piv = pivRow[k];
+            MATRIX_PROFILE_EVENT(RecordFlops(4ull * (m - r - 1) * (n - k - 1)));
+            MatrixThreadPool::ParallelFor(r + 1, m, 1 + 8192 / (n - k), [&](size_t b, size_t e)
+                                          {
+                                              for (size_t i = b; i < e; ++i)
+                                              {
+                                                  T *row = a + i * n;
+                                                  T f = row[k];
+                                                  row[k] = T(0);
+                                                  for (size_t j = k + 1; j < n; ++j)
+                                                      row[j] = (piv * row[j] - f * pivRow[j]) / prev;
+                                              }
+                                          });
+            prev = piv;
+            pivCols.push_back(k);
+            ++r;
+        }
+    }
+
+    /**
+     * @brief 分数无关回代：把前rank行替换为 d·S⁻¹E
+     *
+     * E为行阶梯形的前rank行，S为E的主元列构成的上三角矩阵，d为最后一个主元。
+     * d·S⁻¹E 的元素均为整数，每一行的除法都能整除
+     */
+    static void BackSubstitute(T *y, size_t rank, size_t n, const std::vector<size_t> &piv)
+    {
+        T d = y[(rank - 1) * n + piv[rank - 1]];
+        std::vector<T> s(rank);
+        for (size_t k = rank; k-- > 0;)
+        {
+            T *row = y + k * n;
+            T pk = row[piv[k]];
+            for (size_t j = k + 1; j < rank; ++j)
+                s[j] = row[piv[j]];
+            for (size_t c = 0; c < n; ++c)
+                row[c] *= d;
+            for (size_t j = k + 1; j < rank; ++j)
+            {
+                if (s[j] == T(0))
+                    continue;
+                const T *yj = y + j * n;
+                for (size_t c = 0; c < n; ++c)
+                    row[c] -= s[j] * yj[c];
+            }
+            for (size_t c = 0; c < n; ++c)
+                row[c] /= pk;
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * rank * rank * n));
+    }
+
+    //将 x / d 约分并使分母为正，返回约分后的分母
+    static T Normalize(T *x, size_t count, T d)
+    {
+        T g = Abs(d);
+        for (size_t i = 0; i < count && g != T(1); ++i)
+            g = Gcd(g, Abs(x[i]));
+        if (d < T(0))
+            g = -g;
+        if (g != T(1))
+            for (size_t i = 0; i < count; ++i)
+                x[i] /= g;
+        return d / g;
+    }
+
+    static T Abs(const T &x)
+    {
+        return x < T(0) ? -x : x;
+    }
+
+    static T Gcd(T x, T y)
+    {
+        while (y != T(0))
+        {
+            T t = x % y;
+            x = y;
+            y = t;
+        }
+        return x;
+    }
+};
+
+/**
+ * @brief 模素数p的高斯消元
+ *
+ * 将整数矩阵的元素约化为模p的剩余后做高斯-约当消元，求模p的秩、行列式、行最简形、
+ * 逆矩阵与方程组的解。p须为小于2³¹的素数，剩余以64位无符号整数运算，乘积不会溢出。
+ *
+ * ExactDeterminant() 对一组31位素数分别求模p行列式（由线程池并行），再以中国剩余定理
+ * （Garner算法，对称剩余）重构精确的行列式。素数的乘积超过Hadamard界的两倍时结果唯一确定；
+ * T为有界类型时只需超过T最大值的两倍，行列式能用T表示即可保证结果正确。
+ * ExactAdjugate() 与 ExactInverse() 以同样的方式由 det(A)·A⁻¹ 的模p剩余重构伴随矩阵。
+ *
+ * @tparam T 整数类型
+ */
+template <typename T>
+class ModularElimination
+{
+private:
+    size_t uRow, uCol;           //行数与列数
+    uint64_t p;                  //模数
+    std::vector<uint64_t> a;     //原矩阵的剩余
+    std::vector<uint64_t> r;     //模p的行最简形
+    std::vector<size_t> pivCols; //主元列（从0开始）
+    uint64_t det = 0;            //模p行列式（方阵）
+
+public:
+    /**
+     * @brief 模p消元构造函数：化为模p的行最简形
+     *
+     * @param mat   任意形状的整数矩阵
+     * @param prime 素数模数，小于2³¹
+     */
+    ModularElimination(const Matrix<T> &mat, uint32_t prime)
+        : uRow(mat.RowSize()), uCol(mat.ColumnSize()), p(prime), a(uRow * uCol)
+    {
+        MATRIX_PROFILE_SCOPE("ModularElimination");
+        assert(prime < (1u << 31) && IsPrime(prime));
+        const T *src = mat.Data();
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = Residue(src[i], p);
+        r = a;
+        uint64_t d = Eliminate(r.data(), uRow, uCol, uCol, p, true, pivCols);
+        if (uRow == uCol)
+            det = pivCols.size() == uRow ? d : 0;
+    }
+
+    /**
+     * @brief 模数
+     *
+     * @return uint32_t 素数p
+     */
+    uint32_t Modulus() const
+    {
+        return uint32_t(p);
+    }
+
+    /**
+     * @brief 模p的秩，不大于矩阵在有理数域上的秩
+     *
+     * @return size_t 主元个数
+     */
+    size_t Rank() const
+    {
+        return pivCols.size();
+    }
+
+    /**
+     * @brief 各主元所在的列
+     *
+     * @return const std::vector<size_t>& 主元列，从0开始
+     */
+    const std::vector<size_t> &PivotColumns() const
+    {
+        return pivCols;
+    }
+
+    /**
+     * @brief 模p行列式
+     *
+     * @return T 行列式模p的值，在[0, p)内
+     */
+    T Determinant() const
+    {
+        assert(uRow == uCol);
+        return static_cast<T>(det);
+    }
+
+    /**
+     * @brief 模p的行最简形
+     *
+     * @return Matrix<T> 元素在[0, p)内的行最简形
+     */
+    Matrix<T> ReducedEchelon() const
+    {
+        Matrix<T> m(uRow, uCol);
+        T *pm = m.Data();
+        for (size_t i = 0; i < r.size(); ++i)
+            pm[i] = static_cast<T>(r[i]);
+        return m;
+    }
+
+    /**
+     * @brief 求解模p的线性方程组 AX ≡ B
+     *
+     * 要求A为模p非奇异的方阵
+     *
+     * @param b 右端矩阵，行数与A相同
+     * @return Matrix<T> 元素在[0, p)内的解
+     */
+    Matrix<T> Solve(const Matrix<T> &b) const
+    {
+        MATRIX_PROFILE_SCOPE("ModularSolve");
+        size_t n = uRow, m = b.ColumnSize(), w = n + m;
+        assert(uRow == uCol && b.RowSize() == n && pivCols.size() == n);
+
+        std::vector<uint64_t> aug(n * w);
+        const T *pb = b.Data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::copy(a.begin() + i * n, a.begin() + (i + 1) * n, aug.begin() + i * w);
+            for (size_t j = 0; j < m; ++j)
+                aug[i * w + n + j] = Residue(pb[i * m + j], p);
+        }
+        std::vector<size_t> piv;
+        Eliminate(aug.data(), n, w, n, p, true, piv);
+
+        Matrix<T> x(n, m);
+        T *px = x.Data();
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < m; ++j)
+                px[i * m + j] = static_cast<T>(aug[i * w + n + j]);
+        return x;
+    }
+
+    /**
+     * @brief 模p逆矩阵
+     *
+     * @return Matrix<T> 元素在[0, p)内的逆矩阵
+     */
+    Matrix<T> Inverse() const
+    {
+        return Solve(Matrix<T>::Identity(uRow));
+    }
+
+    /**
+     * @brief 以多模消元与中国剩余定理求精确的行列式
+     *
+     * @param mat 整数方阵
+     * @return T 行列式的值
+     */
+    static T ExactDeterminant(const Matrix<T> &mat)
+    {
+        MATRIX_PROFILE_SCOPE("ExactDeterminant");
+        size_t n = mat.RowSize();
+        assert(n == mat.ColumnSize());
+        if (n == 0)
+            return T(1);
+
+        //Hadamard界：log2|det| ≤ Σ log2 ||row||₂
+        std::vector<double> rowBits, colBits;
+        Log2Norms(mat, rowBits, colBits);
+        double bits = 1.0;
+        for (double v : rowBits)
+            bits += v;
+        if (bits == -std::numeric_limits<double>::infinity())
+            return T(0);
+        if (std::numeric_limits<T>::is_bounded)
+            bits = std::min(bits, double(std::numeric_limits<T>::digits) + 1.0);
+
+        std::vector<uint64_t> primes;
+        uint64_t q = 1ull << 31;
+        for (double covered = 0.0; covered <= bits;)
+        {
+            q = PreviousPrime(q);
+            primes.push_back(q);
+            covered += std::log2(double(q));
+        }
+
+        std::vector<uint64_t> residues(primes.size());
+        MatrixThreadPool::ParallelFor(0, primes.size(), 1, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t k = b; k < e; ++k)
+                                              ForwardEliminate(mat, primes[k], residues[k]);
+                                      });
+        return Reconstruct(primes, GarnerInverses(primes), residues.data(), 1);
+    }
+
+    /**
+     * @brief 以多模消元与中国剩余定理求精确的伴随矩阵 adj(A)，满足 A·adj(A) = det(A)·I
+     *
+     * 非奇异时对每个不整除det(A)的素数求 det(A)·A⁻¹ 的模p剩余，素数之积超过 n - 1 阶子式
+     * Hadamard界的两倍后逐元素重构；奇异且秩为 n - 1 时逐个求代数余子式（O(n⁵)），秩更低时为0。
+     * T为有界类型时，伴随矩阵的元素能用T表示即可保证结果正确。
+     *
+     * @param mat 整数方阵
+     * @return Matrix<T> 伴随矩阵
+     */
+    static Matrix<T> ExactAdjugate(const Matrix<T> &mat)
+    {
+        MATRIX_PROFILE_SCOPE("ExactAdjugate");
+        T det;
+        return Adjugate(mat, det);
+    }
+
+    /**
+     * @brief 以多模消元与中国剩余定理求精确的逆矩阵
+     *
+     * A⁻¹ = 返回的矩阵 / denominator，公分母为正，且与矩阵的所有元素已约去公因子。
+     * 要求A非奇异，奇异时返回空矩阵且denominator为0。T为有界类型时，伴随矩阵的元素与
+     * 行列式能用T表示即可保证结果正确。
+     *
+     * @param mat           整数方阵
+     * @param denominator   输出：公分母
+     * @return Matrix<T> 逆矩阵的分子
+     */
+    static Matrix<T> ExactInverse(const Matrix<T> &mat, T &denominator)
+    {
+        MATRIX_PROFILE_SCOPE("ExactInverse");
+        T det;
+        Matrix<T> adj = Adjugate(mat, det);
+        if (det == T(0))
+        {
+            assert(0);
+            denominator = T(0);
+            return Matrix<T>();
+        }
+
+        //约去所有元素与行列式的公因子，并使分母为正
+        T *x = adj.Data();
+        size_t count = adj.RowSize() * adj.ColumnSize();
+        T g = Abs(det);
+        for (size_t i = 0; i < count && g != T(1); ++i)
+            g = Gcd(g, Abs(x[i]));
+        if (det < T(0))
+            g = -g;
+        if (g != T(1))
+            for (size_t i = 0; i < count; ++i)
+                x[i] /= g;
+        denominator = det / g;
+        return adj;
+    }
+
+    /**
+     * @brief 以多模消元求精确的秩
+     *
+     * 模p的秩不大于真实的秩r，只有p整除所有 (r0 + 1) 阶非零子式时才会偏小。
+     * 不断增加素数，直到所用素数之积超过 (r0 + 1) 阶子式的Hadamard界，r0为各模数下秩的最大值，
+     * 结果即为精确的秩。满秩时只需一个素数
+     *
+     * @param mat 整数矩阵
+     * @return size_t 矩阵的秩
+     */
+    static size_t ExactRank(const Matrix<T> &mat)
+    {
+        MATRIX_PROFILE_SCOPE("ExactRank");
+        size_t full = std::min(mat.RowSize(), mat.ColumnSize());
+        if (full == 0)
+            return 0;
+
+        //k阶子式的界：最大的k个行范数之积与最大的k个列范数之积中较小者
+        std::vector<double> rowBits, colBits;
+        Log2Norms(mat, rowBits, colBits);
+        std::sort(rowBits.begin(), rowBits.end(), std::greater<double>());
+        std::sort(colBits.begin(), colBits.end(), std::greater<double>());
+        auto minorBits = [&](size_t k)
+        {
+            double r = 1.0, c = 1.0;
+            for (size_t i = 0; i < k; ++i)
+            {
+                r += rowBits[i];
+                c += colBits[i];
+            }
+            return std::min(r, c);
+        };
+
+        size_t rank = 0, batch = 1;
+        uint64_t q = 1ull << 31;
+        double covered = 0.0;
+        do
+        {
+            std::vector<uint64_t> primes;
+            for (size_t k = 0; k < batch; ++k)
+            {
+                q = PreviousPrime(q);
+                primes.push_back(q);
+                covered += std::log2(double(q));
+            }
+            std::vector<size_t> ranks(primes.size());
+            MatrixThreadPool::ParallelFor(0, primes.size(), 1, [&](size_t b, size_t e)
+                                          {
+                                              uint64_t det;
+                                              for (size_t k = b; k < e; ++k)
+                                                  ranks[k] = ForwardEliminate(mat, primes[k], det);
+                                          });
+            for (size_t r : ranks)
+                rank = std::max(rank, r);
+            //第一批只用一个素数，满秩时不再继续
+            batch = std::max<size_t>(1, MatrixThreadPool::ThreadCount());
+        } while (rank < full && covered <= minorBits(rank + 1));
+        return rank;
+    }
+
+private:
+    //伴随矩阵，det输出精确的行列式
+    static Matrix<T> Adjugate(const Matrix<T> &mat, T &det)
+    {
+        size_t n = mat.RowSize();
+        assert(n == mat.ColumnSize());
+        det = ExactDeterminant(mat);
+        if (n == 0)
+            return Matrix<T>(0, 0);
+        if (det == T(0))
+        {
+            Matrix<T> adj(n, n, T(0));
+            if (ExactRank(mat) + 1 < n)
+                return adj;
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < n; ++j)
+                {
+                    T c = ExactDeterminant(mat.MinorOf(i + 1, j + 1));
+                    adj.ElemAt0(j, i) = (i + j) % 2 == 0 ? c : -c;
+                }
+            return adj;
+        }
+
+        //n - 1阶子式的Hadamard界：去掉范数最小的一行
+        std::vector<double> rowBits, colBits;
+        Log2Norms(mat, rowBits, colBits);
+        double bits = 1.0 - *std::min_element(rowBits.begin(), rowBits.end());
+        for (double v : rowBits)
+            bits += v;
+        if (std::numeric_limits<T>::is_bounded)
+            bits = std::min(bits, double(std::numeric_limits<T>::digits) + 1.0);
+
+        //每批取线程数个素数并行求 det(A)·A⁻¹ mod p，整除det(A)的素数下A奇异，舍弃
+        size_t nn = n * n, batch = std::max<size_t>(1, MatrixThreadPool::ThreadCount());
+        std::vector<uint64_t> primes, residues; //residues[k·n² + i]：第k个素数下的第i个元素
+        uint64_t q = 1ull << 31;
+        double covered = 0.0;
+        while (covered <= bits)
+        {
+            std::vector<uint64_t> candidates;
+            for (size_t k = 0; k < batch; ++k)
+                candidates.push_back(q = PreviousPrime(q));
+            std::vector<uint64_t> found(candidates.size() * nn);
+            std::vector<char> good(candidates.size());
+            MatrixThreadPool::ParallelFor(0, candidates.size(), 1, [&](size_t b, size_t e)
+                                          {
+                                              for (size_t k = b; k < e; ++k)
+                                                  good[k] = ScaledInverse(mat, candidates[k], found.data() + k * nn);
+                                          });
+            for (size_t k = 0; k < candidates.size() && covered <= bits; ++k)
+                if (good[k])
+                {
+                    primes.push_back(candidates[k]);
+                    residues.insert(residues.end(), found.begin() + k * nn, found.begin() + (k + 1) * nn);
+                    covered += std::log2(double(candidates[k]));
+                }
+        }
+
+        Matrix<T> adj(n, n);
+        T *pAdj = adj.Data();
+        std::vector<uint64_t> inv = GarnerInverses(primes);
+        MatrixThreadPool::ParallelFor(0, nn, 1024, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                              pAdj[i] = Reconstruct(primes, inv, residues.data() + i, nn);
+                                      });
+        return adj;
+    }
+
+    //求 det(A)·A⁻¹ mod p，写入adj（n²个剩余）；A模p奇异时返回false
+    static bool ScaledInverse(const Matrix<T> &mat, uint64_t p, uint64_t *adj)
+    {
+        size_t n = mat.RowSize(), w = 2 * n;
+        std::vector<uint64_t> aug(n * w, 0);
+        const T *src = mat.Data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+                aug[i * w + j] = Residue(src[i * n + j], p);
+            aug[i * w + n + i] = 1;
+        }
+        std::vector<size_t> piv;
+        uint64_t det = Eliminate(aug.data(), n, w, n, p, true, piv);
+        if (piv.size() < n)
+            return false;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                adj[i * n + j] = aug[i * w + n + j] * det % p;
+        return true;
+    }
+
+    //Garner算法的系数：(p_0···p_{k-1})⁻¹ mod p_k
+    static std::vector<uint64_t> GarnerInverses(const std::vector<uint64_t> &primes)
+    {
+        std::vector<uint64_t> inv(primes.size());
+        for (size_t k = 0; k < primes.size(); ++k)
+        {
+            uint64_t pk = primes[k], mk = 1;
+            for (size_t j = 0; j < k; ++j)
+                mk = mk * (primes[j] % pk) % pk;
+            inv[k] = PowMod(mk, pk - 2, pk);
+        }
+        return inv;
+    }
+
+    /**
+     * @brief Garner算法：由各素数下的剩余 residues[k·stride] 重构对称剩余
+     *
+     * value = Σ c_k·(p_0···p_{k-1})，c_k取对称剩余，value始终为当前模数下的对称剩余
+     */
+    static T Reconstruct(const std::vector<uint64_t> &primes, const std::vector<uint64_t> &inv,
+                         const uint64_t *residues, size_t stride)
+    {
+        T value = T(0), modulus = T(1);
+        for (size_t k = 0; k < primes.size(); ++k)
+        {
+            uint64_t pk = primes[k];
+            uint64_t c = (residues[k * stride] + pk - Residue(value, pk)) % pk * inv[k] % pk;
+            if (c != 0)
+                value += (c > pk / 2 ? -static_cast<T>(pk - c) : static_cast<T>(c)) * modulus;
+            if (k + 1 < primes.size())
+                modulus *= static_cast<T>(pk);
+        }
+        return value;
+    }
+
+    static T Abs(const T &x)
+    {
+        return x < T(0) ? -x : x;
+    }
+
+    static T Gcd(T x, T y)
+    {
+        while (y != T(0))
+        {
+            T t = x % y;
+            x = y;
+            y = t;
+        }
+        return x;
+    }
+
+    //对mat的剩余做前向消元，返回模p的秩，det为模p行列式（非方阵或不满秩时为0）
+    static size_t ForwardEliminate(const Matrix<T> &mat, uint64_t p, uint64_t &det)
+    {
+        size_t m = mat.RowSize(), n = mat.ColumnSize();
+        std::vector<uint64_t> r(m * n);
+        const T *src = mat.Data();
+        for (size_t i = 0; i < r.size(); ++i)
+            r[i] = Residue(src[i], p);
+        std::vector<size_t> piv;
+        det = Eliminate(r.data(), m, n, n, p, false, piv);
+        if (m != n || piv.size() < n)
+            det = 0;
+        return piv.size();
+    }
+
+    //各行与各列2-范数的以2为底的对数，按最大元缩放以免溢出，全0时为-∞
+    static void Log2Norms(const Matrix<T> &mat, std::vector<double> &rowBits, std::vector<double> &colBits)
+    {
+        size_t m = mat.RowSize(), n = mat.ColumnSize();
+        const T *src = mat.Data();
+        std::vector<double> v(m * n);
+        for (size_t i = 0; i < v.size(); ++i)
+            v[i] = std::fabs(static_cast<double>(src[i]));
+        auto log2Norm = [&](size_t start, size_t count, size_t stride)
+        {
+            double big = 0.0, sum = 0.0;
+            for (size_t k = 0; k < count; ++k)
+                big = std::max(big, v[start + k * stride]);
+            if (big == 0.0)
+                return -std::numeric_limits<double>::infinity();
+            for (size_t k = 0; k < count; ++k)
+            {
+                double t = v[start + k * stride] / big;
+                sum += t * t;
+            }
+            return std::log2(big) + 0.5 * std::log2(sum);
+        };
+        rowBits.resize(m);
+        colBits.resize(n);
+        for (size_t i = 0; i < m; ++i)
+            rowBits[i] = log2Norm(i * n, n, 1);
+        for (size_t j = 0; j < n; ++j)
+            colBits[j] = log2Norm(j, m, n);
+    }
+
+    /**
+     * @brief 模p高斯-约当消元
+     *
+     * @param a             行主序的剩余，原地化为行阶梯形或行最简形
+     * @param m             行数
+     * @param n             列数（行距）
+     * @param pivotLimit    只在前pivotLimit列中选主元
+     * @param p             模数
+     * @param reduce        为true时化为行最简形，否则只做前向消元
+     * @param pivCols       输出：主元列
+     * @return uint64_t     各主元之积乘以行交换的符号
+     */
+    static uint64_t Eliminate(uint64_t *a, size_t m, size_t n, size_t pivotLimit, uint64_t p, bool reduce,
+                              std::vector<size_t> &pivCols)
+    {
+        uint64_t det = 1;
+        size_t r = 0;
+        for (size_t k = 0; k < pivotLimit && r < m; ++k)
+        {
+            size_t piv = r;
+            while (piv < m && a[piv * n + k] == 0)
+                ++piv;
+            if (piv == m)
+                continue;
+            if (piv != r)
+            {
+                for (size_t j = k; j < n; ++j)
+                    std::swap(a[piv * n + j], a[r * n + j]);
+                det = (p - det) % p;
+            }
+
+            uint64_t *pivRow = a + r * n;
+            //主元行化为首一，主元本身计入det
+            det = det * pivRow[k] % p;
+            uint64_t inv = PowMod(pivRow[k], p - 2, p);
+            for (size_t j = k; j < n; ++j)
+                pivRow[j] = pivRow[j] * inv % p;
+
+            size_t rowBegin = reduce ? 0 : r + 1;
+            MATRIX_PROFILE_EVENT(RecordFlops(2ull * (m - rowBegin) * (n - k)));
+            MatrixThreadPool::ParallelFor(rowBegin, m, 1 + 8192 / (n - k), [&](size_t b, size_t e)
+                                          {
+                                              for (size_t i = b; i < e; ++i)
+                                              {
+                                                  uint64_t *row = a + i * n;
+                                                  uint64_t f = row[k];
+                                                  if (i == r || f == 0)
+                                                      continue;
+                                                  f = p - f;
+                                                  for (size_t j = k; j < n; ++j)
+                                                      row[j] = (row[j] + f * pivRow[j]) % p;
+                                              }
+                                          });
+            pivCols.push_back(k);
+            ++r;
+        }
+        return det;
+    }
+
+    //x模p的非负剩余
+    static uint64_t Residue(const T &x, uint64_t p)
+    {
+        return Residue(x, p, std::is_integral<T>());
+    }
+
+    static uint64_t Residue(const T &x, uint64_t p, std::true_type)
+    {
+        if (!(x < T(0)))
+            return uint64_t(x) % p;
+        //-(x + 1)不会溢出
+        uint64_t m = (uint64_t(-(x + T(1))) % p + 1) % p;
+        return (p - m) % p;
+    }
+
+    static uint64_t Residue(const T &x, uint64_t p, std::false_type)
+    {
+        T m = x % static_cast<T>(p);
+        if (m < T(0))
+            m += static_cast<T>(p);
+        return static_cast<uint64_t>(m);
+    }
+
+    static uint64_t PowMod(uint64_t b, uint64_t e, uint64_t p)
+    {
+        uint64_t result = 1;
+        b %= p;
+        while (e)
+        {
+            if (e & 1)
+                result = result * b % p;
+            b = b * b % p;
+            e >>= 1;
+        }
+        return result;
+    }
+
+    //小于2³²的确定性Miller-Rabin素性检验（底数2、7、61）
+    static bool IsPrime(uint64_t n)
+    {
+        if (n < 2)
+            return false;
+        for (uint64_t q : {2ull, 3ull, 5ull, 7ull, 11ull, 13ull, 61ull})
+            if (n % q == 0)
+                return n == q;
+        uint64_t d = n - 1;
+        int s = 0;
+        while ((d & 1) == 0)
+        {
+            d >>= 1;
+            ++s;
+        }
+        for (uint64_t base : {2ull, 7ull, 61ull})
+        {
+            uint64_t x = PowMod(base, d, n);
+            if (x == 1 || x == n - 1)
+                continue;
+            bool composite = true;
+            for (int i = 1; i < s && composite; ++i)
+            {
+                x = x * x % n;
+                if (x == n - 1)
+                    composite = false;
+            }
+            if (composite)
+                return false;
+        }
+        return true;
+    }
+
+    //小于n的最大素数
+    static uint64_t PreviousPrime(uint64_t n)
+    {
+        do
+            --n;
+        while (!IsPrime(n));
+        return n;
+    }
+};
+
+/**
+ * @brief Cholesky分解
+ *
+ * 对对称正定矩阵进行分解 A = LLᵀ，L为下三角矩阵。
+ * 只读取A的下三角部分。复数元素时分解Hermite正定矩阵 A = LLᴴ，L的对角元为正实数。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class CholeskyDecomposition
+{
+private:
+    Matrix<T> L;                  //下三角因子
+    bool positiveDefinite = true; //是否正定
+
+public:
+    /**
+     * @brief Cholesky分解构造函数：分解对称（Hermite）正定矩阵
+     *
+     * @param mat 要分解的对称（Hermite）正定矩阵，对角元的虚部被忽略
+     */
+    explicit CholeskyDecomposition(const Matrix<T> &mat) : L(mat.RowSize(), mat.RowSize())
+    {
+        MATRIX_PROFILE_SCOPE("Cholesky");
+        assert(mat.RowSize() == mat.ColumnSize());
+        using std::sqrt;
+        typedef typename MatrixScalar<T>::Real R;
+
+        size_t n = mat.RowSize();
+        const T *a = mat.Data();
+        T *l = L.Data();
+        for (size_t i = 0; i < n && positiveDefinite; ++i)
+        {
+            if (i % 64 == 0)
+                MatrixJobControl::Checkpoint(double(i) * i * i / (double(n) * n * n));
+            T *pRowI = l + i * n;
+            for (size_t j = 0; j <= i; ++j)
+            {
+                //L的行连续存储，内积可以向量化
+                const T *pRowJ = l + j * n;
+                T sum = a[i * n + j];
+                for (size_t k = 0; k < j; ++k)
+                    sum -= pRowI[k] * MatrixScalar<T>::Conj(pRowJ[k]);
+
+                if (i == j)
+                {
+                    R diag = MatrixScalar<T>::RealPart(sum);
+                    if (!(diag > R(0)))
+                    {
+                        positiveDefinite = false;
+                        break;
+                    }
+                    pRowI[i] = T(sqrt(diag));
+                }
+                else
+                    pRowI[j] = sum / pRowJ[j];
+            }
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(1ull * n * n * n / 3));
+    }
+
+    /**
+     * @brief 矩阵是否正定
+     *
+     * @return 若分解成功，返回true
+     */
+    bool IsPositiveDefinite() const
+    {
+        return positiveDefinite;
+    }
+
+    /**
+     * @brief 获取下三角因子
+     *
+     * @return const Matrix<T>& 下三角因子L
+     */
+    const Matrix<T> &Factor() const
+    {
+        return L;
+    }
+
+    /**
+     * @brief 求解线性方程组 AX = B
+     *
+     * @param b 右端矩阵，行数与A相同，每一列为一个右端向量
+     * @return Matrix<T> 解矩阵X
+     */
+    Matrix<T> Solve(const Matrix<T> &b) const
+    {
+        MATRIX_PROFILE_SCOPE("CholeskySolve");
+        assert(positiveDefinite && b.RowSize() == L.RowSize());
+
+        size_t n = L.RowSize(), m = b.ColumnSize();
+        const T *l = L.Data();
+        Matrix<T> x(b);
+        T *px = x.Data();
+
+        //前代：LY = B
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t k = 0; k < i; ++k)
+                for (size_t j = 0; j < m; ++j)
+                    px[i * m + j] -= l[i * n + k] * px[k * m + j];
+            for (size_t j = 0; j < m; ++j)
+                px[i * m + j] /= l[i * n + i];
+        }
+
+        //回代：LᴴX = Y，按L的行访问以保证连续
+        for (size_t i = n; i-- > 0;)
+        {
+            for (size_t j = 0; j < m; ++j)
+                px[i * m + j] /= l[i * n + i];
+            for (size_t k = 0; k < i; ++k)
+            {
+                T lik = MatrixScalar<T>::Conj(l[i * n + k]);
+                for (size_t j = 0; j < m; ++j)
+                    px[k * m + j] -= lik * px[i * m + j];
+            }
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * n * n * m));
+        return x;
+    }
+};
+
+/**
+ * @brief 列选主元QR分解 AP = QR，用于判定数值秩
+ *
+ * 每一步选取剩余部分范数最大的列作为主元列。分解作用在Aᵀ的副本上，
+ * A的每一列是一段连续的行，反射对其余各列的更新按列并行；剩余列的范数按
+ * LAPACK dlaqp2的方式递推更新，误差过大时重新计算。
+ *
+ * 当剩余子块的Frobenius范数不大于 tol·||A||F 时提前停止，已完成的步数即为数值秩，
+ * 秩为r时运算量约为 4mnr，低秩矩阵只做少量工作。
+ *
+ * @tparam T 矩阵数据类型，要求为浮点类型
+ */
+template <typename T>
+class PivotedQRDecomposition
+{
+private:
+    size_t uRows = 0;              //A的行数
+    size_t uCols = 0;              //A的列数
+    size_t uRank = 0;              //数值秩
+    std::vector<T> w;              //Aᵀ的副本：第j行的前r个元素为R的第j列，其后为反射向量
+    std::vector<T> tau;            //反射系数
+    std::vector<size_t> pivots;    //主元列顺序
+    T residualNorm = T(0);         //停止时剩余子块的Frobenius范数
+    T normA = T(0);                //A的Frobenius范数
+
+    static const size_t uParallelGrain = 16384; //每个并行块至少处理的元素个数
+
+public:
+    /**
+     * @brief 列选主元QR分解构造函数
+     *
+     * @param mat   要分解的矩阵
+     * @param tol   相对容限，为负时使用 max(m, n)·ε
+     */
+    explicit PivotedQRDecomposition(const Matrix<T> &mat, T tol = T(-1))
+        : uRows(mat.RowSize()), uCols(mat.ColumnSize()), w(mat.RowSize() * mat.ColumnSize()), pivots(mat.ColumnSize())
+    {
+        MATRIX_PROFILE_SCOPE("PivotedQR");
+        if (tol < T(0))
+            tol = T(uRows > uCols ? uRows : uCols) * std::numeric_limits<T>::epsilon();
+
+        size_t m = uRows, n = uCols;
+        const T *a = mat.Data();
+        for (size_t i = 0; i < m; ++i)
+            for (size_t j = 0; j < n; ++j)
+                w[j * m + i] = a[i * n + j];
+
+        //vn1为各列剩余部分的范数，vn2为上次重新计算时的值
+        std::vector<T> vn1(n), vn2(n);
+        for (size_t j = 0; j < n; ++j)
+        {
+            vn1[j] = vn2[j] = Norm(w.data() + j * m, m);
+            pivots[j] = j;
+        }
+        normA = ScaledNorm(vn1, 0);
+
+        size_t steps = m < n ? m : n;
+        tau.assign(steps, T(0));
+        const T threshold = tol * normA;
+        const T tol3z = std::sqrt(std::numeric_limits<T>::epsilon());
+        for (size_t k = 0; k < steps; ++k)
+        {
+            residualNorm = ScaledNorm(vn1, k);
+            if (residualNorm <= threshold)
+                break;
+
+            size_t p = k;
+            for (size_t j = k + 1; j < n; ++j)
+                if (vn1[j] > vn1[p])
+                    p = j;
+            if (p != k)
+            {
+                std::swap_ranges(w.begin() + k * m, w.begin() + (k + 1) * m, w.begin() + p * m);
+                std::swap(vn1[k], vn1[p]);
+                std::swap(vn2[k], vn2[p]);
+                std::swap(pivots[k], pivots[p]);
+            }
+
+            T *wk = w.data() + k * m;
+            T scale;
+            T beta = MatrixKernel<T>::MakeReflector(wk[k], Norm(wk + k + 1, m - k - 1), tau[k], scale);
+            for (size_t i = k + 1; i < m; ++i)
+                wk[i] *= scale;
+            wk[k] = beta;
+            uRank = k + 1;
+
+            //对其余各列作用反射并递推更新范数，工作量小时不进入线程池
+            const T t = tau[k];
+            size_t len = m - k;
+            auto update = [&](size_t b, size_t e)
+            {
+                using std::abs;
+                for (size_t j = b; j < e; ++j)
+                {
+                    T *wj = w.data() + j * m;
+                    if (t != T(0))
+                    {
+                        T d = (wj[k] + MatrixKernel<T>::Dot(len - 1, wk + k + 1, 1, wj + k + 1, 1)) * t;
+                        wj[k] -= d;
+                        for (size_t i = k + 1; i < m; ++i)
+                            wj[i] -= d * wk[i];
+                    }
+                    if (vn1[j] == T(0))
+                        continue;
+                    T ratio = abs(wj[k]) / vn1[j];
+                    T temp = T(1) - ratio * ratio;
+                    if (temp < T(0))
+                        temp = T(0);
+                    T temp2 = temp * (vn1[j] / vn2[j]) * (vn1[j] / vn2[j]);
+                    if (temp2 <= tol3z)
+                        vn1[j] = vn2[j] = Norm(wj + k + 1, m - k - 1);
+                    else
+                        vn1[j] *= std::sqrt(temp);
+                }
+            };
+            if (len * (n - k - 1) < uParallelGrain)
+                update(k + 1, n);
+            else
+                MatrixThreadPool::ParallelFor(k + 1, n, uParallelGrain / len + 1, update);
+            MATRIX_PROFILE_EVENT(RecordFlops(4ull * len * (n - k - 1)));
+            if (k + 1 == steps)
+                residualNorm = ScaledNorm(vn1, k + 1);
+        }
+    }
+
+    /**
+     * @brief 数值秩
+     *
+     * @return size_t 使剩余子块的Frobenius范数不大于 tol·||A||F 的最小步数
+     */
+    size_t Rank() const
+    {
+        return uRank;
+    }
+
+    /**
+     * @brief 是否列满秩
+     */
+    bool FullColumnRank() const
+    {
+        return uRank == uCols;
+    }
+
+    /**
+     * @brief 主元列顺序，序号从0开始
+     *
+     * @return AP的第i列为A的第 Pivots()[i] 列
+     */
+    const std::vector<size_t> &Pivots() const
+    {
+        return pivots;
+    }
+
+    /**
+     * @brief 停止时剩余子块的Frobenius范数，即 ||AP - Q_r R_r||F
+     */
+    T ResidualNorm() const
+    {
+        return residualNorm;
+    }
+
+    /**
+     * @brief 上梯形因子R（按主元顺序排列的列）
+     *
+     * @return Matrix<T> r×n矩阵，r为数值秩
+     */
+    Matrix<T> R() const
+    {
+        Matrix<T> r(uRank, uCols);
+        for (size_t k = 0; k < uRank; ++k)
+            for (size_t j = k; j < uCols; ++j)
+                r.ElemAt0(k, j) = w[j * uRows + k];
+        return r;
+    }
+
+    /**
+     * @brief 正交因子Q的前r列
+     *
+     * @return Matrix<T> m×r矩阵，列相互正交
+     */
+    Matrix<T> Q() const
+    {
+        size_t m = uRows, r = uRank;
+        Matrix<T> q(m, r);
+        T *pq = q.Data();
+        for (size_t k = 0; k < r; ++k)
+            pq[k * r + k] = T(1);
+        std::vector<T> d(r);
+        for (size_t k = r; k-- > 0;)
+        {
+            if (tau[k] == T(0))
+                continue;
+            const T *v = w.data() + k * m;
+            //d = τ·vᵀQ[k:m]，Q[k:m] -= v·d
+            for (size_t c = 0; c < r; ++c)
+                d[c] = pq[k * r + c];
+            for (size_t i = k + 1; i < m; ++i)
+                for (size_t c = 0; c < r; ++c)
+                    d[c] += v[i] * pq[i * r + c];
+            for (size_t c = 0; c < r; ++c)
+            {
+                d[c] *= tau[k];
+                pq[k * r + c] -= d[c];
+            }
+            for (size_t i = k + 1; i < m; ++i)
+                for (size_t c = 0; c < r; ++c)
+                    pq[i * r + c] -= v[i] * d[c];
+        }
+        return q;
+    }
+
+private:
+    //平方和没有上溢或下溢时直接开方，否则使用缩放的范数
+    static bool SafeSquareSum(T ssq)
+    {
+        return ssq > std::numeric_limits<T>::min() / std::numeric_limits<T>::epsilon() && ssq < std::numeric_limits<T>::max();
+    }
+
+    static T Norm(const T *x, size_t n)
+    {
+        T ssq = MatrixKernel<T>::Dot(n, x, 1, x, 1);
+        if (ssq == T(0) || SafeSquareSum(ssq))
+            return std::sqrt(ssq);
+        return Vector<T>::Norm(VectorView<const T>(x, n));
+    }
+
+    //sqrt(Σ_{j≥k} v[j]²)
+    static T ScaledNorm(const std::vector<T> &v, size_t k)
+    {
+        T ssq = T(0);
+        for (size_t j = k; j < v.size(); ++j)
+            ssq += v[j] * v[j];
+        if (ssq == T(0) || SafeSquareSum(ssq))
+            return std::sqrt(ssq);
+
+        T scale = T(0);
+        for (size_t j = k; j < v.size(); ++j)
+            if (v[j] > scale)
+                scale = v[j];
+        if (scale == T(0))
+            return T(0);
+        T sum = T(0);
+        for (size_t j = k; j < v.size(); ++j)
+            sum += (v[j] / scale) * (v[j] / scale);
+        return scale * std::sqrt(sum);
+    }
+};
+
+/**
+ * @brief 对称矩阵特征分解
+ *
+ * 计算实对称矩阵的特征值与特征向量 A = VΛVᵀ，只读取A的下三角部分。
+ *
+ * 1. 分块Householder三对角化 A = QTQᵀ：每个面板（32列）内逐列生成反射并延迟更新，
+ *    面板结束后以两次GEMM完成尾部矩阵的秩2b更新；对称矩阵向量乘与GEMM均由线程池并行。
+ * 2. 隐式位移QL迭代求三对角矩阵T的特征值，每一轮的Givens旋转记录下来后按列并行作用于特征向量。
+ * 3. 只需最大的k个特征对时，先以不带向量的QL求出全部特征值（O(n²)），
+ *    再对其中k个用逆迭代求三对角矩阵的特征向量（相近特征值的向量相互正交化），
+ *    最后只对这k个向量做反变换，计算量约为 O(kn²)。
+ *
+ * 特征值按升序排列，第i个特征向量为 Eigenvectors() 的第i列，与第i个特征值对应。
+ *
+ * @tparam T 矩阵数据类型，要求为浮点类型
+ */
+template <typename T>
+class SymmetricEigenDecomposition
+{
+    //Hermite特征分解复用三对角矩阵的QL迭代与逆迭代
+    template <typename U>
+    friend class HermitianEigenDecomposition;
+
+public:
+    //计算内容
+    enum Mode
+    {
+        VALUES_ONLY, //只计算特征值
+        VECTORS,     //同时计算特征向量
+    };
+
+private:
+    Vector<T> values;      //特征值，升序
+    Matrix<T> vectors;     //特征向量，按列存放
+    bool converged = true; //QL迭代是否收敛
+
+    static const size_t uPanelWidth = 32; //三对角化的面板宽度
+    static const size_t uMaxSweeps = 60;  //每个特征值的最大QL迭代次数
+
+    //一次Givens旋转，作用于特征向量的第i行与第i+1行
+    struct Rotation
+    {
+        size_t i;
+        T c, s;
+    };
+
+public:
+    /**
+     * @brief 对称矩阵特征分解构造函数
+     *
+     * @param mat   实对称矩阵，只读取下三角部分
+     * @param mode  只求特征值或同时求特征向量
+     * @param count 只求最大的count个特征对，为0时求全部
+     */
+    explicit SymmetricEigenDecomposition(const Matrix<T> &mat, Mode mode = VECTORS, size_t count = 0)
+    {
+        MATRIX_PROFILE_SCOPE("SymmetricEigen");
+        assert(mat.RowSize() == mat.ColumnSize());
+        size_t n = mat.RowSize();
+        size_t k = (count == 0 || count > n) ? n : count;
+        if (n == 0)
+            return;
+
+        //由下三角部分构造完整的对称矩阵
+        Matrix<T> a(n, n);
+        T *pa = a.Data();
+        const T *src = mat.Data();
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j <= i; ++j)
+                pa[i * n + j] = pa[j * n + i] = src[i * n + j];
+
+        std::vector<T> d(n), e(n, T(0)), tau(n, T(0));
+        Tridiagonalize(pa, n, d.data(), e.data(), tau.data());
+
+        if (mode == VECTORS && k == n)
+        {
+            Matrix<T> zt = Matrix<T>::Identity(n);
+            converged = TridiagonalQL(d.data(), e.data(), n, zt.Data());
+            SortAscending(d.data(), n, zt.Data());
+            BackTransform(pa, tau.data(), n, zt.Data(), n);
+            values = Vector<T>(VectorView<const T>(d.data(), n));
+            vectors = zt.Transpose();
+            return;
+        }
+
+        std::vector<T> dt(d), et(e);
+        converged = TridiagonalQL(d.data(), e.data(), n, nullptr);
+        SortAscending(d.data(), n, nullptr);
+        values = Vector<T>(VectorView<const T>(d.data() + n - k, k));
+        if (mode == VALUES_ONLY)
+            return;
+
+        Matrix<T> zt(k, n);
+        InverseIteration(dt.data(), et.data(), n, values.Data(), k, zt.Data());
+        BackTransform(pa, tau.data(), n, zt.Data(), k);
+        vectors = zt.Transpose();
+    }
+
+    /**
+     * @brief 获取特征值
+     *
+     * @return const Vector<T>& 升序排列的特征值
+     */
+    const Vector<T> &Eigenvalues() const
+    {
+        return values;
+    }
+
+    /**
+     * @brief 获取特征向量
+     *
+     * 以 VECTORS 模式构造时有效。
+     *
+     * @return const Matrix<T>& n×k矩阵，第i列为第i个特征值对应的单位特征向量
+     */
+    const Matrix<T> &Eigenvectors() const
+    {
+        return vectors;
+    }
+
+    /**
+     * @brief QL迭代是否收敛
+     *
+     * @return 若所有特征值都在迭代次数限制内收敛，返回true
+     */
+    bool Converged() const
+    {
+        return converged;
+    }
+
+private:
+    /**
+     * @brief 分块Householder三对角化（对应LAPACK的dsytrd/dlatrd）
+     *
+     * 第i个反射 Hᵢ = I - τᵢvvᵀ 作用于下标i+1到n-1，v（首元素为1）存放于a的第i行第i+1列之后，
+     * Q = H₀H₁...Hₙ₋₂。面板内第i列先用已生成的反射更新（a -= VWᵀ + WVᵀ 的对应行），
+     * 尾部矩阵在面板结束后统一更新。
+     *
+     * @param a     n×n对称矩阵，行主序，会被改写
+     * @param n     阶数
+     * @param d     输出的对角元
+     * @param e     输出的次对角元，e[i]连接d[i]与d[i+1]，e[n-1]为0
+     * @param tau   输出的反射系数
+     */
+    static void Tridiagonalize(T *a, size_t n, T *d, T *e, T *tau)
+    {
+        MATRIX_PROFILE_SCOPE("Tridiagonalize");
+        using std::abs;
+        const size_t nb = uPanelWidth;
+        std::vector<T> V(n * nb), W(n * nb), w(n), tmp(nb), VT, WT;
+
+        for (size_t k = 0; k < n; k += nb)
+        {
+            size_t b = n - k < nb ? n - k : nb;
+            std::fill(V.begin(), V.end(), T(0));
+            std::fill(W.begin(), W.end(), T(0));
+
+            for (size_t j = 0; j < b; ++j)
+            {
+                size_t i = k + j;
+                T *ri = a + i * n;
+
+                //用本面板已生成的反射更新第i行 a[i][i:n]
+                if (j > 0)
+                {
+                    MatrixKernel<T>::Gemv(false, n - i, j, T(-1), V.data() + i * nb, nb, W.data() + i * nb, 1, T(1), ri + i, 1);
+                    MatrixKernel<T>::Gemv(false, n - i, j, T(-1), W.data() + i * nb, nb, V.data() + i * nb, 1, T(1), ri + i, 1);
+                }
+                d[i] = ri[i];
+                if (i + 1 == n)
+                    break;
+
+                //生成消去 a[i][i+2:n] 的反射
+                size_t m = n - i - 1;
+                T *v = ri + i + 1;
+                T alpha = v[0];
+                T xnorm = Vector<T>::Norm(VectorView<const T>(v + 1, m - 1));
+                if (xnorm == T(0))
+                {
+                    tau[i] = T(0);
+                    e[i] = alpha;
+                }
+                else
+                {
+                    T beta = std::hypot(alpha, xnorm);
+                    if (alpha >= T(0))
+                        beta = -beta;
+                    tau[i] = (beta - alpha) / beta;
+                    T scale = T(1) / (alpha - beta);
+                    for (size_t t = 1; t < m; ++t)
+                        v[t] *= scale;
+                    e[i] = beta;
+                }
+                v[0] = T(1);
+                for (size_t t = 0; t < m; ++t)
+                    V[(i + 1 + t) * nb + j] = v[t];
+
+                //w = τ(A₂₂v - V(Wᵀv) - W(Vᵀv))，再 w -= (τ/2)(wᵀv)v
+                if (tau[i] == T(0))
+                    continue;
+                const T *A22 = a + (i + 1) * n + i + 1;
+                MatrixKernel<T>::Gemv(false, m, m, tau[i], A22, n, v, 1, T(0), w.data(), 1);
+                if (j > 0)
+                {
+                    MatrixKernel<T>::Gemv(true, m, j, T(1), W.data() + (i + 1) * nb, nb, v, 1, T(0), tmp.data(), 1);
+                    MatrixKernel<T>::Gemv(false, m, j, -tau[i], V.data() + (i + 1) * nb, nb, tmp.data(), 1, T(1), w.data(), 1);
+                    MatrixKernel<T>::Gemv(true, m, j, T(1), V.data() + (i + 1) * nb, nb, v, 1, T(0), tmp.data(), 1);
+                    MatrixKernel<T>::Gemv(false, m, j, -tau[i], W.data() + (i + 1) * nb, nb, tmp.data(), 1, T(1), w.data(), 1);
+                }
+                T half = -tau[i] / T(2) * MatrixKernel<T>::Dot(m, w.data(), 1, v, 1);
+                MatrixKernel<T>::Axpy(m, half, v, 1, w.data(), 1);
+                for (size_t t = 0; t < m; ++t)
+                    W[(i + 1 + t) * nb + j] = w[t];
+            }
+
+            //尾部矩阵的秩2b更新 A₂₂ -= VWᵀ + WVᵀ
+            size_t s = k + b;
+            if (s >= n)
+                continue;
+            size_t m = n - s;
+            VT.assign(b * m, T(0));
+            WT.assign(b * m, T(0));
+            for (size_t r = 0; r < m; ++r)
+                for (size_t p = 0; p < b; ++p)
+                {
+                    VT[p * m + r] = V[(s + r) * nb + p];
+                    WT[p * m + r] = W[(s + r) * nb + p];
+                }
+            T *A22 = a + s * n + s;
+            MatrixKernel<T>::Gemm(m, m, b, T(-1), V.data() + s * nb, nb, WT.data(), m, T(1), A22, n);
+            MatrixKernel<T>::Gemm(m, m, b, T(-1), W.data() + s * nb, nb, VT.data(), m, T(1), A22, n);
+        }
+        e[n - 1] = T(0);
+    }
+
+    /**
+     * @brief 隐式位移QL迭代求对称三对角矩阵的特征值
+     *
+     * 若zt非空，每轮迭代的旋转按列分段并行地作用于zt的行，
+     * 结束时zt的第i行为d[i]对应的特征向量（在zt初值的基下）。
+     *
+     * @param d     对角元，输出特征值（未排序）
+     * @param e     次对角元，会被改写
+     * @param n     阶数
+     * @param zt    n×n矩阵或nullptr
+     * @return 若全部收敛，返回true
+     */
+    static bool TridiagonalQL(T *d, T *e, size_t n, T *zt)
+    {
+        MATRIX_PROFILE_SCOPE("TridiagonalQL");
+        using std::abs;
+        const T eps = std::numeric_limits<T>::epsilon();
+        std::vector<Rotation> rotations;
+        bool ok = true;
+
+        for (size_t l = 0; l < n; ++l)
+        {
+            size_t iter = 0, m;
+            do
+            {
+                for (m = l; m + 1 < n; ++m)
+                    if (abs(e[m]) <= eps * (abs(d[m]) + abs(d[m + 1])))
+                        break;
+                if (m == l)
+                    break;
+                if (iter++ == uMaxSweeps)
+                {
+                    ok = false;
+                    break;
+                }
+
+                //Wilkinson位移
+                T g = (d[l + 1] - d[l]) / (T(2) * e[l]);
+                T r = std::hypot(g, T(1));
+                g = d[m] - d[l] + e[l] / (g + (g >= T(0) ? r : -r));
+                T s = T(1), c = T(1), p = T(0);
+                bool deflated = false;
+                rotations.clear();
+                for (size_t i = m; i-- > l;)
+                {
+                    T f = s * e[i], b = c * e[i];
+                    r = std::hypot(f, g);
+                    e[i + 1] = r;
+                    if (r == T(0))
+                    {
+                        d[i + 1] -= p;
+                        e[m] = T(0);
+                        deflated = true;
+                        break;
+                    }
+                    s = f / r;
+                    c = g / r;
+                    g = d[i + 1] - p;
+                    r = (d[i] - g) * s + T(2) * c * b;
+                    p = s * r;
+                    d[i + 1] = g + p;
+                    g = c * r - b;
+                    if (zt)
+                        rotations.push_back(Rotation{i, c, s});
+                }
+                if (zt && !rotations.empty())
+                    ApplyRotations(rotations, zt, n);
+                if (deflated)
+                    continue;
+                d[l] -= p;
+                e[l] = g;
+                e[m] = T(0);
+            } while (true);
+        }
+        return ok;
+    }
+
+    //把一轮QL的旋转依次作用于zt的行，按列分段并行
+    static void ApplyRotations(const std::vector<Rotation> &rotations, T *zt, size_t n)
+    {
+        MATRIX_PROFILE_EVENT(RecordFlops(6ull * rotations.size() * n));
+        MatrixThreadPool::ParallelFor(0, n, 512, [&](size_t b, size_t e)
+                                      {
+                                          for (const Rotation &rot : rotations)
+                                          {
+                                              T *MATRIX_RESTRICT z0 = zt + rot.i * n;
+                                              T *MATRIX_RESTRICT z1 = z0 + n;
+                                              for (size_t k = b; k < e; ++k)
+                                              {
+                                                  T f = z1[k];
+                                                  z1[k] = rot.s * z0[k] + rot.c * f;
+                                                  z0[k] = rot.c * z0[k] - rot.s * f;
+                                              }
+                                          }
+                                      });
+    }
+
+    //特征值升序排序，zt非空时同时重排其行
+    static void SortAscending(T *d, size_t n, T *zt)
+    {
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [d](size_t x, size_t y)
+                         { return d[x] < d[y]; });
+
+        std::vector<T> sorted(n);
+        for (size_t i = 0; i < n; ++i)
+            sorted[i] = d[order[i]];
+        std::copy(sorted.begin(), sorted.end(), d);
+        if (!zt)
+            return;
+
+        std::vector<T> rows(n * n);
+        for (size_t i = 0; i < n; ++i)
+            std::copy(zt + order[i] * n, zt + order[i] * n + n, rows.begin() + i * n);
+        std::copy(rows.begin(), rows.end(), zt);
+    }
+
+    /**
+     * @brief 反变换：把三对角矩阵的特征向量y变为A的特征向量Qy
+     *
+     * zt的每一行为yᵀ，(Qy)ᵀ = yᵀHₙ₋₂...H₀，即依次右乘 Hₙ₋₂, ..., H₀。
+     *
+     * 按行分段并行，每32行为一组依次作用所有反射，反射向量在组内复用。
+     *
+     * @param a     Tridiagonalize 改写后的矩阵
+     * @param tau   反射系数
+     * @param n     阶数
+     * @param zt    rows×n矩阵，每行为三对角矩阵的一个特征向量
+     * @param rows  行数
+     */
+    static void BackTransform(const T *a, const T *tau, size_t n, T *zt, size_t rows)
+    {
+        MATRIX_PROFILE_SCOPE("EigenBackTransform");
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * rows * n * n));
+        MatrixThreadPool::ParallelFor(0, rows, 8, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t r0 = b; r0 < e; r0 += 32)
+                                          {
+                                              size_t r1 = r0 + 32 < e ? r0 + 32 : e;
+                                              for (size_t i = n - 1; i-- > 0;)
+                                              {
+                                                  if (tau[i] == T(0))
+                                                      continue;
+                                                  size_t m = n - i - 1;
+                                                  const T *MATRIX_RESTRICT v = a + i * n + i + 1;
+                                                  for (size_t r = r0; r < r1; ++r)
+                                                  {
+                                                      T *MATRIX_RESTRICT z = zt + r * n + i + 1;
+                                                      T dot = T(0);
+                                                      for (size_t t = 0; t < m; ++t)
+                                                          dot += z[t] * v[t];
+                                                      dot *= tau[i];
+                                                      for (size_t t = 0; t < m; ++t)
+                                                          z[t] -= dot * v[t];
+                                                  }
+                                              }
+                                          }
+                                      });
+    }
+
+    /**
+     * @brief 逆迭代求三对角矩阵指定特征值的特征向量（对应LAPACK的dstein）
+     *
+     * 对 T - λI 做部分选主元LU分解后反复求解，相距不超过 10⁻³||T|| 的特征值视为一簇，
+     * 簇内的向量用修正Gram-Schmidt相互正交化；簇内过近的特征值略作扰动以免得到相同的向量。
+     *
+     * @param d         对角元
+     * @param e         次对角元
+     * @param n         阶数
+     * @param lambda    升序排列的特征值
+     * @param k         特征值个数
+     * @param zt        输出的k×n矩阵，第j行为lambda[j]对应的单位特征向量
+     */
+    static void InverseIteration(const T *d, const T *e, size_t n, const T *lambda, size_t k, T *zt)
+    {
+        MATRIX_PROFILE_SCOPE("InverseIteration");
+        using std::abs;
+        const T eps = std::numeric_limits<T>::epsilon();
+        T tnorm = T(0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            T rowSum = abs(d[i]) + abs(e[i]) + (i > 0 ? abs(e[i - 1]) : T(0));
+            if (rowSum > tnorm)
+                tnorm = rowSum;
+        }
+        T pivotFloor = eps * (tnorm > T(0) ? tnorm : T(1));
+        T clusterGap = T(1e-3) * tnorm;
+
+        std::vector<T> u0(n), u1(n), u2(n), l(n), x(n);
+        std::vector<char> swapped(n);
+        size_t clusterStart = 0;
+        T shift = T(0);
+        for (size_t j = 0; j < k; ++j)
+        {
+            T lam = lambda[j];
+            if (j > 0 && lam - lambda[j - 1] <= clusterGap)
+            {
+                if (lam <= shift + T(10) * pivotFloor)
+                    lam = shift + T(10) * pivotFloor;
+            }
+            else
+                clusterStart = j;
+            shift = lam;
+
+            //T - λI 的部分选主元LU分解，U有两条上次对角线
+            u0[0] = d[0] - lam;
+            u1[0] = n > 1 ? e[0] : T(0);
+            u2[0] = T(0);
+            for (size_t i = 0; i + 1 < n; ++i)
+            {
+                T sub = e[i], diag = d[i + 1] - lam, sup = i + 2 < n ? e[i + 1] : T(0);
+                if (abs(u0[i]) >= abs(sub))
+                {
+                    swapped[i] = 0;
+                    l[i] = u0[i] == T(0) ? T(0) : sub / u0[i];
+                    u0[i + 1] = diag - l[i] * u1[i];
+                    u1[i + 1] = sup - l[i] * u2[i];
+                }
+                else
+                {
+                    swapped[i] = 1;
+                    l[i] = u0[i] / sub;
+                    u0[i + 1] = u1[i] - l[i] * diag;
+                    u1[i + 1] = u2[i] - l[i] * sup;
+                    u0[i] = sub;
+                    u1[i] = diag;
+                    u2[i] = sup;
+                }
+                u2[i + 1] = T(0);
+            }
+            for (size_t i = 0; i < n; ++i)
+                if (abs(u0[i]) < pivotFloor)
+                    u0[i] = u0[i] < T(0) ? -pivotFloor : pivotFloor;
+
+            //以确定的伪随机向量为初值
+            uint32_t bits[4];
+            for (size_t i = 0; i < n; ++i)
+            {
+                MatrixRandom::Philox(j, i, bits);
+                x[i] = T(MatrixRandom::ToUniform(bits[0], bits[1]) - 0.5);
+            }
+
+            T *z = zt + j * n;
+            for (int it = 0; it < 4; ++it)
+            {
+                for (size_t i = 0; i + 1 < n; ++i)
+                {
+                    if (swapped[i])
+                        std::swap(x[i], x[i + 1]);
+                    x[i + 1] -= l[i] * x[i];
+                }
+                for (size_t i = n; i-- > 0;)
+                {
+                    T sum = x[i];
+                    if (i + 1 < n)
+                        sum -= u1[i] * x[i + 1];
+                    if (i + 2 < n)
+                        sum -= u2[i] * x[i + 2];
+                    x[i] = sum / u0[i];
+                }
+
+                for (size_t p = clusterStart; p < j; ++p)
+                {
+                    const T *zp = zt + p * n;
+                    T dot = MatrixKernel<T>::Dot(n, x.data(), 1, zp, 1);
+                    MatrixKernel<T>::Axpy(n, -dot, zp, 1, x.data(), 1);
+                }
+                T norm = Vector<T>::Norm(VectorView<const T>(x.data(), n));
+                if (norm == T(0))
+                    x[j % n] = norm = T(1);
+                for (size_t i = 0; i < n; ++i)
+                    x[i] /= norm;
+            }
+            std::copy(x.begin(), x.end(), z);
+        }
+    }
+};
+
+/**
+ * @brief Hermite矩阵特征分解
+ *
+ * 计算复Hermite矩阵的特征值与特征向量 A = VΛVᴴ，只读取A的下三角部分，特征值为实数。
+ *
+ * 1. 复Householder三对角化 A = QTQᴴ（对应LAPACK的zhetd2）：反射 Hᵢ = I - τᵢvvᴴ 的β取实数，
+ *    因此T是实对称三对角矩阵；每步的Hermite秩2更新 A₂₂ -= vwᴴ + wvᴴ 按行并行。
+ * 2. T的特征值与特征向量使用 SymmetricEigenDecomposition 的隐式QL迭代与逆迭代，
+ *    只需最大的k个特征对时同样先求全部特征值，再对其中k个逆迭代。
+ * 3. 把实特征向量y反变换为 Qy = H₀(H₁(...Hₙ₋₂y))，按特征向量并行。
+ *
+ * 特征值按升序排列，第i个特征向量为 Eigenvectors() 的第i列，与第i个特征值对应。
+ *
+ * @tparam T 矩阵数据类型，要求为 std::complex<浮点类型>；实数类型时等价于对称特征分解
+ */
+template <typename T>
+class HermitianEigenDecomposition
+{
+public:
+    typedef typename MatrixScalar<T>::Real Real; //特征值的类型
+
+    //计算内容
+    enum Mode
+    {
+        VALUES_ONLY, //只计算特征值
+        VECTORS,     //同时计算特征向量
+    };
+
+private:
+    Vector<Real> values;   //特征值，升序
+    Matrix<T> vectors;     //特征向量，按列存放
+    bool converged = true; //QL迭代是否收敛
+
+public:
+    /**
+     * @brief Hermite矩阵特征分解构造函数
+     *
+     * @param mat   Hermite矩阵，只读取下三角部分，对角元的虚部被忽略
+     * @param mode  只求特征值或同时求特征向量
+     * @param count 只求最大的count个特征对，为0时求全部
+     */
+    explicit HermitianEigenDecomposition(const Matrix<T> &mat, Mode mode = VECTORS, size_t count = 0)
+    {
+        MATRIX_PROFILE_SCOPE("HermitianEigen");
+        assert(mat.RowSize() == mat.ColumnSize());
+        typedef SymmetricEigenDecomposition<Real> Tridiagonal;
+        size_t n = mat.RowSize();
+        size_t k = (count == 0 || count > n) ? n : count;
+        if (n == 0)
+            return;
+
+        //由下三角部分构造完整的Hermite矩阵
+        Matrix<T> a(n, n);
+        T *pa = a.Data();
+        const T *src = mat.Data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                pa[i * n + j] = src[i * n + j];
+                pa[j * n + i] = MatrixScalar<T>::Conj(src[i * n + j]);
+            }
+            pa[i * n + i] = T(MatrixScalar<T>::RealPart(src[i * n + i]));
+        }
+
+        std::vector<Real> d(n), e(n, Real(0));
+        std::vector<T> tau(n, T(0));
+        Tridiagonalize(pa, n, d.data(), e.data(), tau.data());
+
+        std::vector<Real> dt(d), et(e);
+        Matrix<Real> zt;
+        if (mode == VECTORS && k == n)
+        {
+            zt = Matrix<Real>::Identity(n);
+            converged = Tridiagonal::TridiagonalQL(d.data(), e.data(), n, zt.Data());
+            Tridiagonal::SortAscending(d.data(), n, zt.Data());
+            values = Vector<Real>(VectorView<const Real>(d.data(), n));
+        }
+        else
+        {
+            converged = Tridiagonal::TridiagonalQL(d.data(), e.data(), n, nullptr);
+            Tridiagonal::SortAscending(d.data(), n, nullptr);
+            values = Vector<Real>(VectorView<const Real>(d.data() + n - k, k));
+            if (mode == VALUES_ONLY)
+                return;
+            zt = Matrix<Real>(k, n);
+            Tridiagonal::InverseIteration(dt.data(), et.data(), n, values.Data(), k, zt.Data());
+        }
+        vectors = BackTransform(pa, tau.data(), n, zt.Data(), k);
+    }
+
+    /**
+     * @brief 获取特征值
+     *
+     * @return const Vector<Real>& 升序排列的实特征值
+     */
+    const Vector<Real> &Eigenvalues() const
+    {
+        return values;
+    }
+
+    /**
+     * @brief 获取特征向量
+     *
+     * 以 VECTORS 模式构造时有效。
+     *
+     * @return const Matrix<T>& n×k矩阵，第i列为第i个特征值对应的单位特征向量
+     */
+    const Matrix<T> &Eigenvectors() const
+    {
+        return vectors;
+    }
+
+    /**
+     * @brief QL迭代是否收敛
+     *
+     * @return 若所有特征值都在迭代次数限制内收敛，返回true
+     */
+    bool Converged() const
+    {
+        return converged;
+    }
+
+private:
+    /**
+     * @brief 复Householder三对角化（对应LAPACK的zhetd2）
+     *
+     * 第i个反射 Hᵢ 满足 Hᵢᴴ[α; x] = [β; 0]，β为实数，v（首元素为1）存放于a的第i行第i+1列之后。
+     * 取 w = τA₂₂v，w += -(τ/2)(wᴴv)v，则 HᵢᴴA₂₂Hᵢ = A₂₂ - vwᴴ - wvᴴ。
+     *
+     * @param a     n×n Hermite矩阵，行主序，会被改写
+     * @param n     阶数
+     * @param d     输出的对角元
+     * @param e     输出的次对角元，e[n-1]为0
+     * @param tau   输出的反射系数
+     */
+    static void Tridiagonalize(T *a, size_t n, Real *d, Real *e, T *tau)
+    {
+        MATRIX_PROFILE_SCOPE("HermitianTridiagonalize");
+        std::vector<T> w(n);
+        for (size_t i = 0; i + 1 < n; ++i)
+        {
+            d[i] = MatrixScalar<T>::RealPart(a[i * n + i]);
+
+            //第i行右侧是第i列下方元素的共轭，原地改写为v
+            size_t m = n - i - 1;
+            T *v = a + i * n + i + 1;
+            for (size_t t = 0; t < m; ++t)
+                v[t] = MatrixScalar<T>::Conj(v[t]);
+            T alpha = v[0];
+            Real xnorm = Vector<T>::Norm(VectorView<const T>(v + 1, m - 1));
+            Real ar = MatrixScalar<T>::RealPart(alpha), ai = MatrixScalar<T>::ImagPart(alpha);
+            if (xnorm == Real(0) && ai == Real(0))
+            {
+                tau[i] = T(0);
+                e[i] = ar;
+                continue;
+            }
+            Real beta = std::hypot(std::hypot(ar, ai), xnorm);
+            if (ar >= Real(0))
+                beta = -beta;
+            tau[i] = MatrixScalar<T>::Compose((beta - ar) / beta, -ai / beta);
+            T scale = T(1) / (alpha - T(beta));
+            for (size_t t = 1; t < m; ++t)
+                v[t] *= scale;
+            v[0] = T(1);
+            e[i] = beta;
+
+            //w = τA₂₂v - (τ/2)(wᴴv)v
+            T *A22 = a + (i + 1) * n + i + 1;
+            MatrixKernel<T>::Gemv(false, m, m, tau[i], A22, n, v, 1, T(0), w.data(), 1);
+            T wv = T(0);
+            for (size_t t = 0; t < m; ++t)
+                wv += MatrixScalar<T>::Conj(w[t]) * v[t];
+            T half = -tau[i] * wv / T(2);
+            for (size_t t = 0; t < m; ++t)
+                w[t] += half * v[t];
+
+            //A₂₂ -= vwᴴ + wvᴴ，按行并行
+            MATRIX_PROFILE_EVENT(RecordFlops(8ull * m * m));
+            const T *pw = w.data();
+            size_t grain = m >= (size_t(1) << 13) ? 1 : (size_t(1) << 13) / m;
+            MatrixThreadPool::ParallelFor(0, m, grain, [=](size_t r0, size_t r1)
+                                          {
+                                              for (size_t r = r0; r < r1; ++r)
+                                              {
+                                                  T *MATRIX_RESTRICT row = A22 + r * n;
+                                                  T vr = v[r], wr = pw[r];
+                                                  for (size_t c = 0; c < m; ++c)
+                                                      row[c] -= vr * MatrixScalar<T>::Conj(pw[c]) + wr * MatrixScalar<T>::Conj(v[c]);
+                                              }
+                                          });
+        }
+        d[n - 1] = MatrixScalar<T>::RealPart(a[(n - 1) * n + n - 1]);
+        e[n - 1] = Real(0);
+    }
+
+    /**
+     * @brief 反变换：把三对角矩阵的实特征向量y变为A的特征向量Qy
+     *
+     * 依次作用 Hₙ₋₂, ..., H₀：z -= τᵢv(vᴴz)，按特征向量并行。
+     *
+     * @param a     Tridiagonalize 改写后的矩阵
+     * @param tau   反射系数
+     * @param n     阶数
+     * @param zt    rows×n实矩阵，每行为三对角矩阵的一个特征向量
+     * @param rows  特征向量个数
+     * @return Matrix<T> n×rows矩阵，按列存放A的特征向量
+     */
+    static Matrix<T> BackTransform(const T *a, const T *tau, size_t n, const Real *zt, size_t rows)
+    {
+        MATRIX_PROFILE_SCOPE("HermitianBackTransform");
+        MATRIX_PROFILE_EVENT(RecordFlops(8ull * rows * n * n));
+        Matrix<T> z(rows, n);
+        T *pz = z.Data();
+        MatrixThreadPool::ParallelFor(0, rows, 1, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t r = b; r < e; ++r)
+                                          {
+                                              T *MATRIX_RESTRICT x = pz + r * n;
+                                              for (size_t t = 0; t < n; ++t)
+                                                  x[t] = T(zt[r * n + t]);
+                                              for (size_t i = n - 1; i-- > 0;)
+                                              {
+                                                  if (tau[i] == T(0))
+                                                      continue;
+                                                  size_t m = n - i - 1;
+                                                  const T *v = a + i * n + i + 1;
+                                                  T *y = x + i + 1;
+                                                  T s = T(0);
+                                                  for (size_t t = 0; t < m; ++t)
+                                                      s += MatrixScalar<T>::Conj(v[t]) * y[t];
+                                                  s *= tau[i];
+                                                  for (size_t t = 0; t < m; ++t)
+                                                      y[t] -= s * v[t];
+                                              }
+                                          }
+                                      });
+        return z.Transpose();
+    }
+};
+
+/**
+ * @brief 奇异值分解
+ *
+ * 计算 A = UΣVᵀ，奇异值按降序排列。设 m×n 矩阵 A 满足 m ≥ n（否则分解Aᵀ后交换U与V）：
+ *
+ * 1. TSQR：把A按行分成若干约1MB大小的块，各块并行做Householder QR，
+ *    所得的三角因子再按二叉树两两合并（利用三角结构，每次合并约 2n³/3 次运算），得到 A = QR。
+ * 2. 单边Jacobi：对Rᵀ的行两两做旋转直至相互正交（行主序下行是连续的），
+ *    每一轮按循环赛顺序选出n/2个互不相交的行对并行旋转。
+ * 3. THIN 模式下，左奇异向量 U = Q·U_R 由树与各块的反射依次作用于U_R得到，不构造m×m矩阵。
+ *
+ * 高瘦矩阵（如1M×200）的计算量约为 2mn²（只求奇异值）或 6mn²（同时求U与V），主要部分按块并行。
+ *
+ * @tparam T 矩阵数据类型，要求为浮点类型
+ */
+template <typename T>
+class SingularValueDecomposition
+{
+public:
+    //计算内容
+    enum Mode
+    {
+        VALUES_ONLY, //只计算奇异值
+        THIN,        //同时计算 m×k 的U与 n×k 的V，k = min(m, n)
+    };
+
+private:
+    Vector<T> sigma;       //奇异值，降序
+    Matrix<T> u;           //左奇异向量，按列存放
+    Matrix<T> v;           //右奇异向量，按列存放
+    size_t uRows = 0;      //原矩阵行数
+    size_t uCols = 0;      //原矩阵列数
+    bool converged = true; //Jacobi迭代是否收敛
+
+    static const size_t uMaxSweeps = 60;         //Jacobi的最大轮数
+    static const size_t uLeafElements = 1 << 17; //TSQR每块的目标元素个数
+
+    //TSQR合并树的一个节点：[R_left; R_right] = Q_node·R
+    struct TreeNode
+    {
+        size_t left, right;
+        std::vector<T> vb;  //反射向量在下半部分的分量，上三角存放
+        std::vector<T> tau; //反射系数
+    };
+
+public:
+    /**
+     * @brief 奇异值分解构造函数
+     *
+     * @param mat   要分解的矩阵
+     * @param mode  只求奇异值或同时求U与V
+     * @param rank  只保留最大的rank个奇异值（及对应的奇异向量），为0时全部保留
+     */
+    explicit SingularValueDecomposition(const Matrix<T> &mat, Mode mode = THIN, size_t rank = 0)
+        : uRows(mat.RowSize()), uCols(mat.ColumnSize())
+    {
+        MATRIX_PROFILE_SCOPE("SVD");
+        size_t k = uRows < uCols ? uRows : uCols;
+        if (k == 0)
+            return;
+
+        bool wantVectors = mode == THIN;
+        if (uRows >= uCols)
+            converged = Factor(mat.Data(), uRows, uCols, wantVectors, sigma, u, v);
+        else
+        {
+            Matrix<T> t = mat.Transpose();
+            converged = Factor(t.Data(), uCols, uRows, wantVectors, sigma, v, u);
+        }
+
+        if (rank == 0 || rank >= k)
+            return;
+        sigma = Vector<T>(VectorView<const T>(sigma.Data(), rank));
+        if (wantVectors)
+        {
+            u = TruncateColumns(u, rank);
+            v = TruncateColumns(v, rank);
+        }
+    }
+
+    /**
+     * @brief 获取奇异值
+     *
+     * @return const Vector<T>& 降序排列的奇异值
+     */
+    const Vector<T> &SingularValues() const
+    {
+        return sigma;
+    }
+
+    /**
+     * @brief 获取左奇异向量
+     *
+     * 以 THIN 模式构造时有效。
+     *
+     * @return const Matrix<T>& m×k矩阵，列相互正交
+     */
+    const Matrix<T> &U() const
     {
-#ifdef MATRIX_INDEX_START_AT_0
-        return InsertRow(uRow, rowData.data(), rowData.size());
-#else
-        return InsertRow(uRow + 1, rowData.data(), rowData.size());
-#endif
+        return u;
     }
 
-public:
     /**
-        @brief 矩阵最右侧添加一列数据，可能会引起数据扩增
+     * @brief 获取右奇异向量
+     *
+     * 以 THIN 模式构造时有效。
+     *
+     * @return const Matrix<T>& n×k矩阵，列相互正交
+     */
+    const Matrix<T> &V() const
+    {
+        return v;
+    }
 
-        @param pNewColData	要添加的列数据的指针
-        @param dataSize		要添加的列数据的个数，若少于行数，将使用0补齐
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &AddColumn(const T *pNewColData, size_t dataSize)
+    /**
+     * @brief Jacobi迭代是否收敛
+     *
+     * @return 若在轮数限制内收敛，返回true
+     */
+    bool Converged() const
     {
-#ifdef MATRIX_INDEX_START_AT_0
-        return InsertColumn(uCol, pNewColData, dataSize);
-#else
-        return InsertColumn(uCol + 1, pNewColData, dataSize);
-#endif
+        return converged;
     }
 
-public:
     /**
-        @brief 矩阵最右侧添加一列数据，可能会引起数据扩增
+     * @brief 数值秩：大于阈值的奇异值个数
+     *
+     * @param tol 阈值，为负时使用 max(m, n)·ε·σ₁
+     * @return size_t 数值秩
+     */
+    size_t Rank(T tol = T(-1)) const
+    {
+        if (tol < T(0))
+            tol = DefaultTolerance();
+        size_t r = 0;
+        while (r < sigma.Size() && sigma[r] > tol)
+            ++r;
+        return r;
+    }
 
-        @param colData	要添加的列数据的指针
-        @return Matrix<T>&  本对象的引用
-    */
-    Matrix<T> &AddColumn(const std::vector<T> &colData)
+    /**
+     * @brief 2范数条件数 σ₁/σₖ
+     *
+     * @return T 条件数，最小奇异值为0时为无穷大
+     */
+    T ConditionNumber() const
     {
-#ifdef MATRIX_INDEX_START_AT_0
-        return InsertColumn(uCol, colData.data(), colData.size());
-#else
-        return InsertColumn(uCol + 1, colData.data(), colData.size());
-#endif
+        assert(sigma.Size() > 0);
+        T smallest = sigma[sigma.Size() - 1];
+        return smallest == T(0) ? std::numeric_limits<T>::infinity() : sigma[0] / smallest;
     }
 
-public:
     /**
-     * @brief 获取矩阵区块
-     * 
-     *  若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-     *  否则从1开始。
-     * 
-     * @param rowStart      区块行起始序号
-     * @param colStart      区块列起始序号
-     * @param rowSpan       区块行数
-     * @param colSpan       区块列数
-     * @return Matrix<T>    区块拷贝得到的矩阵
+     * @brief Moore-Penrose伪逆 A⁺ = VΣ⁺Uᵀ
+     *
+     * 不大于阈值的奇异值视为0。以 THIN 模式构造时有效。
+     *
+     * @param tol 阈值，为负时使用 max(m, n)·ε·σ₁
+     * @return Matrix<T> n×m伪逆矩阵
      */
-    Matrix<T> Block(size_t rowStart, size_t colStart, size_t rowSpan, size_t colSpan)
+    Matrix<T> PseudoInverse(T tol = T(-1)) const
     {
-        //这个V0.3新加的函数用0为序号基准
-#ifndef MATRIX_INDEX_START_AT_0
-        --rowStart;
-        --colStart;
-#endif
-        assert(rowStart < uRow && colStart < uCol);
-        rowSpan = rowSpan + rowStart > uRow ? uRow - rowStart : rowSpan;
-        colSpan = colSpan + colStart > uCol ? uCol - colStart : colSpan;
+        MATRIX_PROFILE_SCOPE("PseudoInverse");
+        assert(u.RowSize() == uRows && v.RowSize() == uCols);
+        size_t r = Rank(tol);
+        Matrix<T> result(uCols, uRows);
+        if (r == 0)
+            return result;
+
+        //VΣ⁺（只取前r列）乘以Uᵀ的前r行
+        Matrix<T> vs(uCols, r), ut(r, uRows);
+        for (size_t i = 0; i < uCols; ++i)
+            for (size_t c = 0; c < r; ++c)
+                vs.ElemAt0(i, c) = v.ElemAt0(i, c) / sigma[c];
+        for (size_t i = 0; i < uRows; ++i)
+            for (size_t c = 0; c < r; ++c)
+                ut.ElemAt0(c, i) = u.ElemAt0(i, c);
+        MatrixKernel<T>::Gemm(uCols, uRows, r, T(1), vs.Data(), r, ut.Data(), uRows, T(0), result.Data(), uRows);
+        return result;
+    }
 
-        Matrix<T> blockMat(rowSpan, colSpan);
-        for (size_t i = 0; i < rowSpan; ++i)
-            for (size_t j = 0; j < colSpan; ++j)
-                blockMat.ElemAt0(i, j) = this->ElemAt0(i + rowStart, j + colStart);
+private:
+    T DefaultTolerance() const
+    {
+        if (sigma.Size() == 0)
+            return T(0);
+        return T(uRows > uCols ? uRows : uCols) * std::numeric_limits<T>::epsilon() * sigma[0];
+    }
 
-        return blockMat;
+    static Matrix<T> TruncateColumns(const Matrix<T> &mat, size_t cols)
+    {
+        Matrix<T> r(mat.RowSize(), cols);
+        for (size_t i = 0; i < mat.RowSize(); ++i)
+            for (size_t j = 0; j < cols; ++j)
+                r.ElemAt0(i, j) = mat.ElemAt0(i, j);
+        return r;
     }
 
-public:
     /**
-        @brief 将该矩阵与参数中的矩阵合并
-
-        LEFT	    将mat置于左侧合并，要求行数相同
-        RIGHT	    将mat置于右侧合并，要求行数相同
-        ABOVE	    将mat置于上方合并，要求列数相同
-        BELOW	    将mat置于下方合并，要求列数相同
-        TOPLEFT	    将mat置于左上角合并，其余位置补0
-        TOPRIGHT    将mat置于右上角合并，其余位置补0
-        BOTLEFT	    将mat置于左下角合并，其余位置补0
-        BOTRIGHT	将mat置于右下角合并，其余位置补0
+     * @brief 分解 m×n（m ≥ n）的行主序矩阵
+     *
+     * @param a             矩阵数据
+     * @param m             行数
+     * @param n             列数
+     * @param wantVectors   是否计算奇异向量
+     * @param s             输出的奇异值
+     * @param U             输出的 m×n 左奇异向量
+     * @param V             输出的 n×n 右奇异向量
+     * @return 若Jacobi迭代收敛，返回true
+     */
+    static bool Factor(const T *a, size_t m, size_t n, bool wantVectors, Vector<T> &s, Matrix<T> &U, Matrix<T> &V)
+    {
+        //按行分块，每块至少2n行
+        size_t leafRows = uLeafElements / n;
+        if (leafRows < 2 * n)
+            leafRows = 2 * n;
+        size_t leaves = m / leafRows;
+        if (leaves == 0)
+            leaves = 1;
+
+        std::vector<std::vector<T>> leafB(wantVectors ? leaves : 0), leafTau(wantVectors ? leaves : 0);
+        std::vector<T> rs(leaves * n * n, T(0));
+        MatrixThreadPool::ParallelFor(0, leaves, 1, [&](size_t l0, size_t l1)
+                                      {
+                                          std::vector<T> b, tau;
+                                          for (size_t l = l0; l < l1; ++l)
+                                          {
+                                              size_t r0 = m * l / leaves, r1 = m * (l + 1) / leaves;
+                                              b.assign(a + r0 * n, a + r1 * n);
+                                              tau.assign(n, T(0));
+                                              HouseholderQR(b.data(), r1 - r0, n, tau.data());
+                                              T *r = rs.data() + l * n * n;
+                                              for (size_t i = 0; i < n; ++i)
+                                                  std::copy(b.begin() + i * n + i, b.begin() + (i + 1) * n, r + i * n + i);
+                                              if (wantVectors)
+                                              {
+                                                  leafB[l].swap(b);
+                                                  leafTau[l].swap(tau);
+                                              }
+                                          }
+                                      });
+
+        //二叉树合并三角因子，结果在第0个位置
+        std::vector<std::vector<TreeNode>> levels;
+        for (size_t stride = 1; stride < leaves; stride *= 2)
+        {
+            std::vector<TreeNode> nodes;
+            for (size_t l = 0; l + stride < leaves; l += 2 * stride)
+                nodes.push_back(TreeNode{l, l + stride, std::vector<T>(), std::vector<T>(n, T(0))});
+            MatrixThreadPool::ParallelFor(0, nodes.size(), 1, [&](size_t p0, size_t p1)
+                                          {
+                                              for (size_t p = p0; p < p1; ++p)
+                                              {
+                                                  TreeNode &node = nodes[p];
+                                                  T *r1 = rs.data() + node.left * n * n;
+                                                  T *r2 = rs.data() + node.right * n * n;
+                                                  CombineTriangles(r1, r2, n, node.tau.data());
+                                                  if (wantVectors)
+                                                      node.vb.assign(r2, r2 + n * n);
+                                              }
+                                          });
+            levels.push_back(std::move(nodes));
+        }
 
-        @param mat	要合并的第二个矩阵
-        @param d	第二个矩阵的相对位置
+        //对Rᵀ的行做单边Jacobi：G = Rᵀ，Y累积旋转（Y = Vᵀ）
+        std::vector<T> g(n * n), y;
+        const T *root = rs.data();
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = i; j < n; ++j)
+                g[j * n + i] = root[i * n + j];
+        if (wantVectors)
+        {
+            y.assign(n * n, T(0));
+            for (size_t i = 0; i < n; ++i)
+                y[i * n + i] = T(1);
+        }
+        bool ok = OneSidedJacobi(g.data(), wantVectors ? y.data() : nullptr, n);
 
-        @return				合并的矩阵
-    */
-    Matrix<T> CombineWith(const Matrix<T> &mat, Direction d) const
-    {
-        switch (d)
+        //奇异值为G各行的范数，降序排列
+        std::vector<T> norms(n);
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i)
         {
-        case LEFT:
+            norms[i] = Vector<T>::Norm(VectorView<const T>(g.data() + i * n, n));
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t z)
+                         { return norms[x] > norms[z]; });
+        s = Vector<T>(n);
+        for (size_t c = 0; c < n; ++c)
+            s[c] = norms[order[c]];
+        if (!wantVectors)
+            return ok;
+
+        //U_R的第c列为G第order[c]行的单位化，V的第c列为Y的第order[c]行
+        V = Matrix<T>(n, n);
+        std::vector<T> x(leaves * n * n, T(0));
+        T *ur = x.data();
+        for (size_t c = 0; c < n; ++c)
         {
-            // 检查行数是否相同
-            assert(this->uRow == mat.uRow);
+            const T *gr = g.data() + order[c] * n;
+            const T *yr = y.data() + order[c] * n;
+            for (size_t i = 0; i < n; ++i)
+            {
+                ur[i * n + c] = s[c] > T(0) ? gr[i] / s[c] : T(0);
+                V.ElemAt0(i, c) = yr[i];
+            }
+        }
+        CompleteOrthonormalColumns(ur, n, s);
 
-            Matrix<T> r(uRow, this->uCol + mat.uCol);
+        //自顶向下作用树节点的Q，再作用各块的Q
+        for (size_t lv = levels.size(); lv-- > 0;)
+        {
+            std::vector<TreeNode> &nodes = levels[lv];
+            MatrixThreadPool::ParallelFor(0, nodes.size(), 1, [&](size_t p0, size_t p1)
+                                          {
+                                              for (size_t p = p0; p < p1; ++p)
+                                                  ApplyCombinedQ(nodes[p].vb.data(), nodes[p].tau.data(), n,
+                                                                 x.data() + nodes[p].left * n * n, x.data() + nodes[p].right * n * n);
+                                          });
+        }
 
-            T *pRowHead = r.pData;
-            T *pSubRowHead1 = mat.pData;
-            T *pSubRowHead2 = this->pData;
+        U = Matrix<T>(m, n);
+        T *pu = U.Data();
+        MatrixThreadPool::ParallelFor(0, leaves, 1, [&](size_t l0, size_t l1)
+                                      {
+                                          for (size_t l = l0; l < l1; ++l)
+                                          {
+                                              size_t r0 = m * l / leaves, r1 = m * (l + 1) / leaves;
+                                              ApplyLeafQ(leafB[l].data(), leafTau[l].data(), r1 - r0, n, x.data() + l * n * n, pu + r0 * n);
+                                          }
+                                      });
+        return ok;
+    }
 
-            for (size_t i = 1; i <= uRow; ++i)
-            {
-                //对每一行先复制mat再复制this
-                for (size_t j = 0; j < mat.uCol; ++j)
-                    pRowHead[j] = pSubRowHead1[j];
-                pRowHead += mat.uCol;
-                pSubRowHead1 += mat.uCol;
-                for (size_t j = 0; j < this->uCol; ++j)
-                    pRowHead[j] = pSubRowHead2[j];
-                pRowHead += this->uCol;
-                pSubRowHead2 += this->uCol;
-            }
-            return r;
+    /**
+     * @brief 对若干行作用反射 I - τvvᵀ
+     *
+     * 反射向量在主元行上的分量为1，主元行由调用者处理：调用前w为主元行，
+     * 返回时 w = τ·vᵀX，调用者再令主元行减去w。
+     *
+     * @param base      第0行的起始地址
+     * @param ld        行距
+     * @param v         第0行对应的反射向量分量
+     * @param vstride   反射向量分量的间距
+     * @param i0        起始行
+     * @param i1        结束行（不含）
+     * @param len       每行参与运算的元素个数
+     * @param tau       反射系数
+     * @param w         长度为len的工作向量
+     */
+    static void ReflectRows(T *base, size_t ld, const T *v, size_t vstride, size_t i0, size_t i1, size_t len, T tau, T *MATRIX_RESTRICT w)
+    {
+        //w += Σ vᵢ·rowᵢ，每次累加4行以减少w的读写
+        size_t i = i0;
+        for (; i + 4 <= i1; i += 4)
+        {
+            const T *MATRIX_RESTRICT r0 = base + i * ld;
+            const T *MATRIX_RESTRICT r1 = r0 + ld;
+            const T *MATRIX_RESTRICT r2 = r1 + ld;
+            const T *MATRIX_RESTRICT r3 = r2 + ld;
+            T v0 = v[i * vstride], v1 = v[(i + 1) * vstride], v2 = v[(i + 2) * vstride], v3 = v[(i + 3) * vstride];
+            for (size_t c = 0; c < len; ++c)
+                w[c] += v0 * r0[c] + v1 * r1[c] + v2 * r2[c] + v3 * r3[c];
         }
-        case RIGHT:
-            return mat.CombineWith(*this, LEFT);
+        for (; i < i1; ++i)
+        {
+            const T *MATRIX_RESTRICT r0 = base + i * ld;
+            T v0 = v[i * vstride];
+            for (size_t c = 0; c < len; ++c)
+                w[c] += v0 * r0[c];
+        }
+        for (size_t c = 0; c < len; ++c)
+            w[c] *= tau;
+        for (i = i0; i < i1; ++i)
+        {
+            T *MATRIX_RESTRICT r0 = base + i * ld;
+            T v0 = v[i * vstride];
+            for (size_t c = 0; c < len; ++c)
+                r0[c] -= v0 * w[c];
+        }
+    }
 
-        case ABOVE:
+    /**
+     * @brief 行主序 r×n（r ≥ n）矩阵的Householder QR，按行访问
+     *
+     * R存放于上三角，第j个反射向量存放于第j列对角线以下。
+     */
+    static void HouseholderQR(T *b, size_t r, size_t n, T *tau)
+    {
+        using std::abs;
+        std::vector<T> w(n);
+        for (size_t j = 0; j < n; ++j)
         {
-            //检查列数是否相同
-            assert(this->uCol == mat.uCol);
+            T ssq = T(0), scaleNorm = T(0);
+            for (size_t i = j + 1; i < r; ++i)
+                scaleNorm = std::max(scaleNorm, T(abs(b[i * n + j])));
+            if (scaleNorm > T(0))
+                for (size_t i = j + 1; i < r; ++i)
+                {
+                    T t = b[i * n + j] / scaleNorm;
+                    ssq += t * t;
+                }
+            T scale;
+            T beta = MatrixKernel<T>::MakeReflector(b[j * n + j], scaleNorm * std::sqrt(ssq), tau[j], scale);
+            for (size_t i = j + 1; i < r; ++i)
+                b[i * n + j] *= scale;
+            b[j * n + j] = beta;
+            if (tau[j] == T(0) || j + 1 == n)
+                continue;
 
-            Matrix<T> r(this->uRow + mat.uRow, uCol);
-            T *pHead = r.pData;
+            T *rowJ = b + j * n + j + 1;
+            size_t len = n - j - 1;
+            std::copy(rowJ, rowJ + len, w.begin());
+            ReflectRows(b + j + 1, n, b + j, n, j + 1, r, len, tau[j], w.data());
+            for (size_t c = 0; c < len; ++c)
+                rowJ[c] -= w[c];
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * r * n * n));
+    }
+
+    /**
+     * @brief 合并两个上三角因子：[R1; R2] = Q·R
+     *
+     * 第j个反射只涉及R1的第j行与R2的前j+1行。结束时R1为新的R，
+     * R2的上三角存放反射向量在下半部分的分量。
+     */
+    static void CombineTriangles(T *r1, T *r2, size_t n, T *tau)
+    {
+        std::vector<T> w(n);
+        for (size_t j = 0; j < n; ++j)
+        {
+            T xnorm = Vector<T>::Norm(VectorView<const T>(r2 + j, j + 1, n));
+            T scale;
+            T beta = MatrixKernel<T>::MakeReflector(r1[j * n + j], xnorm, tau[j], scale);
+            for (size_t i = 0; i <= j; ++i)
+                r2[i * n + j] *= scale;
+            r1[j * n + j] = beta;
+            if (tau[j] == T(0) || j + 1 == n)
+                continue;
 
-            for (size_t i = 0; i < mat.uRow * mat.uCol; ++i)
-                pHead[i] = mat.pData[i];
-            pHead += mat.uRow * mat.uCol;
-            for (size_t i = 0; i < uRow * uCol; ++i)
-                pHead[i] = this->pData[i];
+            T *rowJ = r1 + j * n + j + 1;
+            size_t len = n - j - 1;
+            std::copy(rowJ, rowJ + len, w.begin());
+            ReflectRows(r2 + j + 1, n, r2 + j, n, 0, j + 1, len, tau[j], w.data());
+            for (size_t c = 0; c < len; ++c)
+                rowJ[c] -= w[c];
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * n * n * n / 3));
+    }
 
-            return r;
+    //[top; bottom] = Q_node·[top; 0]，bottom的输入值被忽略
+    static void ApplyCombinedQ(const T *vb, const T *tau, size_t n, T *top, T *bottom)
+    {
+        std::fill(bottom, bottom + n * n, T(0));
+        std::vector<T> w(n);
+        for (size_t j = n; j-- > 0;)
+        {
+            if (tau[j] == T(0))
+                continue;
+            T *rowJ = top + j * n;
+            std::copy(rowJ, rowJ + n, w.begin());
+            ReflectRows(bottom, n, vb + j, n, 0, j + 1, n, tau[j], w.data());
+            for (size_t c = 0; c < n; ++c)
+                rowJ[c] -= w[c];
         }
-        case BELOW:
-            return mat.CombineWith(*this, ABOVE);
+    }
 
-        case TOPLEFT:
+    //out = Q_leaf·[x; 0]，out为 r×n
+    static void ApplyLeafQ(const T *b, const T *tau, size_t r, size_t n, const T *x, T *out)
+    {
+        std::copy(x, x + n * n, out);
+        std::fill(out + n * n, out + r * n, T(0));
+        std::vector<T> w(n);
+        for (size_t j = n; j-- > 0;)
         {
-            Matrix<T> r(this->uRow + mat.uRow, this->uCol + mat.uCol);
-            T *pHead = r.pData;
-            T *pSubHead1 = mat.pData;
-            T *pSubHead2 = this->pData;
+            if (tau[j] == T(0))
+                continue;
+            T *rowJ = out + j * n;
+            std::copy(rowJ, rowJ + n, w.begin());
+            ReflectRows(out, n, b + j, n, j + 1, r, n, tau[j], w.data());
+            for (size_t c = 0; c < n; ++c)
+                rowJ[c] -= w[c];
+        }
+        MATRIX_PROFILE_EVENT(RecordFlops(4ull * r * n * n));
+    }
 
-            for (size_t i = 1; i <= mat.uRow; ++i)
+    /**
+     * @brief 单边Jacobi：旋转g的行对直至各行两两正交
+     *
+     * 循环赛顺序：每一轮的n/2个行对互不相交，按行对并行。
+     *
+     * @param g n×n矩阵
+     * @param y n×n矩阵或nullptr，对其行做相同的旋转
+     * @param n 阶数
+     * @return 若收敛，返回true
+     */
+    static bool OneSidedJacobi(T *g, T *y, size_t n)
+    {
+        MATRIX_PROFILE_SCOPE("OneSidedJacobi");
+        using std::abs;
+        const T tol = std::sqrt(T(n)) * std::numeric_limits<T>::epsilon();
+        size_t players = n + (n % 2);
+        std::vector<size_t> ring(players);
+        for (size_t i = 0; i < players; ++i)
+            ring[i] = i;
+
+        for (size_t sweep = 0; sweep < uMaxSweeps; ++sweep)
+        {
+            std::atomic<size_t> rotations(0);
+            for (size_t round = 0; round + 1 < players; ++round)
             {
-                for (size_t j = 0; j < mat.uCol; ++j)
-                    pHead[j] = pSubHead1[j];
-                pHead += r.uCol;
-                pSubHead1 += mat.uCol;
+                MatrixThreadPool::ParallelFor(0, players / 2, 4, [&](size_t p0, size_t p1)
+                                              {
+                                                  size_t local = 0;
+                                                  for (size_t p = p0; p < p1; ++p)
+                                                  {
+                                                      size_t i = ring[p], j = ring[players - 1 - p];
+                                                      if (i >= n || j >= n)
+                                                          continue;
+                                                      T *gi = g + i * n, *gj = g + j * n;
+                                                      T alpha = MatrixKernel<T>::Dot(n, gi, 1, gi, 1);
+                                                      T beta = MatrixKernel<T>::Dot(n, gj, 1, gj, 1);
+                                                      T gamma = MatrixKernel<T>::Dot(n, gi, 1, gj, 1);
+                                                      if (abs(gamma) <= tol * std::sqrt(alpha * beta))
+                                                          continue;
+                                                      ++local;
+                                                      T zeta = (beta - alpha) / (T(2) * gamma);
+                                                      T t = T(1) / (abs(zeta) + std::sqrt(T(1) + zeta * zeta));
+                                                      if (zeta < T(0))
+                                                          t = -t;
+                                                      T c = T(1) / std::sqrt(T(1) + t * t), s = c * t;
+                                                      Rotate(gi, gj, n, c, s);
+                                                      if (y)
+                                                          Rotate(y + i * n, y + j * n, n, c, s);
+                                                  }
+                                                  rotations += local;
+                                              });
+                //循环赛轮换：固定最后一位，其余位置循环移动
+                std::rotate(ring.begin(), ring.begin() + players - 2, ring.begin() + players - 1);
             }
+            if (rotations == 0)
+                return true;
+        }
+        return false;
+    }
 
-            pHead += mat.uCol;
+    //x = cx - sy，y = sx + cy
+    static void Rotate(T *MATRIX_RESTRICT x, T *MATRIX_RESTRICT y, size_t n, T c, T s)
+    {
+        for (size_t k = 0; k < n; ++k)
+        {
+            T a = x[k], b = y[k];
+            x[k] = c * a - s * b;
+            y[k] = s * a + c * b;
+        }
+    }
 
-            for (size_t i = 1; i <= this->uRow; ++i)
+    //奇异值为0的列替换为与其余列正交的单位向量
+    static void CompleteOrthonormalColumns(T *ur, size_t n, const Vector<T> &s)
+    {
+        std::vector<T> col(n);
+        size_t candidate = 0;
+        for (size_t c = 0; c < n; ++c)
+        {
+            if (s[c] > T(0))
+                continue;
+            while (candidate < n)
             {
-                for (size_t j = 0; j < this->uCol; ++j)
-                    pHead[j] = pSubHead2[j];
-                pHead += r.uCol;
-                pSubHead2 += this->uCol;
+                std::fill(col.begin(), col.end(), T(0));
+                col[candidate++] = T(1);
+                for (int pass = 0; pass < 2; ++pass)
+                    for (size_t q = 0; q < n; ++q)
+                    {
+                        if (q == c || (q > c && s[q] == T(0)))
+                            continue;
+                        T dot = T(0);
+                        for (size_t i = 0; i < n; ++i)
+                            dot += ur[i * n + q] * col[i];
+                        for (size_t i = 0; i < n; ++i)
+                            col[i] -= dot * ur[i * n + q];
+                    }
+                T norm = Vector<T>::Norm(VectorView<const T>(col.data(), n));
+                if (norm > T(0.5))
+                {
+                    for (size_t i = 0; i < n; ++i)
+                        ur[i * n + c] = col[i] / norm;
+                    break;
+                }
             }
+        }
+    }
+};
 
-            return r;
+/**
+ * @brief 压缩行存储（CSR）稀疏矩阵
+ *
+ * 提供迭代求解所需的功能：构造、按行访问与并行的矩阵向量乘法。
+ * 每行的列序号升序排列，行列序号从0开始。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class SparseMatrix
+{
+public:
+    //一个非零元素，行列序号从0开始
+    struct Triplet
+    {
+        size_t row;
+        size_t col;
+        T value;
+    };
+
+private:
+    size_t uRow = 0;             //行数
+    size_t uCol = 0;             //列数
+    std::vector<size_t> rowPtr;  //第i行的元素位于[rowPtr[i], rowPtr[i + 1])
+    std::vector<size_t> colIdx;  //各元素的列序号
+    std::vector<T> values;       //各元素的值
+
+    static const size_t uParallelGrain = 16384; //每个并行块至少处理的非零元素个数
+
+public:
+    SparseMatrix() : rowPtr(1, 0) {}
+
+    /**
+     * @brief 由非零元素列表构造，重复位置的值相加
+     *
+     * @param rows      行数
+     * @param cols      列数
+     * @param entries   非零元素列表，顺序任意
+     */
+    SparseMatrix(size_t rows, size_t cols, std::vector<Triplet> entries)
+        : uRow(rows), uCol(cols), rowPtr(rows + 1, 0)
+    {
+        std::sort(entries.begin(), entries.end(), [](const Triplet &a, const Triplet &b)
+                  { return a.row < b.row || (a.row == b.row && a.col < b.col); });
+        colIdx.reserve(entries.size());
+        values.reserve(entries.size());
+        for (size_t k = 0; k < entries.size(); ++k)
+        {
+            const Triplet &e = entries[k];
+            assert(e.row < rows && e.col < cols);
+            if (k > 0 && e.row == entries[k - 1].row && e.col == entries[k - 1].col)
+            {
+                values.back() += e.value;
+                continue;
+            }
+            colIdx.push_back(e.col);
+            values.push_back(e.value);
+            ++rowPtr[e.row + 1];
         }
+        for (size_t i = 0; i < rows; ++i)
+            rowPtr[i + 1] += rowPtr[i];
+    }
 
-        case TOPRIGHT:
+    /**
+     * @brief 由稠密矩阵构造，只保留非零元素
+     *
+     * @param mat 稠密矩阵
+     */
+    template <size_t _Inc>
+    explicit SparseMatrix(const Matrix<T, _Inc> &mat)
+        : uRow(mat.RowSize()), uCol(mat.ColumnSize()), rowPtr(mat.RowSize() + 1, 0)
+    {
+        const T *a = mat.Data();
+        for (size_t i = 0; i < uRow; ++i)
         {
-            Matrix<T> r(this->uRow + mat.uRow, this->uCol + mat.uCol);
-            T *pHead = r.pData + this->uCol;
-            T *pSubHead1 = mat.pData;
-            T *pSubHead2 = this->pData;
+            for (size_t j = 0; j < uCol; ++j)
+                if (a[i * uCol + j] != T(0))
+                {
+                    colIdx.push_back(j);
+                    values.push_back(a[i * uCol + j]);
+                }
+            rowPtr[i + 1] = colIdx.size();
+        }
+    }
+
+    size_t RowSize() const
+    {
+        return uRow;
+    }
+
+    size_t ColumnSize() const
+    {
+        return uCol;
+    }
+
+    /**
+     * @brief 非零元素个数
+     */
+    size_t NonZeros() const
+    {
+        return values.size();
+    }
+
+    /**
+     * @brief 行起始位置数组，长度为行数加1
+     */
+    const std::vector<size_t> &RowPointers() const
+    {
+        return rowPtr;
+    }
+
+    /**
+     * @brief 各元素的列序号
+     */
+    const std::vector<size_t> &ColumnIndices() const
+    {
+        return colIdx;
+    }
+
+    /**
+     * @brief 各元素的值
+     */
+    const std::vector<T> &Values() const
+    {
+        return values;
+    }
+
+    /**
+     * @brief 各元素的值，修改值不改变非零结构
+     */
+    std::vector<T> &Values()
+    {
+        return values;
+    }
+
+    /**
+     * @brief 访问元素，行列序号从0开始
+     *
+     * @return T 元素的值，不在存储结构中的元素为0
+     */
+    T ElemAt0(size_t row, size_t col) const
+    {
+        assert(row < uRow && col < uCol);
+        auto first = colIdx.begin() + rowPtr[row], last = colIdx.begin() + rowPtr[row + 1];
+        auto it = std::lower_bound(first, last, col);
+        return it != last && *it == col ? values[it - colIdx.begin()] : T(0);
+    }
 
-            for (size_t i = 1; i <= mat.uRow; ++i)
-            {
-                for (size_t j = 0; j < mat.uCol; ++j)
-                    pHead[j] = pSubHead1[j];
-                pHead += r.uCol;
-                pSubHead1 += mat.uCol;
-            }
+    /**
+     * @brief 矩阵向量乘法 y = Ax，按行并行
+     *
+     * @param x 长度为列数的向量
+     * @param y 长度为行数的向量，不能与x重叠
+     */
+    void Multiply(VectorView<const T> x, VectorView<T> y) const
+    {
+        assert(x.Size() == uCol && y.Size() == uRow);
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * values.size()));
+        size_t perRow = uRow > 0 ? values.size() / uRow + 1 : 1;
+        MatrixThreadPool::ParallelFor(0, uRow, uParallelGrain / perRow + 1, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                          {
+                                              T sum = T(0);
+                                              for (size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+                                                  sum += values[p] * x[colIdx[p]];
+                                              y[i] = sum;
+                                          }
+                                      });
+    }
 
-            pHead += mat.uCol;
+    /**
+     * @brief 矩阵向量乘法
+     *
+     * @param x 长度为列数的向量
+     * @return Vector<T> Ax
+     */
+    Vector<T> operator*(const Vector<T> &x) const
+    {
+        Vector<T> y(uRow);
+        Multiply(x, y);
+        return y;
+    }
 
-            for (size_t i = 1; i <= this->uRow; ++i)
-            {
-                for (size_t j = 0; j < this->uCol; ++j)
-                    pHead[j] = pSubHead2[j];
-                pHead += r.uCol;
-                pSubHead2 += this->uCol;
-            }
+    /**
+     * @brief 转换为稠密矩阵
+     */
+    Matrix<T> ToDense() const
+    {
+        Matrix<T> mat(uRow, uCol);
+        T *a = mat.Data();
+        for (size_t i = 0; i < uRow; ++i)
+            for (size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+                a[i * uCol + colIdx[p]] = values[p];
+        return mat;
+    }
+};
 
-            return r;
-        }
+/**
+ * @brief n×n线性算子 y = Ax
+ *
+ * 迭代求解器只通过算子访问系数矩阵，可由稠密矩阵、稀疏矩阵或任意可调用对象构造。
+ * 由矩阵构造时只保存其引用，矩阵的生存期必须覆盖算子的使用。
+ *
+ * @tparam T 数据类型
+ */
+template <typename T>
+class LinearOperator
+{
+private:
+    size_t uSize = 0;                                                //阶数
+    std::function<void(VectorView<const T>, VectorView<T>)> apply; //计算 y = Ax
 
-        case BOTLEFT:
-            return mat.CombineWith(*this, TOPRIGHT);
+public:
+    /**
+     * @brief 由可调用对象构造
+     *
+     * @param n 阶数
+     * @param f 形如 void(VectorView<const T> x, VectorView<T> y) 的可调用对象，计算 y = Ax
+     */
+    template <typename F>
+    LinearOperator(size_t n, F f) : uSize(n), apply(std::move(f)) {}
 
-        case BOTRIGHT:
-            return mat.CombineWith(*this, TOPLEFT);
+    /**
+     * @brief 由稠密方阵构造，使用并行的GEMV
+     *
+     * @param mat 系数方阵
+     */
+    template <size_t _Inc>
+    LinearOperator(const Matrix<T, _Inc> &mat) : uSize(mat.RowSize())
+    {
+        assert(mat.RowSize() == mat.ColumnSize());
+        const Matrix<T, _Inc> *pMat = &mat;
+        apply = [pMat](VectorView<const T> x, VectorView<T> y)
+        {
+            size_t n = pMat->RowSize();
+            MatrixKernel<T>::Gemv(false, n, n, T(1), pMat->Data(), n, x.Data(), x.Stride(), T(0), y.Data(), y.Stride());
+        };
+    }
 
-        default:
-            assert(0);
-        }
-        return Matrix<T>();
+    /**
+     * @brief 由稀疏方阵构造
+     *
+     * @param mat 系数方阵
+     */
+    LinearOperator(const SparseMatrix<T> &mat) : uSize(mat.RowSize())
+    {
+        assert(mat.RowSize() == mat.ColumnSize());
+        const SparseMatrix<T> *pMat = &mat;
+        apply = [pMat](VectorView<const T> x, VectorView<T> y)
+        { pMat->Multiply(x, y); };
     }
 
-public:
     /**
-     *  @brief 矩阵按行分解，保留指定方向的矩阵
-     *  
-     *  取值：
-     *  ABOVE	保留分割行和其上方的部分
-     *  BELOW	保留分割行和其下方的部分
-     * 
-     *  若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-     *  否则从1开始。
-     * 
-     *  @param SplitterRowIndex		分割行的序号，该行将被保留在返回的矩阵中
-     *  @param d			        分割保留的方向
-     *   
-     *  @return		分割后保留的部分构成的矩阵
+     * @brief n阶单位算子
      */
-    Matrix<T> RowSplit(size_t SplitterRowIndex, Direction d) const
+    static LinearOperator<T> Identity(size_t n)
     {
-        //n：结果矩阵的行数
-        size_t n = SplitterRowIndex <= this->uRow ? SplitterRowIndex : this->uRow;
+        return LinearOperator<T>(n, [](VectorView<const T> x, VectorView<T> y)
+                                 {
+                                     for (size_t i = 0; i < x.Size(); ++i)
+                                         y[i] = x[i];
+                                 });
+    }
 
-        if (d == ABOVE)
-        {
-            Matrix<T> r(n, this->uCol);
-            memcpy_s(r.pData, r.uRow * r.uCol * sizeof(T), this->pData, r.uRow * r.uCol * sizeof(T));
-            return r;
-        }
-        else if (d == BELOW)
-        {
-            Matrix<T> r(this->uRow - n + 1, this, uCol);
-            memcpy_s(r.pData, r.uRow * r.uCol * sizeof(T), &this->ElemAt(n, 1), r.uRow * r.uCol * sizeof(T));
-            return r;
-        }
+    size_t Size() const
+    {
+        return uSize;
+    }
 
-        assert(0);
-        return Matrix<T>();
+    /**
+     * @brief 计算 y = Ax
+     *
+     * @param x 输入向量
+     * @param y 输出向量，不能与x重叠
+     */
+    void Apply(VectorView<const T> x, VectorView<T> y) const
+    {
+        assert(x.Size() == uSize && y.Size() == uSize);
+        apply(x, y);
     }
+};
+
+/**
+ * @brief 不形成乘积的Kronecker算子 y = (A⊗B)x
+ *
+ * A为m×n，B为p×q。把x按行主序看作n×q矩阵X、y看作m×p矩阵Y，则 Y = AXBᵀ，
+ * 以两次GEMM计算，并按维度选择 A(XBᵀ) 与 (AX)Bᵀ 中乘加次数较少的顺序。
+ * 构造时复制A与Bᵀ，占用 O(mn + pq) 内存，而显式的A⊗B需要 O(mnpq)。
+ *
+ * @tparam T 数据类型
+ */
+template <typename T>
+class KroneckerOperator
+{
+private:
+    Matrix<T> matA;  //m×n
+    Matrix<T> matBt; //Bᵀ，q×p
 
 public:
     /**
-     *  @brief 矩阵按列分解，保留指定方向的矩阵
-     * 
-     *  取值：
-     *  ON_LFET		0	保留分割列和其左边的部分
-     *  ON_RIGHT	1	保留分割列和其右边的部分
-     *   
-     *  若定义了MATRIX_INDEX_START_AT_0,则行列序号从0开始，
-     *  否则从1开始。
+     * @brief 构造算子
      *
-     *  @param SplitterRowIndex		分割列的序号，该列将被保留在返回的矩阵中
-     *  @param d			分割保留的方向
-     *   
-     *  @return		分割后保留的部分构成的矩阵
+     * @param A m×n矩阵
+     * @param B p×q矩阵
      */
-    Matrix<T> ColumnSplit(size_t SplitterColIndex, Direction d) const
+    KroneckerOperator(const Matrix<T> &A, const Matrix<T> &B) : matA(A), matBt(B.Transpose()) {}
+
+    //行数 mp
+    size_t RowSize() const
     {
-        //n：结果矩阵的列数
-        size_t n = SplitterColIndex <= this->uCol ? SplitterColIndex : this->uCol;
+        return matA.RowSize() * matBt.ColumnSize();
+    }
 
-        if (d == LEFT)
-        {
-            Matrix<T> r(uRow, n);
-            T *pSubRowHead = r.pData;
-            T *pRowHead = this->pData;
+    //列数 nq
+    size_t ColumnSize() const
+    {
+        return matA.ColumnSize() * matBt.RowSize();
+    }
 
-            for (size_t i = 1; i <= uRow; ++i)
-            {
-                for (size_t j = 0; j < n; ++j)
-                    pSubRowHead[j] = pRowHead[j];
-                pSubRowHead += r.uCol;
-                pRowHead += this->uCol;
-            }
-            return r;
+    /**
+     * @brief 计算 y = (A⊗B)x
+     *
+     * @param x 长度为nq的向量或视图
+     * @param y 长度为mp的向量或视图，不能与x重叠
+     */
+    void Apply(VectorView<const T> x, VectorView<T> y) const
+    {
+        MATRIX_PROFILE_SCOPE("KroneckerOperator::Apply");
+        size_t m = matA.RowSize(), n = matA.ColumnSize(), q = matBt.RowSize(), p = matBt.ColumnSize();
+        assert(x.Size() == n * q && y.Size() == m * p);
+
+        //GEMM要求行主序连续存储，有跨度时复制
+        std::vector<T> xBuf, yBuf;
+        const T *px = x.Data();
+        if (x.Stride() != 1)
+        {
+            xBuf.resize(x.Size());
+            for (size_t i = 0; i < x.Size(); ++i)
+                xBuf[i] = x[i];
+            px = xBuf.data();
         }
-        else if (d == RIGHT)
+        T *py = y.Data();
+        if (y.Stride() != 1)
         {
-            Matrix<T> r(uRow, this->uCol - n + 1);
-            T *pSubRowHead = r.pData;
-            T *pRowHead = this->pData + n - 1;
+            yBuf.resize(y.Size());
+            py = yBuf.data();
+        }
 
-            for (size_t i = 1; i <= uRow; ++i)
-            {
-                for (size_t j = 0; j < n; ++j)
-                    pSubRowHead[j] = pRowHead[j];
-                pSubRowHead += r.uCol;
-                pRowHead += this->uCol;
-            }
-            return r;
+        const T *pa = matA.Data(), *pbt = matBt.Data();
+        if (n * p * (q + m) <= m * q * (n + p))
+        {
+            //Z = XBᵀ（n×p），Y = AZ
+            std::vector<T> z(n * p);
+            MatrixKernel<T>::Gemm(n, p, q, T(1), px, q, pbt, p, T(0), z.data(), p);
+            MatrixKernel<T>::Gemm(m, p, n, T(1), pa, n, z.data(), p, T(0), py, p);
+        }
+        else
+        {
+            //Z = AX（m×q），Y = ZBᵀ
+            std::vector<T> z(m * q);
+            MatrixKernel<T>::Gemm(m, q, n, T(1), pa, n, px, q, T(0), z.data(), q);
+            MatrixKernel<T>::Gemm(m, p, q, T(1), z.data(), q, pbt, p, T(0), py, p);
         }
 
-        assert(0);
-        return Matrix<T>();
+        if (y.Stride() != 1)
+            for (size_t i = 0; i < yBuf.size(); ++i)
+                y[i] = yBuf[i];
     }
 
-public:
-    /**
-        @brief 矩阵同型检查：检查矩阵1和矩阵2是否为同型矩阵
+    //返回 (A⊗B)x
+    Vector<T> operator*(const Vector<T> &x) const
+    {
+        Vector<T> y(RowSize());
+        Apply(x, y);
+        return y;
+    }
 
-        @param mat1		矩阵1
-        @param mat2		矩阵2
-        @return		若mat1和mat2为同型矩阵，则返回true，否则返回false
-    */
-    static bool Varify_Homo(const Matrix<T> &mat1, const Matrix<T> &mat2)
+    //形成显式的 A⊗B
+    Matrix<T> ToDense() const
     {
-        if ((mat1.uRow - mat2.uRow) || (mat1.uCol - mat2.uCol)) //如果行数列数不等
-            return false;
-        return true;
+        return Matrix<T>::Kronecker(matA, matBt.Transpose());
     }
 
-public:
-    //矩阵取负
-    Matrix<T> operator-() const
+    /**
+     * @brief 转换为线性算子，要求 A⊗B 为方阵。本对象的生存期必须覆盖算子的使用
+     */
+    operator LinearOperator<T>() const
     {
-        Matrix<T> resMat(uRow, uCol);
-        T *pResData = resMat.pData - 1;
-        T *pThisData = pData - 1;
-        for (size_t i = 0; i < uRow * uCol; ++i)
-            *(++pResData) = -*(++pThisData);
-        return resMat;
+        assert(RowSize() == ColumnSize());
+        const KroneckerOperator<T> *self = this;
+        return LinearOperator<T>(RowSize(), [self](VectorView<const T> x, VectorView<T> y)
+                                 { self->Apply(x, y); });
     }
+};
+
+/**
+ * @brief Jacobi（对角）预条件子 z = D⁻¹r
+ *
+ * @tparam T 数据类型
+ */
+template <typename T>
+class JacobiPreconditioner
+{
+private:
+    std::vector<T> invDiag; //对角元素的倒数，对角元素为0时取1
 
 public:
-    //矩阵加法
-    Matrix<T> operator+(const Matrix<T> &mat) const
+    template <size_t _Inc>
+    explicit JacobiPreconditioner(const Matrix<T, _Inc> &mat) : invDiag(mat.RowSize())
     {
-        //同型检查
-        assert(Varify_Homo(*this, mat));
+        assert(mat.RowSize() == mat.ColumnSize());
+        for (size_t i = 0; i < invDiag.size(); ++i)
+            invDiag[i] = Invert(mat.ElemAt0(i, i));
+    }
 
-        Matrix<T> r(uRow, uCol);
-        for (size_t i = 0; i < uRow * uCol; ++i)
-            r.pData[i] = this->pData[i] + mat.pData[i];
-        return r;
+    explicit JacobiPreconditioner(const SparseMatrix<T> &mat) : invDiag(mat.RowSize())
+    {
+        assert(mat.RowSize() == mat.ColumnSize());
+        for (size_t i = 0; i < invDiag.size(); ++i)
+            invDiag[i] = Invert(mat.ElemAt0(i, i));
     }
 
-public:
-    //矩阵减法
-    Matrix<T> operator-(const Matrix<T> &mat) const
+    /**
+     * @brief 计算 z = D⁻¹r
+     */
+    void Apply(VectorView<const T> r, VectorView<T> z) const
     {
-        //同型检查
-        assert(Varify_Homo(*this, mat));
+        for (size_t i = 0; i < invDiag.size(); ++i)
+            z[i] = invDiag[i] * r[i];
+    }
 
-        Matrix<T> r(uRow, uCol);
-        for (size_t i = 0; i < uRow * uCol; ++i)
-            r.pData[i] = this->pData[i] - mat.pData[i];
-        return r;
+    /**
+     * @brief 转换为线性算子，本对象的生存期必须覆盖算子的使用
+     */
+    operator LinearOperator<T>() const
+    {
+        const JacobiPreconditioner<T> *self = this;
+        return LinearOperator<T>(invDiag.size(), [self](VectorView<const T> r, VectorView<T> z)
+                                 { self->Apply(r, z); });
     }
 
-public:
-    //矩阵数乘（数在右）
-    Matrix<T> operator*(const T &c) const
+private:
+    static T Invert(const T &d)
     {
-        Matrix<T> r(uRow, uCol);
-        for (size_t i = 0; i < uRow * uCol; ++i)
-            r.pData[i] = this->pData[i] * c;
-        return r;
+        return d == T(0) ? T(1) : T(1) / d;
     }
+};
 
-public:
-    //矩阵数乘（数在左）
-    template <typename E>
-    friend Matrix<E> operator*(const T &c, const Matrix<E> &mat);
+/**
+ * @brief 零填充不完全LU分解（ILU(0)）预条件子 z = (LU)⁻¹r
+ *
+ * L与U保持A的非零结构，L的对角元素为1。前代与回代是顺序的。
+ *
+ * @tparam T 数据类型
+ */
+template <typename T>
+class ILU0Preconditioner
+{
+private:
+    SparseMatrix<T> lu;          //L（严格下三角部分）与U（上三角部分），结构与A相同
+    std::vector<size_t> diagPos; //各行对角元素在lu中的位置
+    bool stable = true;          //分解中是否未遇到零主元
 
 public:
-    //矩阵点乘
-    Matrix<T> operator*(const Matrix<T> &mat) const
+    explicit ILU0Preconditioner(const SparseMatrix<T> &mat) : lu(mat), diagPos(mat.RowSize())
     {
-        assert(this->uCol == mat.uRow);
+        Factor();
+    }
 
-        Matrix<T> r(this->uRow, mat.uCol);
-        for (size_t i = 1; i <= r.uRow; ++i)
-            for (size_t j = 1; j <= r.uCol; ++j)
-                for (size_t k = 1; k <= this->uCol; ++k)
-                    r.ElemAt(i, j) += this->ElementAt(i, k) * mat.ElementAt(k, j);
-        return r;
+    template <size_t _Inc>
+    explicit ILU0Preconditioner(const Matrix<T, _Inc> &mat) : lu(mat), diagPos(mat.RowSize())
+    {
+        Factor();
     }
 
-private:
     /**
-        @brief 矩阵初等变换：行交换：交换两行的数据。
+     * @brief 分解中是否未遇到零主元
+     *
+     * 遇到零主元（或对角元素不在非零结构中）时该主元以1代替，预条件子仍可使用但效果变差。
+     *
+     * @return 若所有主元非零，返回true
+     */
+    bool Stable() const
+    {
+        return stable;
+    }
 
-        使用初等变换函数相比左乘变换方阵更加高效
+    /**
+     * @brief 计算 z = U⁻¹L⁻¹r
+     */
+    void Apply(VectorView<const T> r, VectorView<T> z) const
+    {
+        const std::vector<size_t> &rowPtr = lu.RowPointers();
+        const std::vector<size_t> &col = lu.ColumnIndices();
+        const std::vector<T> &val = lu.Values();
+        size_t n = lu.RowSize();
+        for (size_t i = 0; i < n; ++i)
+        {
+            T sum = r[i];
+            for (size_t p = rowPtr[i]; p < rowPtr[i + 1] && col[p] < i; ++p)
+                sum -= val[p] * z[col[p]];
+            z[i] = sum;
+        }
+        for (size_t i = n; i-- > 0;)
+        {
+            T sum = z[i];
+            size_t d = diagPos[i];
+            size_t p = d == rowPtr[i + 1] ? rowPtr[i] : d + 1;
+            for (; p < rowPtr[i + 1]; ++p)
+                if (col[p] > i)
+                    sum -= val[p] * z[col[p]];
+            z[i] = d == rowPtr[i + 1] ? sum : sum / val[d];
+        }
+    }
 
-        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
-        否则从1开始。
+    /**
+     * @brief 转换为线性算子，本对象的生存期必须覆盖算子的使用
+     */
+    operator LinearOperator<T>() const
+    {
+        const ILU0Preconditioner<T> *self = this;
+        return LinearOperator<T>(lu.RowSize(), [self](VectorView<const T> r, VectorView<T> z)
+                                 { self->Apply(r, z); });
+    }
 
-        @param RowIndex1	第一个行序号
-        @param RowIndex2	第二个行序号
-    */
-    void RowInterchange(size_t RowIndex1, size_t RowIndex2)
+private:
+    //IKJ形式的ILU(0)，pos记录当前行各列在lu中的位置
+    void Factor()
     {
-        assert(RowIndex1 <= uRow && RowIndex2 <= uRow);
+        MATRIX_PROFILE_SCOPE("ILU0");
+        assert(lu.RowSize() == lu.ColumnSize());
+        const std::vector<size_t> &rowPtr = lu.RowPointers();
+        const std::vector<size_t> &col = lu.ColumnIndices();
+        T *val = lu.Values().data();
+        size_t n = lu.RowSize();
+        const size_t none = size_t(-1);
+        std::vector<size_t> pos(n, none);
 
-        T *pRow1Head = &ElemAt(RowIndex1, 1);
-        T *pRow2Head = &ElemAt(RowIndex2, 1);
-        T tmp;
-        for (size_t i = 0; i < uCol; ++i)
+        for (size_t i = 0; i < n; ++i)
         {
-            tmp = pRow1Head[i];
-            pRow1Head[i] = pRow2Head[i];
-            pRow2Head[i] = tmp;
+            size_t begin = rowPtr[i], end = rowPtr[i + 1];
+            diagPos[i] = end;
+            for (size_t p = begin; p < end; ++p)
+            {
+                pos[col[p]] = p;
+                if (col[p] == i)
+                    diagPos[i] = p;
+            }
+            for (size_t p = begin; p < end && col[p] < i; ++p)
+            {
+                size_t k = col[p];
+                if (diagPos[k] == rowPtr[k + 1])
+                    continue;
+                val[p] /= val[diagPos[k]];
+                for (size_t q = diagPos[k] + 1; q < rowPtr[k + 1]; ++q)
+                    if (pos[col[q]] != none)
+                        val[pos[col[q]]] -= val[p] * val[q];
+            }
+            if (diagPos[i] == end || val[diagPos[i]] == T(0))
+            {
+                stable = false;
+                if (diagPos[i] != end)
+                    val[diagPos[i]] = T(1);
+            }
+            for (size_t p = begin; p < end; ++p)
+                pos[col[p]] = none;
         }
     }
+};
 
+/**
+ * @brief Krylov子空间迭代求解器：CG、GMRES(m)与BiCGSTAB
+ *
+ * 只通过线性算子访问系数矩阵，每次迭代的主要开销是一次（BiCGSTAB为两次）算子作用。
+ * 工作向量与收敛历史在求解开始时一次性分配，并在多次求解之间复用，迭代过程中不再分配。
+ * 收敛判据为 ||b - Ax||₂ <= tol·||b||₂。预条件子可选，GMRES与BiCGSTAB使用右预条件，
+ * 因此判据中的残差始终是原方程组的残差。
+ *
+ * @tparam T 数据类型，要求为浮点类型
+ */
+template <typename T>
+class IterativeSolver
+{
 private:
-    /**
-        @brief 矩阵初等变换：倍乘行：将目标行乘以k倍。
-        
-        使用初等变换函数相比左乘变换方阵更加高效
+    T tolerance;              //相对残差容限
+    size_t maxIterations;     //最大迭代次数
+    size_t restart = 30;      //GMRES的重启长度
+    size_t iterations = 0;    //上次求解的迭代次数
+    T residual = T(0);        //上次求解的相对残差
+    bool converged = false;   //上次求解是否收敛
+    std::vector<T> history;   //上次求解各次迭代的相对残差，首项为初始残差
+    std::vector<T> work;      //工作向量
+    std::vector<T> hessenberg; //GMRES的Hessenberg矩阵，(m+1)×m
+    std::vector<T> givens;    //GMRES的Givens旋转 (c, s)
+    std::vector<T> rhs;       //GMRES最小二乘问题的右端与解
+
+    static const size_t uParallelGrain = 1 << 15; //向量运算每个并行块的元素个数
 
-        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
-        否则从1开始。
+public:
+    /**
+     * @brief 求解器构造函数
+     *
+     * @param tol       相对残差容限
+     * @param maxIter   最大迭代次数
+     */
+    explicit IterativeSolver(T tol = std::sqrt(std::numeric_limits<T>::epsilon()), size_t maxIter = 1000)
+        : tolerance(tol), maxIterations(maxIter) {}
 
-        @param RowIndex	目标行序号
-        @param k		系数，不可为0
-    */
-    void RowScaling(size_t RowIndex, const T &k)
+    void SetTolerance(T tol)
     {
-        assert(RowIndex <= uRow && k != T(0));
+        tolerance = tol;
+    }
 
-        T *pRowHead = &ElemAt(RowIndex, 1);
-        for (size_t i = 0; i < uCol; ++i)
-            pRowHead[i] *= k;
+    void SetMaxIterations(size_t maxIter)
+    {
+        maxIterations = maxIter;
     }
 
-private:
     /**
-        @brief 矩阵初等变换：倍加行：将源行各数据乘以系数加到目标行对应数据。
-        
-        使用初等变换函数相比左乘变换方阵更加高效.
-        
-        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
-        否则从1开始。
-        
-        @param SrcRowIndex	源行序号
-        @param k			系数，可以为0
-        @param TagRowIndex	目标行序号
-    */
-    void RowAddition(size_t SrcRowIndex, const T &k, size_t TrgRowIndex)
+     * @brief 设置GMRES的重启长度m，即每次重启前Krylov子空间的最大维数
+     */
+    void SetRestart(size_t m)
     {
-        assert(SrcRowIndex <= uRow && TrgRowIndex <= uRow);
-
-        T *pSrcRowHead = &ElemAt(SrcRowIndex, 1);
-        T *pTrgRowHead = &ElemAt(TrgRowIndex, 1);
-
-        for (size_t i = 0; i < uCol; ++i)
-            pTrgRowHead[i] += k * pSrcRowHead[i];
+        assert(m > 0);
+        restart = m;
     }
 
-public:
     /**
-        @brief 清除某一行的数据
+     * @brief 上次求解的迭代次数
+     */
+    size_t Iterations() const
+    {
+        return iterations;
+    }
 
-        若定义了MATRIX_INDEX_START_AT_0,则行序号从0开始，
-        否则从1开始。
+    /**
+     * @brief 上次求解的相对残差 ||b - Ax||₂ / ||b||₂
+     *
+     * GMRES为迭代中递推得到的估计值。
+     */
+    T Residual() const
+    {
+        return residual;
+    }
 
-        @param RowIndex	要清除的行序号
-    */
-    void ClearRow(size_t RowIndex)
+    /**
+     * @brief 上次求解是否收敛
+     */
+    bool Converged() const
     {
-#ifdef MATRIX_INDEX_START_AT_0
-        ++RowIndex;
-#endif
-        assert(RowIndex <= uRow);
+        return converged;
+    }
 
-        T *pRowHead = &ElemAt(RowIndex, 1);
-        for (size_t i = 0; i < uCol; ++i)
-            pRowHead[i] = T(0);
+    /**
+     * @brief 上次求解的收敛历史：初始相对残差及每次迭代后的相对残差
+     */
+    const std::vector<T> &History() const
+    {
+        return history;
     }
 
-public:
     /**
-        @brief 清除某一列的数据
+     * @brief 预条件共轭梯度法，要求A与预条件子对称正定
+     *
+     * @param A 系数算子
+     * @param b 右端向量
+     * @param x 输入初始值（长度不符时以0为初始值），输出解
+     * @return 若收敛，返回true
+     */
+    bool CG(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x)
+    {
+        return CG(A, b, x, nullptr);
+    }
 
-        若定义了MATRIX_INDEX_START_AT_0,则列序号从0开始，
-        否则从1开始。
+    bool CG(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, const LinearOperator<T> &M)
+    {
+        return CG(A, b, x, &M);
+    }
 
-        @param ColIndex	要清除的列序号
-    */
-    void ClearColumn(size_t ColIndex)
+    /**
+     * @brief 重启GMRES(m)，适用于一般非奇异矩阵
+     *
+     * 使用修正Gram-Schmidt正交化与Givens旋转，保存预条件后的基向量（灵活GMRES），
+     * 因此预条件子在迭代之间可以变化。
+     *
+     * @param A 系数算子
+     * @param b 右端向量
+     * @param x 输入初始值（长度不符时以0为初始值），输出解
+     * @return 若收敛，返回true
+     */
+    bool GMRES(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x)
     {
-#ifdef MATRIX_INDEX_START_AT_0
-        ++ColIndex;
-#endif
-        assert(ColIndex <= uCol);
+        return GMRES(A, b, x, nullptr);
+    }
 
-        T *pColHead = &ElemAt(1, ColIndex);
-        for (size_t i = 0; i < uRow; ++i)
-            pColHead[i * uCol] = T(0);
+    bool GMRES(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, const LinearOperator<T> &M)
+    {
+        return GMRES(A, b, x, &M);
     }
 
-public:
     /**
-        @brief 矩阵求幂
-
-        @param n	幂阶数
-        @return		矩阵的n次幂矩阵
-    */
-    Matrix<T> Power(size_t n) const
+     * @brief 稳定双共轭梯度法，适用于一般非奇异矩阵，内存开销与重启长度无关
+     *
+     * @param A 系数算子
+     * @param b 右端向量
+     * @param x 输入初始值（长度不符时以0为初始值），输出解
+     * @return 若收敛，返回true
+     */
+    bool BiCGSTAB(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x)
     {
-        assert(uRow == uCol);
+        return BiCGSTAB(A, b, x, nullptr);
+    }
 
-        Matrix<T> r(uRow, uCol);
-        for (size_t i = 1; i <= uRow; ++i)
-            r.ElemAt(i, i) = T(1);
+    bool BiCGSTAB(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, const LinearOperator<T> &M)
+    {
+        return BiCGSTAB(A, b, x, &M);
+    }
 
-        for (size_t i = 0; i < n; ++i)
-            r = r * (*this);
+private:
+    //准备vectors个工作向量与x，在第一个工作向量中计算 r = b - Ax，返回 ||b||₂；b为0时x置0并返回0
+    T Start(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, size_t vectors)
+    {
+        size_t n = A.Size();
+        assert(b.Size() == n);
+        if (x.Size() != n)
+            x = Vector<T>(n, T(0));
+        if (work.size() < vectors * n)
+            work.resize(vectors * n);
+        history.clear();
+        history.reserve(maxIterations + 1);
+        iterations = 0;
+        converged = false;
+
+        T normB = Norm(n, b.Data());
+        if (normB == T(0))
+        {
+            std::fill(x.Data(), x.Data() + n, T(0));
+            converged = true;
+            residual = T(0);
+            history.push_back(T(0));
+            return T(0);
+        }
+        T *r = work.data();
+        A.Apply(x, VectorView<T>(r, n));
+        Parallel(n, [&](size_t i)
+                 { r[i] = b[i] - r[i]; });
+        return normB;
+    }
 
-        return r;
+    //记录相对残差并判断是否收敛
+    bool Record(T relative)
+    {
+        residual = relative;
+        history.push_back(relative);
+        converged = relative <= tolerance;
+        return converged;
     }
 
-public:
-    /**
-        @brief 矩阵转置
-        @return	矩阵的转置矩阵
-    */
-    Matrix<T> Transpose() const
+    static T Dot(size_t n, const T *x, const T *y)
     {
-        Matrix<T> r(this->uCol, this->uRow);
-        for (size_t i = 1; i <= r.uRow; ++i)
-            for (size_t j = 1; j <= r.uCol; ++j)
-                r.ElemAt(i, j) = this->ElementAt(j, i);
-        return r;
+        return MatrixKernel<T>::Dot(n, x, 1, y, 1);
     }
 
-public:
-    /**
-        @brief 余子式矩阵
-        @param m	元素所在的行数
-        @param n	元素所在的列数
-        @return		若为方阵，返回第m行第n列元素的余子式矩阵；否则返回空矩阵
-    */
-    Matrix<T> MinorOf(size_t m, size_t n) const
+    static T Norm(size_t n, const T *x)
     {
-        assert(uRow == uCol);
+        return Vector<T>::Norm(VectorView<const T>(x, n));
+    }
 
-        Matrix<T> r(this->uRow - 1, this->uCol - 1);
-        size_t index = 0;
-        for (size_t i = 1; i <= uRow; ++i)
-            for (size_t j = 1; j <= uCol; ++j)
-                if (i != m && j != n)
-                    r.pData[index++] = this->ElementAt(i, j);
-        return r;
+    //对每个下标并行执行f
+    template <typename F>
+    static void Parallel(size_t n, const F &f)
+    {
+        MatrixThreadPool::ParallelFor(0, n, uParallelGrain, [&](size_t b, size_t e)
+                                      {
+                                          for (size_t i = b; i < e; ++i)
+                                              f(i);
+                                      });
     }
 
-public:
-    /**
-        @brief 行约化矩阵
-        @return		矩阵的行约化结果矩阵
-    */
-    Matrix<T> RowReduce() const
+    //z = M⁻¹r，没有预条件子时复制
+    static void Precondition(const LinearOperator<T> *M, size_t n, const T *r, T *z)
     {
-        Matrix<T> r(*this);
+        if (M)
+            M->Apply(VectorView<const T>(r, n), VectorView<T>(z, n));
+        else
+            std::copy(r, r + n, z);
+    }
 
-        //高斯消元化为行阶梯矩阵
-        for (size_t i = 1; i <= r.uRow; ++i)
+    bool CG(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, const LinearOperator<T> *M)
+    {
+        MATRIX_PROFILE_SCOPE("CG");
+        size_t n = A.Size();
+        T normB = Start(A, b, x, 4);
+        if (normB == T(0))
+            return true;
+        T *r = work.data(), *z = r + n, *p = z + n, *q = p + n, *px = x.Data();
+
+        if (Record(Norm(n, r) / normB))
+            return true;
+        Precondition(M, n, r, z);
+        std::copy(z, z + n, p);
+        T rz = Dot(n, r, z);
+        while (iterations < maxIterations)
         {
-            //在第i列的第i行到第n行元素中寻找不为0的主元
-            size_t NoneZeroIndex = i;
-            while (NoneZeroIndex <= r.uRow && r.ElemAt(NoneZeroIndex, i) == T(0))
-                ++NoneZeroIndex;
-            if (NoneZeroIndex == r.uRow + 1) //该列全部为0
-                continue;
-            else if (NoneZeroIndex != i) //非0主元不是(i,i)
-                r.RowInterchange(NoneZeroIndex, i);
-
-            //元素(i,i)变为1
-            r.RowScaling(i, T(1) / r.ElemAt(i, i));
+            A.Apply(VectorView<const T>(p, n), VectorView<T>(q, n));
+            T pq = Dot(n, p, q);
+            if (pq == T(0))
+                break;
+            T alpha = rz / pq;
+            Parallel(n, [&](size_t i)
+                     {
+                         px[i] += alpha * p[i];
+                         r[i] -= alpha * q[i];
+                     });
+            ++iterations;
+            if (Record(Norm(n, r) / normB))
+                break;
 
-            //从第i+1行开始各行第i个元素化为0
-            for (size_t j = i + 1; j <= r.uRow; ++j)
-                r.RowAddition(i, -r.ElemAt(j, i), j);
+            Precondition(M, n, r, z);
+            T rzNew = Dot(n, r, z);
+            T beta = rzNew / rz;
+            rz = rzNew;
+            Parallel(n, [&](size_t i)
+                     { p[i] = z[i] + beta * p[i]; });
         }
+        return converged;
+    }
 
-        //从下往上化简形成行最简矩阵
-        for (size_t i = r.uRow; i > 0; --i)
+    bool BiCGSTAB(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, const LinearOperator<T> *M)
+    {
+        MATRIX_PROFILE_SCOPE("BiCGSTAB");
+        size_t n = A.Size();
+        T normB = Start(A, b, x, 8);
+        if (normB == T(0))
+            return true;
+        T *r = work.data(), *rHat = r + n, *p = rHat + n, *v = p + n, *pHat = v + n, *s = pHat + n, *sHat = s + n, *t = sHat + n;
+        T *px = x.Data();
+
+        if (Record(Norm(n, r) / normB))
+            return true;
+        std::copy(r, r + n, rHat);
+        std::fill(p, p + n, T(0));
+        std::fill(v, v + n, T(0));
+        T rho = T(1), alpha = T(1), omega = T(1);
+        while (iterations < maxIterations)
         {
-            if (r.ElemAt(i, i) == T(0))
-                continue;
-            for (size_t j = 1; j < i; ++j)
-                r.RowAddition(i, -r.ElemAt(j, i), j);
+            T rhoNew = Dot(n, rHat, r);
+            if (rhoNew == T(0) || omega == T(0))
+                break;
+            T beta = (rhoNew / rho) * (alpha / omega);
+            rho = rhoNew;
+            Parallel(n, [&](size_t i)
+                     { p[i] = r[i] + beta * (p[i] - omega * v[i]); });
+
+            Precondition(M, n, p, pHat);
+            A.Apply(VectorView<const T>(pHat, n), VectorView<T>(v, n));
+            T rv = Dot(n, rHat, v);
+            if (rv == T(0))
+                break;
+            alpha = rho / rv;
+            Parallel(n, [&](size_t i)
+                     { s[i] = r[i] - alpha * v[i]; });
+            ++iterations;
+            T normS = Norm(n, s);
+            if (normS <= tolerance * normB)
+            {
+                Parallel(n, [&](size_t i)
+                         { px[i] += alpha * pHat[i]; });
+                Record(normS / normB);
+                break;
+            }
+
+            Precondition(M, n, s, sHat);
+            A.Apply(VectorView<const T>(sHat, n), VectorView<T>(t, n));
+            T tt = Dot(n, t, t);
+            omega = tt > T(0) ? Dot(n, t, s) / tt : T(0);
+            Parallel(n, [&](size_t i)
+                     {
+                         px[i] += alpha * pHat[i] + omega * sHat[i];
+                         r[i] = s[i] - omega * t[i];
+                     });
+            if (Record(Norm(n, r) / normB))
+                break;
         }
+        return converged;
+    }
 
-        //让所有(i,i)非零行在最上面
-        for (size_t i = 1; i <= r.uRow; ++i)
+    bool GMRES(const LinearOperator<T> &A, const Vector<T> &b, Vector<T> &x, const LinearOperator<T> *M)
+    {
+        MATRIX_PROFILE_SCOPE("GMRES");
+        using std::abs;
+        size_t n = A.Size();
+        size_t m = restart < n ? restart : n;
+        if (m == 0)
+            m = 1;
+        //工作向量：r，基向量V（m+1个），预条件后的基向量Z（m个）
+        T normB = Start(A, b, x, 1 + (m + 1) + m);
+        if (normB == T(0))
+            return true;
+        T *r = work.data(), *V = r + n, *Z = V + (m + 1) * n, *px = x.Data();
+        hessenberg.resize((m + 1) * m);
+        givens.resize(2 * m);
+        rhs.resize(m + 1);
+
+        T beta = Norm(n, r);
+        if (Record(beta / normB))
+            return true;
+        while (iterations < maxIterations)
         {
-            if (r.ElemAt(i, i) != T(0))
-                continue;
+            //V₀ = r/||r||，g = ||r||e₁
+            Parallel(n, [&](size_t i)
+                     { V[i] = r[i] / beta; });
+            std::fill(rhs.begin(), rhs.end(), T(0));
+            rhs[0] = beta;
+
+            size_t k = 0;
+            bool done = false;
+            while (k < m && iterations < maxIterations)
+            {
+                T *vk = V + k * n, *zk = Z + k * n, *w = V + (k + 1) * n;
+                Precondition(M, n, vk, zk);
+                A.Apply(VectorView<const T>(zk, n), VectorView<T>(w, n));
 
-            size_t j = i;
-            for (; j <= r.uRow; ++j)
-                if (r.ElemAt(j, i) != T(0))
+                //修正Gram-Schmidt
+                T *h = hessenberg.data() + k; //第k列，行距为m
+                for (size_t i = 0; i <= k; ++i)
+                {
+                    T hik = Dot(n, w, V + i * n);
+                    h[i * m] = hik;
+                    MatrixKernel<T>::Axpy(n, -hik, V + i * n, 1, w, 1);
+                }
+                T hNext = Norm(n, w);
+                h[(k + 1) * m] = hNext;
+                if (hNext > T(0))
+                    Parallel(n, [&](size_t i)
+                             { w[i] /= hNext; });
+
+                //作用之前的旋转，再生成消去 h[k+1][k] 的旋转
+                for (size_t i = 0; i < k; ++i)
+                {
+                    T c = givens[2 * i], s = givens[2 * i + 1];
+                    T a = h[i * m], d = h[(i + 1) * m];
+                    h[i * m] = c * a + s * d;
+                    h[(i + 1) * m] = -s * a + c * d;
+                }
+                T a = h[k * m], d = h[(k + 1) * m];
+                T rNorm = std::hypot(a, d);
+                T c = rNorm > T(0) ? a / rNorm : T(1), s = rNorm > T(0) ? d / rNorm : T(0);
+                givens[2 * k] = c;
+                givens[2 * k + 1] = s;
+                h[k * m] = rNorm;
+                h[(k + 1) * m] = T(0);
+                rhs[k + 1] = -s * rhs[k];
+                rhs[k] = c * rhs[k];
+
+                ++k;
+                ++iterations;
+                //残差为0时（幸运中断）Krylov子空间已包含解
+                if (Record(abs(rhs[k]) / normB) || hNext == T(0))
                 {
-                    r.RowInterchange(i, j);
+                    done = true;
                     break;
                 }
+            }
 
-            if (j == r.uRow + 1)
+            //回代求解上三角最小二乘问题，x += Z·y
+            for (size_t i = k; i-- > 0;)
+            {
+                T sum = rhs[i];
+                for (size_t j = i + 1; j < k; ++j)
+                    sum -= hessenberg[i * m + j] * rhs[j];
+                rhs[i] = hessenberg[i * m + i] != T(0) ? sum / hessenberg[i * m + i] : T(0);
+            }
+            for (size_t i = 0; i < k; ++i)
+                MatrixKernel<T>::Axpy(n, rhs[i], Z + i * n, 1, px, 1);
+            if (done || iterations >= maxIterations)
                 break;
-        }
 
-        return r;
-    }
-
-private:
-    //行最简矩阵求秩
-    size_t RankOfReducedMatrix() const
-    {
-        size_t i = 1;
-        for (; i <= uRow; ++i)
-        {
-            const T *pRowHead = &ElementAt(i, 1);
-            size_t j = i - 1;
-            for (; j < uCol; ++j)
-                if (pRowHead[j] != T(0))
-                    break;
-            if (j == uCol)
+            //重启：重新计算真实残差
+            A.Apply(x, VectorView<T>(r, n));
+            Parallel(n, [&](size_t i)
+                     { r[i] = b[i] - r[i]; });
+            beta = Norm(n, r);
+            if (beta <= tolerance * normB)
+            {
+                residual = beta / normB;
+                converged = true;
                 break;
+            }
         }
-        return i - 1;
+        return converged;
     }
+};
 
+/**
+ * @brief 混合精度迭代修正线性方程组求解器
+ *
+ * 以低精度（默认float）分解系数矩阵，再以高精度（默认double）计算残差
+ * 并迭代修正解，在矩阵条件数不太大时得到与高精度分解相同精度的解。
+ * 若低精度分解失败、迭代不收敛或残差不再下降，自动回退到高精度分解求解。
+ *
+ * 收敛判据与LAPACK的dsgesv相同：对每个右端向量，
+ * ||r||∞ <= ||x||∞ · ||A||∞ · ε · √n
+ *
+ * @tparam T    高精度数据类型
+ * @tparam TLow 低精度数据类型
+ */
+template <typename T = double, typename TLow = float>
+class MixedPrecisionSolver
+{
 public:
-    /**
-        @brief 矩阵求秩
-        @return	矩阵的秩
-    */
-    size_t Rank() const
+    enum Method
     {
-        Matrix<T> reducedMat = this->RowReduce();
-        return reducedMat.RankOfReducedMatrix();
-    }
+        LU,       //部分选主元LU分解，适用于一般方阵
+        CHOLESKY, //Cholesky分解，适用于对称正定矩阵
+    };
+
+private:
+    Matrix<T> A;                                            //系数矩阵
+    Method method;                                          //分解方法
+    size_t maxIterations;                                   //最大修正次数
+    T normA = T(0);                                         //系数矩阵的无穷范数
+    std::unique_ptr<LUDecomposition<TLow>> pLowLU;          //低精度LU分解
+    std::unique_ptr<CholeskyDecomposition<TLow>> pLowChol;  //低精度Cholesky分解
+    std::unique_ptr<LUDecomposition<T>> pHighLU;            //高精度LU分解（回退时构造）
+    std::unique_ptr<CholeskyDecomposition<T>> pHighChol;    //高精度Cholesky分解（回退时构造）
+    bool lowUsable = false;                                 //低精度分解是否可用
+    size_t iterations = 0;                                  //上次求解的修正次数
+    bool fellBack = false;                                  //上次求解是否回退到高精度
 
 public:
     /**
-        @brief 判断当前矩阵是否可逆
-        @return	若可逆，返回true；否则返回false
-    */
-    bool Invertible() const
+     * @brief 求解器构造函数：以低精度分解系数矩阵
+     *
+     * @param mat           系数方阵
+     * @param m             分解方法
+     * @param maxIter       最大修正次数，超过后回退到高精度求解
+     */
+    explicit MixedPrecisionSolver(const Matrix<T> &mat, Method m = LU, size_t maxIter = 30)
+        : A(mat), method(m), maxIterations(maxIter)
     {
-        if (this->uRow != this->uCol || this->Rank() != this->uRow)
-            return false;
-        return true;
+        assert(mat.RowSize() == mat.ColumnSize());
+        using std::abs;
+
+        size_t n = A.RowSize();
+        const T *a = A.Data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            T rowSum = T(0);
+            for (size_t j = 0; j < n; ++j)
+                rowSum += abs(a[i * n + j]);
+            if (rowSum > normA)
+                normA = rowSum;
+        }
+
+        //超出低精度表示范围时直接使用高精度
+        if (!(normA < T(std::numeric_limits<TLow>::max())))
+            return;
+
+        Matrix<TLow> lowA(A);
+        if (method == CHOLESKY)
+        {
+            pLowChol.reset(new CholeskyDecomposition<TLow>(lowA));
+            lowUsable = pLowChol->IsPositiveDefinite();
+        }
+        else
+        {
+            pLowLU.reset(new LUDecomposition<TLow>(lowA));
+            lowUsable = !pLowLU->IsSingular();
+        }
     }
 
-public:
     /**
-        @brief 矩阵求逆
-        @return 若矩阵可逆，返回逆矩阵；否则返回空矩阵
-    */
-    Matrix<T> Inverse() const
+     * @brief 求解线性方程组 AX = B
+     *
+     * @param b 右端矩阵，行数与A相同，每一列为一个右端向量
+     * @return Matrix<T> 解矩阵X
+     */
+    Matrix<T> Solve(const Matrix<T> &b)
     {
-        //判断是否为方阵
-        assert(uRow == uCol);
+        MATRIX_PROFILE_SCOPE("MixedPrecisionSolve");
+        assert(b.RowSize() == A.RowSize());
+        using std::abs;
+        using std::sqrt;
+
+        iterations = 0;
+        fellBack = false;
+        if (!lowUsable)
+        {
+            fellBack = true;
+            return SolveHigh(b);
+        }
+
+        size_t n = A.RowSize(), m = b.ColumnSize();
+        T cte = normA * std::numeric_limits<T>::epsilon() * sqrt(T(n));
+        T prevRatio = std::numeric_limits<T>::infinity();
+
+        Matrix<T> x(SolveLow(b));
+        for (;;)
+        {
+            Matrix<T> r = b - A * x;
+
+            //逐列检查收敛，同时记录最差的相对残差
+            bool converged = true;
+            T worstRatio = T(0);
+            const T *pr = r.Data(), *px = x.Data();
+            for (size_t j = 0; j < m; ++j)
+            {
+                T rNorm = T(0), xNorm = T(0);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (abs(pr[i * m + j]) > rNorm || pr[i * m + j] != pr[i * m + j])
+                        rNorm = abs(pr[i * m + j]);
+                    if (abs(px[i * m + j]) > xNorm)
+                        xNorm = abs(px[i * m + j]);
+                }
+                if (!(rNorm <= xNorm * cte))
+                    converged = false;
+                T ratio = rNorm / (xNorm > T(0) ? xNorm : T(1));
+                if (!(ratio <= worstRatio))
+                    worstRatio = ratio;
+            }
+            if (converged)
+                return x;
+
+            //修正次数用尽或残差不再下降（条件数过大），回退到高精度
+            if (iterations == maxIterations || !(worstRatio < prevRatio))
+                break;
+            prevRatio = worstRatio;
 
-        //生成单位矩阵
-        Matrix<T> E(uRow, uRow);
-        for (size_t i = 1; i <= E.uRow; ++i)
-            E.ElemAt(i, i) = T(1);
-        //将单位阵合并在矩阵右侧并行约化
-        Matrix<T> ReducedCombinedMat = this->CombineWith(E, RIGHT).RowReduce();
-        //判断矩阵是否满秩（可逆）
-        assert(ReducedCombinedMat.RankOfReducedMatrix() == uRow);
+            ++iterations;
+            x = x + SolveLow(r);
+        }
 
-        //将右侧部分分割并返回
-        return ReducedCombinedMat.ColumnSplit(this->uCol + 1, RIGHT);
+        fellBack = true;
+        return SolveHigh(b);
     }
 
-public:
     /**
-     *  @brief 矩阵输出为字符串
-     *  @return 矩阵流输出的字符串
+     * @brief 上次求解使用的修正次数
+     *
+     * @return size_t 迭代修正次数（回退前已进行的次数）
      */
-    std::string toString()
+    size_t Iterations() const
     {
-        std::stringstream s;
-        s << *this;
-        return s.str();
+        return iterations;
     }
 
-public:
     /**
-     * @brief 生成一个全0矩阵
-     * 
-     * @param size 矩阵的阶数
-     * @return Matrix<T> size * size 大小的全0矩阵
+     * @brief 上次求解是否回退到了高精度分解
+     *
+     * @return 若回退，返回true
      */
-    static Matrix<T> Zeroes(size_t size)
+    bool FellBack() const
     {
-        return Matrix<T>(size, size, T(0));
+        return fellBack;
     }
 
-public:
-    /**
-     * @brief 生成一个单位矩阵
-     * 
-     * @param size 矩阵的阶数
-     * @return Matrix<T> size * size 大小的单位矩阵
-     */
-    static Matrix<T> Identity(size_t size)
+private:
+    //以低精度分解求解，结果转换回高精度
+    Matrix<T> SolveLow(const Matrix<T> &b) const
     {
-        Matrix<T> &&mat = Zeroes(size);
-        for (size_t i = 1; i <= size; ++i)
-            mat.ElemAt(i, i) = T(1);
-        return mat;
+        Matrix<TLow> lowB(b);
+        if (method == CHOLESKY)
+            return Matrix<T>(pLowChol->Solve(lowB));
+        return Matrix<T>(pLowLU->Solve(lowB));
+    }
+
+    //以高精度分解求解，分解在首次需要时进行
+    Matrix<T> SolveHigh(const Matrix<T> &b)
+    {
+        if (method == CHOLESKY)
+        {
+            if (!pHighChol)
+                pHighChol.reset(new CholeskyDecomposition<T>(A));
+            if (pHighChol->IsPositiveDefinite())
+                return pHighChol->Solve(b);
+        }
+        if (!pHighLU)
+            pHighLU.reset(new LUDecomposition<T>(A));
+        return pHighLU->Solve(b);
     }
+};
+
+template <typename T>
+class MatrixBatchLU;
+
+/**
+ * @brief 批量小矩阵
+ *
+ * 存储N个同型矩阵，各矩阵的同一位置元素连续存放（结构数组布局）：
+ * 第b个矩阵的(i, j)元素位于 data[(i * 列数 + j) * N + b]。
+ * 所有批量运算在最内层循环遍历矩阵序号，使SIMD通道跨矩阵并行，
+ * 并按矩阵序号分块交给线程池并行执行。
+ *
+ * 矩阵序号与行列序号均从0开始。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class MatrixBatch
+{
+    friend MatrixBatchLU<T>;
+
+private:
+    size_t uCount; //矩阵个数
+    size_t uRow;   //行数
+    size_t uCol;   //列数
+    std::vector<T> data;
+
+public:
+    static const size_t uPacket = 64;          //一次处理的矩阵个数，内层循环长度
+    static const size_t uPacketsPerTask = 16; //每个并行任务至少包含的分组数
 
 public:
     /**
-     * @brief 生成一个全1矩阵
-     * 
-     * @param size 矩阵的阶数
-     * @return Matrix<T> size * size 大小的全1矩阵
+     * @brief 批量矩阵构造函数：元素全为0
+     *
+     * @param count 矩阵个数
+     * @param row   每个矩阵的行数
+     * @param col   每个矩阵的列数
      */
-    static Matrix<T> Ones(size_t size)
+    MatrixBatch(size_t count, size_t row, size_t col) : uCount(count), uRow(row), uCol(col), data(count * row * col)
     {
-        return Matrix<T>(size, size, T(1));
+        MATRIX_PROFILE_EVENT(RecordAlloc(count * row * col * sizeof(T)));
     }
 
-public:
     /**
-     * @brief 生成一个随机元素矩阵
-     * 
-     * 矩阵的元素在0~1之间随机取值，该函数要求double类型可以转换到模板参数T类型
-     * 
-     * @param rows  行数
-     * @param cols  列数
-     * @return Matrix<T> rows * cols 大小的随机矩阵
+     * @brief 生成一批单位矩阵
+     *
+     * @param count 矩阵个数
+     * @param size  矩阵阶数
+     * @return MatrixBatch<T> 批量单位矩阵
      */
-    static Matrix<T> Rand(size_t rows, size_t cols)
+    static MatrixBatch<T> Identity(size_t count, size_t size)
     {
-        unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-        std::mt19937_64 gen(seed);
-        std::uniform_real_distribution<> dis(0.0, 1.0);
+        MatrixBatch<T> r(count, size, size);
+        for (size_t i = 0; i < size; ++i)
+            std::fill_n(r.data.begin() + (i * size + i) * count, count, T(1));
+        return r;
+    }
 
-        std::vector<T> values;
-        values.reserve(rows * cols);
-        for (size_t i = 0; i < rows * cols; ++i)
-            values.emplace_back(dis(gen));
+    //矩阵个数
+    size_t Count() const
+    {
+        return uCount;
+    }
 
-        return Matrix<T>(rows, cols, values);
+    //每个矩阵的行数
+    size_t RowSize() const
+    {
+        return uRow;
+    }
+
+    //每个矩阵的列数
+    size_t ColumnSize() const
+    {
+        return uCol;
     }
 
-public:
     /**
-     * @brief 生成一个随机元素矩阵
-     * 
-     * 矩阵的元素在0~1之间随机取值，该函数要求double类型可以转换到模板参数T类型
-     * 
-     * @param size  阶数
-     * @return Matrix<T> size * size 大小的随机方阵
+     * @brief 获取批量数据的头指针
+     *
+     * @return T* 数据指针，布局见类说明
      */
-    static Matrix<T> Rand(size_t size)
+    T *Data()
     {
-        return Matrix<T>::Rand(size, size);
+        return data.data();
     }
-};
-
-/**
-    @brief 矩阵流输出运算符重载
 
-    要求矩阵数据T类已重载流输出运算符
-*/
-#include <iomanip>
-template <typename T>
-std::ostream &operator<<(std::ostream &os, const Matrix<T> &mat)
-{
-    T *pRowHead = mat.pData;
-    os << "[\n";
-    for (size_t i = 1; i <= mat.uRow; ++i)
+    const T *Data() const
     {
-        for (size_t j = 0; j < mat.uCol; ++j)
-            os << std::setw(12) << std::setfill(' ') << std::setprecision(4) << pRowHead[j];
-        os << ";\n";
-        pRowHead += mat.uCol;
+        return data.data();
     }
-    os << "]\n";
-    return os;
-}
-
-/**
-    矩阵数乘（数在左）：
-    返回数左乘矩阵的结果
-*/
-template <typename T>
-inline Matrix<T> operator*(const T &c, const Matrix<T> &mat)
-{
-    return mat * c;
-}
 
-/**
- * @brief 行列式
- * 
- * @tparam T 行列式数据类型 
- */
-template <typename T>
-class Determinant
-{
-private:
-    Matrix<T> *pMat;
-    size_t size = 0;
+    /**
+     * @brief 元素访问与修改，序号从0开始
+     *
+     * @param b   矩阵序号
+     * @param row 行号
+     * @param col 列号
+     * @return T& 元素的引用
+     */
+    T &ElemAt0(size_t b, size_t row, size_t col)
+    {
+        assert(b < uCount && row < uRow && col < uCol);
+        return data[(row * uCol + col) * uCount + b];
+    }
 
-public:
-    //构造函数
+    const T &ElemAt0(size_t b, size_t row, size_t col) const
+    {
+        assert(b < uCount && row < uRow && col < uCol);
+        return data[(row * uCol + col) * uCount + b];
+    }
 
     /**
-     * @brief 行列式构造函数：无参
-     * 
+     * @brief 设置第b个矩阵
+     *
+     * @param b   矩阵序号
+     * @param mat 同型矩阵
      */
-    Determinant() : Determinant(0) {}
+    void Set(size_t b, const Matrix<T> &mat)
+    {
+        assert(b < uCount && mat.RowSize() == uRow && mat.ColumnSize() == uCol);
+        const T *p = mat.Data();
+        for (size_t e = 0; e < uRow * uCol; ++e)
+            data[e * uCount + b] = p[e];
+    }
 
     /**
-     * @brief 行列式构造函数：定义阶数
-     * 
-     * @param _size 行列式阶数
+     * @brief 取出第b个矩阵
+     *
+     * @param b 矩阵序号
+     * @return Matrix<T> 第b个矩阵的拷贝
      */
-    Determinant(size_t _size) : size(_size)
+    Matrix<T> Get(size_t b) const
     {
-        pMat = new Matrix<T>(size, size);
+        assert(b < uCount);
+        Matrix<T> mat(uRow, uCol);
+        T *p = mat.Data();
+        for (size_t e = 0; e < uRow * uCol; ++e)
+            p[e] = data[e * uCount + b];
+        return mat;
     }
 
     /**
-     * @brief 行列式构造函数：定义阶数,数据
-     * 
-     * @param _size     行列式阶数
-     * @param data      行列式数据
-     * @param dataLen   行列式数据长度
+     * @brief 批量矩阵乘法：第b个结果为 this[b] * mat[b]
+     *
+     * @param mat 右乘的批量矩阵，个数相同，行数等于本批量的列数
+     * @return MatrixBatch<T> 批量乘积
      */
-    Determinant(size_t _size, const T *data, size_t dataLen) : Determinant(_size)
+    MatrixBatch<T> operator*(const MatrixBatch<T> &mat) const
     {
-        size_t elemCount = _size * _size;
-        memcpy_s(pMat->pData, elemCount * sizeof(T), data,
-                 dataLen > elemCount ? elemCount * sizeof(T) : dataLen * sizeof(T));
+        MATRIX_PROFILE_SCOPE("BatchMultiply");
+        assert(uCount == mat.uCount && uCol == mat.uRow);
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * uCount * uRow * uCol * mat.uCol));
+
+        MatrixBatch<T> r(uCount, uRow, mat.uCol);
+        const size_t N = uCount, m = uRow, K = uCol, n = mat.uCol;
+        ForEachPacket([&](size_t b0, size_t w)
+                      {
+                          const T *a = data.data() + b0;
+                          const T *b = mat.data.data() + b0;
+                          T *c = r.data.data() + b0;
+                          for (size_t i = 0; i < m; ++i)
+                              for (size_t k = 0; k < K; ++k)
+                              {
+                                  const T *pa = a + (i * K + k) * N;
+                                  for (size_t j = 0; j < n; ++j)
+                                  {
+                                      const T *pb = b + (k * n + j) * N;
+                                      T *pc = c + (i * n + j) * N;
+                                      for (size_t l = 0; l < w; ++l)
+                                          pc[l] += pa[l] * pb[l];
+                                  }
+                              }
+                      });
+        return r;
     }
 
     /**
-     * @brief 行列式构造函数: 由方阵构造
-     * 
-     * @param mat 方阵
+     * @brief 批量LU分解（方阵）
+     *
+     * @return MatrixBatchLU<T> 分解结果，可用于求解、求逆与行列式
      */
-    Determinant(const Matrix<T> &mat)
+    MatrixBatchLU<T> LU() const
     {
-        assert(mat.uRow == mat.uCol);
-        pMat = new Matrix<T>(mat);
-        size = mat.uRow;
+        return MatrixBatchLU<T>(*this);
     }
 
     /**
-     * @brief 行列式拷贝构造函数
-     * 
-     * @param det 
+     * @brief 批量求逆矩阵
+     *
+     * @return MatrixBatch<T> 各矩阵的逆矩阵，奇异矩阵的结果未定义
      */
-    Determinant(const Determinant<T> &det) : Determinant(*det.pMat) {}
+    MatrixBatch<T> Inverse() const
+    {
+        return LU().Inverse();
+    }
 
     /**
-     * @brief 行列式移动拷贝函数
-     * 
-     * @param det 
+     * @brief 批量求行列式
+     *
+     * @return std::vector<T> 各矩阵的行列式
      */
-    Determinant(Determinant<T> &&det) noexcept
+    std::vector<T> Determinant() const
     {
-        this->size = det.size;
-        this->pMat = det.pMat;
-        det.pMat = nullptr;
+        return LU().Determinant();
     }
 
-    //析构函数
-    virtual ~Determinant()
+    /**
+     * @brief 批量求解线性方程组 this[b] * X[b] = B[b]
+     *
+     * @param rhs 右端批量矩阵
+     * @return MatrixBatch<T> 解
+     */
+    MatrixBatch<T> Solve(const MatrixBatch<T> &rhs) const
     {
-        if (pMat)
-            delete pMat;
+        return LU().Solve(rhs);
     }
 
+private:
     /**
-     * @brief 行列式赋值运算符函数
-     * 
-     * @param det 
-     * @return Determinant<T>& 
+     * @brief 按分组遍历矩阵序号并并行执行
+     *
+     * @param f 对每组调用 f(起始矩阵序号, 组内矩阵个数)
      */
-    Determinant<T> &operator=(const Determinant<T> &det)
+    template <typename F>
+    void ForEachPacket(F &&f) const
     {
-        if (&det == this)
-            return *this;
-
-        pMat = new Matrix<T>(*det.pMat);
+        size_t packets = (uCount + uPacket - 1) / uPacket;
+        MatrixThreadPool::ParallelFor(0, packets, uPacketsPerTask, [&](size_t p0, size_t p1)
+                                      {
+                                          for (size_t p = p0; p < p1; ++p)
+                                          {
+                                              size_t b0 = p * uPacket;
+                                              size_t w = uCount - b0;
+                                              if (w > uPacket)
+                                                  w = uPacket;
+                                              f(b0, w);
+                                          }
+                                      });
+    }
+};
 
-        this->size = pMat->uRow;
+/**
+ * @brief 批量LU分解
+ *
+ * 对批量方阵逐个进行部分选主元的LU分解。选主元与消元在矩阵序号方向向量化，
+ * 只有行交换按矩阵逐个进行。
+ *
+ * @tparam T 矩阵数据类型
+ */
+template <typename T>
+class MatrixBatchLU
+{
+private:
+    MatrixBatch<T> lu;         //L与U合并存储
+    std::vector<size_t> piv;   //第k步第b个矩阵的主元行：piv[k * N + b]
+    std::vector<T> sign;       //各矩阵置换的符号
+    std::vector<char> singular; //各矩阵是否奇异
 
-        return *this;
+public:
+    /**
+     * @brief 批量LU分解构造函数
+     *
+     * @param batch 批量方阵
+     */
+    explicit MatrixBatchLU(const MatrixBatch<T> &batch)
+        : lu(batch), piv(batch.uRow * batch.uCount), sign(batch.uCount, T(1)), singular(batch.uCount, 0)
+    {
+        MATRIX_PROFILE_SCOPE("BatchLU");
+        assert(batch.uRow == batch.uCol);
+        using std::abs;
+
+        const size_t N = lu.uCount, n = lu.uRow;
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * N * n * n * n / 3));
+        lu.ForEachPacket([&](size_t b0, size_t w)
+                         {
+                             T *a = lu.data.data() + b0;
+                             T pivAbs[MatrixBatch<T>::uPacket];
+                             T pivRow[MatrixBatch<T>::uPacket];
+                             T inv[MatrixBatch<T>::uPacket];
+                             for (size_t k = 0; k < n; ++k)
+                             {
+                                 //各矩阵在第k列选取绝对值最大的主元
+                                 T *pkk = a + (k * n + k) * N;
+                                 for (size_t l = 0; l < w; ++l)
+                                 {
+                                     pivAbs[l] = abs(pkk[l]);
+                                     pivRow[l] = T(k);
+                                 }
+                                 for (size_t i = k + 1; i < n; ++i)
+                                 {
+                                     const T *pik = a + (i * n + k) * N;
+                                     for (size_t l = 0; l < w; ++l)
+                                     {
+                                         T v = abs(pik[l]);
+                                         bool larger = v > pivAbs[l];
+                                         pivAbs[l] = larger ? v : pivAbs[l];
+                                         pivRow[l] = larger ? T(i) : pivRow[l];
+                                     }
+                                 }
+
+                                 //逐个矩阵交换行
+                                 for (size_t l = 0; l < w; ++l)
+                                 {
+                                     size_t p = static_cast<size_t>(pivRow[l]);
+                                     piv[k * N + b0 + l] = p;
+                                     if (p == k)
+                                         continue;
+                                     sign[b0 + l] = -sign[b0 + l];
+                                     for (size_t j = 0; j < n; ++j)
+                                     {
+                                         T tmp = a[(k * n + j) * N + l];
+                                         a[(k * n + j) * N + l] = a[(p * n + j) * N + l];
+                                         a[(p * n + j) * N + l] = tmp;
+                                     }
+                                 }
+
+                                 //主元为0的矩阵标记为奇异，乘数置0以免产生无穷大
+                                 for (size_t l = 0; l < w; ++l)
+                                 {
+                                     bool zero = pivAbs[l] == T(0);
+                                     singular[b0 + l] |= zero;
+                                     inv[l] = zero ? T(0) : T(1) / pkk[l];
+                                 }
+
+                                 for (size_t i = k + 1; i < n; ++i)
+                                 {
+                                     T *pik = a + (i * n + k) * N;
+                                     for (size_t l = 0; l < w; ++l)
+                                         pik[l] *= inv[l];
+                                     for (size_t j = k + 1; j < n; ++j)
+                                     {
+                                         const T *pkj = a + (k * n + j) * N;
+                                         T *pij = a + (i * n + j) * N;
+                                         for (size_t l = 0; l < w; ++l)
+                                             pij[l] -= pik[l] * pkj[l];
+                                     }
+                                 }
+                             }
+                         });
     }
 
     /**
-     * @brief 行列式移动赋值函数
-     * 
-     * @param det 
-     * @return Determinant<T>& 
+     * @brief 各矩阵是否奇异
+     *
+     * @param b 矩阵序号
+     * @return 若第b个矩阵奇异，返回true
      */
-    Determinant<T> &operator=(Determinant<T> &&det) noexcept
+    bool IsSingular(size_t b) const
     {
-        if (&det == this)
-            return *this;
-        Matrix<T> &mat = *det.pMat;
-        pMat->uRow = mat.uRow;
-        pMat->uCol = mat.uCol;
-        pMat->uCapacity = mat.uCapacity;
-        pMat->pData = mat.pData;
-        mat.pData = nullptr;
-
-        this->size = mat.uRow;
-
-        return *this;
+        return singular[b] != 0;
     }
 
     /**
-     * @brief 行列式求值
-     * 
-     * @return T 行列式的值
+     * @brief 批量求行列式
+     *
+     * @return std::vector<T> 各矩阵的行列式
      */
-    T Value() const
+    std::vector<T> Determinant() const
     {
-        if (this->size == 1)
-            return this->pMat->pData[0];
-
-        T sum = T(0), sign = T(1);
-
-        for (size_t i = 0; i < size; ++i)
+        const size_t N = lu.uCount, n = lu.uRow;
+        std::vector<T> det(sign);
+        for (size_t k = 0; k < n; ++k)
         {
-            Matrix<T> &&minorMat = pMat->MinorOf(1, i + 1);
-            Determinant minorDet(minorMat);
-            sum += sign * minorDet.Value() * pMat->pData[i];
-            sign = -sign;
+            const T *pkk = lu.data.data() + (k * n + k) * N;
+            for (size_t b = 0; b < N; ++b)
+                det[b] *= pkk[b];
         }
+        return det;
+    }
 
-        return sum;
+    /**
+     * @brief 批量求解线性方程组
+     *
+     * @param rhs 右端批量矩阵，个数与行数与分解的矩阵相同
+     * @return MatrixBatch<T> 解
+     */
+    MatrixBatch<T> Solve(const MatrixBatch<T> &rhs) const
+    {
+        MATRIX_PROFILE_SCOPE("BatchLUSolve");
+        assert(rhs.uCount == lu.uCount && rhs.uRow == lu.uRow);
+
+        const size_t N = lu.uCount, n = lu.uRow, m = rhs.uCol;
+        MATRIX_PROFILE_EVENT(RecordFlops(2ull * N * n * n * m));
+        MatrixBatch<T> x(rhs);
+        lu.ForEachPacket([&](size_t b0, size_t w)
+                         {
+                             const T *a = lu.data.data() + b0;
+                             T *px = x.data.data() + b0;
+
+                             //按分解时的顺序交换右端行
+                             for (size_t k = 0; k < n; ++k)
+                                 for (size_t l = 0; l < w; ++l)
+                                 {
+                                     size_t p = piv[k * N + b0 + l];
+                                     if (p == k)
+                                         continue;
+                                     for (size_t j = 0; j < m; ++j)
+                                     {
+                                         T tmp = px[(k * m + j) * N + l];
+                                         px[(k * m + j) * N + l] = px[(p * m + j) * N + l];
+                                         px[(p * m + j) * N + l] = tmp;
+                                     }
+                                 }
+
+                             //前代
+                             for (size_t i = 0; i < n; ++i)
+                                 for (size_t k = 0; k < i; ++k)
+                                 {
+                                     const T *pik = a + (i * n + k) * N;
+                                     for (size_t j = 0; j < m; ++j)
+                                     {
+                                         const T *pkj = px + (k * m + j) * N;
+                                         T *pij = px + (i * m + j) * N;
+                                         for (size_t l = 0; l < w; ++l)
+                                             pij[l] -= pik[l] * pkj[l];
+                                     }
+                                 }
+
+                             //回代
+                             for (size_t i = n; i-- > 0;)
+                             {
+                                 for (size_t k = i + 1; k < n; ++k)
+                                 {
+                                     const T *pik = a + (i * n + k) * N;
+                                     for (size_t j = 0; j < m; ++j)
+                                     {
+                                         const T *pkj = px + (k * m + j) * N;
+                                         T *pij = px + (i * m + j) * N;
+                                         for (size_t l = 0; l < w; ++l)
+                                             pij[l] -= pik[l] * pkj[l];
+                                     }
+                                 }
+                                 const T *pii = a + (i * n + i) * N;
+                                 for (size_t j = 0; j < m; ++j)
+                                 {
+                                     T *pij = px + (i * m + j) * N;
+                                     for (size_t l = 0; l < w; ++l)
+                                         pij[l] /= pii[l];
+                                 }
+                             }
+                         });
+        return x;
+    }
+
+    /**
+     * @brief 批量求逆矩阵
+     *
+     * @return MatrixBatch<T> 各矩阵的逆矩阵
+     */
+    MatrixBatch<T> Inverse() const
+    {
+        return Solve(MatrixBatch<T>::Identity(lu.uCount, lu.uRow));
     }
 };
@@ -1,5 +1,6 @@
 
 #define MATRIX_INDEX_START_AT_0
+#define MATRIX_ENABLE_PROFILER
 
 #include "../Matrix.h"
 
@@ -121,6 +122,15 @@ int main()
     // random elements uniformly distributed between 0.0~1.0
     VX(mat11);
 
+    // Seeded random fills are reproducible regardless of thread count
+    Matrixd mat11_1 = Matrixd::Rand(3, 2, 42);
+    Matrixd mat11_2(3, 2);
+    mat11_2.FillUniform(0.0, 1.0, 42);
+    // Equals mat11_1
+    VX(mat11_2);
+    mat11_2.FillInteger(-9, 9, 7);
+    VX(mat11_2);
+
     ////////////////////////////////
     //       Modify Elements      //
     ////////////////////////////////
@@ -166,6 +176,26 @@ int main()
 	*/
     VX(mat12);
 
+    // Apply / Map / Zip / Reduce accept any callable
+    double offset = 1;
+    mat12.Apply([offset](double &elem)
+                { elem += offset; });
+    Matrix<int> mat12_1 = mat12.Map([](double elem)
+                                    { return int(elem) * 2; });
+    /*
+    mat12_1
+        2   2   2
+        8   10  12
+    */
+    VX(mat12_1);
+    Matrixd mat12_2 = mat12.Zip(mat12_1, [](double a, int b)
+                                { return a * b; });
+    double mat12Sum = mat12_2.Reduce(0.0, [](double s, double elem)
+                                     { return s + elem; },
+                                     Matrixd::PARALLEL);
+    // 2 + 2 + 2 + 32 + 50 + 72 = 160
+    VX(mat12Sum);
+
     ////////////////////////////////
     //  Basic Matrix Operations   //
     ////////////////////////////////
@@ -244,6 +274,14 @@ int main()
     size_t rank = mat13_3.Rank();
     // 3
     VX(rank);
+    // Rank-revealing QR of a nearly rank-1 matrix
+    Matrixd mat13_15({{1, 2, 3}, {2, 4, 6}, {3, 6, 9.000000000001}});
+    PivotedQRDecomposition<double> pqr13(mat13_15);
+    // 2, and 1 with a looser tolerance
+    VX(pqr13.Rank());
+    VX(mat13_15.Rank(1e-9));
+    // 2: the largest column is taken first
+    VX(pqr13.Pivots()[0]);
 
     // Inverse
     if (mat13_3.Invertible())
@@ -258,6 +296,115 @@ int main()
         0.571429     -0.285714    0.214286
     */
 
+    // Strassen-Winograd multiplication (a tiny cutoff only to exercise the recursion)
+    Matrixd mat13_11 = mat13_3.Multiply(mat13_3, Matrixd::STRASSEN, 1);
+    // Equals mat13_3 * mat13_3 up to rounding
+    VX(mat13_11);
+
+    // Lazy matrix chain: (3x1)(1x3)(3x1) is evaluated as (3x1)((1x3)(3x1))
+    Matrixd col13({{1}, {2}, {3}}), row13({{1, 1, 1}});
+    auto chain13 = col13.Lazy() * row13 * col13;
+    // (0 (1 2))
+    VX(chain13.Order());
+    Matrixd mat13_16 = chain13;
+    // [6 12 18]ᵀ
+    VX(mat13_16);
+
+    // In-place operations
+    Matrixd mat13_12 = mat13_3;
+    mat13_12 += mat13_3;
+    mat13_12 -= Matrixd::Identity(3);
+    mat13_12 *= 0.5;
+    mat13_12 /= 2.0;
+    /*
+    mat13_12
+        0.25    0.5     1
+        1       2.25    1
+        0       2       0.75
+    */
+    VX(mat13_12);
+
+    // Rvalue operands are computed in place: one allocation for mat13_3 + mat13_3
+    Matrixd mat13_14 = -(mat13_3 + mat13_3) * 0.5;
+    // Equals -mat13_3
+    VX(mat13_14);
+
+    // Copies share storage when MATRIX_COPY_ON_WRITE is defined
+    Matrixd mat13_17 = mat13_3;
+    //if defined MATRIX_COPY_ON_WRITE 		: 2
+    //if not defined MATRIX_COPY_ON_WRITE	: 1
+    VX(mat13_3.UseCount());
+    mat13_17.ElemAt(1, 1) = 0; // the first write detaches, mat13_3 is unchanged
+    VX(mat13_3.UseCount());
+
+    // C = 1 * mat13_3 * mat13_3 + 0 * C, reusing the buffer of C
+    Matrixd mat13_13(3, 3);
+    Matrixd::MultiplyInto(mat13_13, mat13_3, mat13_3);
+    // Equals mat13_3 * mat13_3
+    VX(mat13_13);
+
+    ////////////////////////////////
+    //          Vectors           //
+    ////////////////////////////////
+
+    Vectord vec1{1, 2, 3};
+    Vectord vec2 = mat13_3 * vec1;
+    // [9 18 14]
+    VX(vec2);
+
+    // y = 1 * mat13_3ᵀ * vec1 + 0 * y, without forming the transpose
+    Vectord vec3(3);
+    Vectord::Gemv(1.0, mat13_3, vec1, 0.0, vec3, true);
+    // [5 23 12]
+    VX(vec3);
+
+    // Rows and columns are strided views into the matrix
+    double dot = Vectord::Dot(mat13_3.Row(1), vec1);
+    // 18
+    VX(dot);
+    Vectord vec4 = vec1;
+    vec4.Axpy(2.0, mat13_3.Column(2));
+    // [5 6 7]
+    VX(vec4);
+    double norm = Vectord{3, 4}.Norm();
+    // 5
+    VX(norm);
+
+    ////////////////////////////////
+    //  Kronecker and Hadamard    //
+    ////////////////////////////////
+
+    Matrixd mat13_18({{1, 2}, {3, 4}}), mat13_19({{0, 1}, {1, 0}});
+    // [[0 1 0 2] [1 0 2 0] [0 3 0 4] [3 0 4 0]]
+    VX(Matrixd::Kronecker(mat13_18, mat13_19));
+    // [[0 2] [3 0]]
+    VX(Matrixd::Hadamard(mat13_18, mat13_19));
+    // [[1 1] [1 1]]
+    VX(Matrixd::HadamardDivide(mat13_18, mat13_18));
+    // [[1 2 3] [2 4 6] [3 6 9]]
+    VX(Matrixd::Outer(vec1, vec1));
+    // (A⊗B)x without forming A⊗B: [10 7 22 15]
+    KroneckerOperator<double> kron13(mat13_18, mat13_19);
+    Vectord vec5 = kron13 * Vectord({1, 2, 3, 4});
+    VX(vec5);
+
+    ////////////////////////////////
+    //         Reductions         //
+    ////////////////////////////////
+
+    // 19, 8
+    VX(mat13_3.Sum(Matrixd::KAHAN));
+    VX(mat13_3.Trace());
+    // [3 10 6]
+    VX(mat13_3.ColSums());
+    // 10 (column 1), 9 (row 1)
+    VX(mat13_3.Norm1());
+    VX(mat13_3.NormInf());
+    std::pair<size_t, size_t> maxPos = mat13_3.ArgMax();
+    // (1, 1)
+    VX(maxPos.first);
+    VX(maxPos.second);
+
     ////////////////////////////////
     //       Concatenation        //
     ////////////////////////////////
@@ -271,6 +418,18 @@ int main()
         5   6   7   0   0   1
     */
     VX(mat15);
+    // One allocation for the whole grid; nullptr is a zero block
+    Matrixd mat15_1 = Matrixd::Concat({{mat14, Matrixd::Identity(3)}, {nullptr, mat14}});
+    /*
+    mat15_1
+        2   3   4   1   0   0
+        3   4   5   0   1   0
+        5   6   7   0   0   1
+        0   0   0   2   3   4
+        0   0   0   3   4   5
+        0   0   0   5   6   7
+    */
+    VX(mat15_1);
 
     ////////////////////////////////
     //   Modify Rows and Columns  //
@@ -317,6 +476,15 @@ int main()
         1     2     3     4     0
     */
 
+    // Bulk insertion and removal move the data once
+    mat16.InsertColumns(1, Matrixd({{8, 9}, {8, 9}, {8, 9}, {8, 9}, {8, 9}}));
+    VX(mat16);
+    mat16.RemoveColumns({1, 2});
+    mat16.RemoveRows({4});
+    mat16.InsertRows(4, Matrixd({{1, 2, 3, 4, 0}}));
+    // Same as before
+    VX(mat16);
+
     // Extract a block of elements from the matrix
     // 2nd ~ 3rd row and 2nd ~ 4th column will be extracted
     Matrixd blockMat = mat16.Block(1, 1, 2, 3);
@@ -336,6 +504,189 @@ int main()
     // -59
     VX(detValue);
 
+    // Integer matrices are eliminated exactly (fraction-free / modular)
+    Matrix<long long> mat17i({{2, 1, 4}, {0, 2, 5}, {9, 6, 7}});
+    // -59
+    VX(Determinant<long long>(mat17i).Value());
+    long long invDen;
+    Matrix<long long> invNum = mat17i.Inverse(invDen);
+    /*
+    mat17⁻¹ = invNum / invDen, invDen = 59
+    invNum
+        16      -17     3
+        -45     22      10
+        18      3       -4
+    */
+    VX(invNum);
+    VX(invDen);
+    /*
+    Inverse modulo 7
+        3       6       1
+        6       5       1
+        6       1       1
+    */
+    VX(ModularElimination<long long>(mat17i, 7).Inverse());
+
+    ////////////////////////////////
+    //   Element Type Conversion  //
+    ////////////////////////////////
+
+    Matrix<float> mat18 = mat17.Cast<float>();
+    Matrixd mat19(mat18);
+    VX(mat18);
+
+    ////////////////////////////////
+    //   Mixed-Precision Solver   //
+    ////////////////////////////////
+
+    // Factor in float, refine with double residuals
+    Matrixd mat20({{4, 1, 0}, {1, 4, 1}, {0, 1, 4}});
+    Matrixd rhs20(3, 1, {1, 2, 3});
+    MixedPrecisionSolver<> solver(mat20);
+    Matrixd sol20 = solver.Solve(rhs20);
+    VX(sol20);
+    VX(solver.Iterations());
+
+    ////////////////////////////////
+    //  Symmetric Eigenproblems   //
+    ////////////////////////////////
+
+    SymmetricEigenDecomposition<double> eig20(mat20);
+    // [2.5858 4 5.4142]
+    VX(eig20.Eigenvalues());
+    VX(eig20.Eigenvectors());
+    // Only the largest eigenpair: 5.4142, [0.5 0.7071 0.5] up to sign
+    SymmetricEigenDecomposition<double> top20(mat20, SymmetricEigenDecomposition<double>::VECTORS, 1);
+    VX(top20.Eigenvalues());
+    VX(top20.Eigenvectors());
+
+    ////////////////////////////////
+    //      Complex Matrices      //
+    ////////////////////////////////
+
+    Matrix<std::complex<double>> mat20c("[2, 1-1i; 1+1i, 3]");
+    VX(mat20c);
+    VX(mat20c.Adjoint());
+    VX(mat20c * mat20c);
+    VX(mat20c.FrobeniusNorm());
+    // Hermitian positive definite: A = LLᴴ
+    VX(CholeskyDecomposition<std::complex<double>>(mat20c).Factor());
+    // [1 4]
+    VX(HermitianEigenDecomposition<std::complex<double>>(mat20c).Eigenvalues());
+
+    ////////////////////////////////
+    //  Reduced-precision Storage //
+    ////////////////////////////////
+
+    Matrix<Half> mat20h("[1 2.5; -3 0.1]");
+    // 0.1 is stored as 0.09998
+    VX(mat20h);
+    VX(Matrix<BFloat16>(mat20h));
+    VX(Matrix<double>(mat20h * mat20h));
+    // Accumulated in float: 4096
+    VX(Matrix<Half>(64, 64, Half(1.0f)).Sum());
+
+    ////////////////////////////////
+    // Singular Value Decomposition //
+    ////////////////////////////////
+
+    Matrixd mat21({{3, 0}, {0, -4}, {0, 0}});
+    SingularValueDecomposition<double> svd21(mat21);
+    // [4 3]
+    VX(svd21.SingularValues());
+    VX(svd21.U());
+    VX(svd21.V());
+    // [[0.3333 0 0] [0 -0.25 0]]
+    VX(mat21.PseudoInverse());
+
+    ////////////////////////////////
+    //     Iterative Solvers      //
+    ////////////////////////////////
+
+    // 1-D Poisson matrix tridiag(-1, 2, -1) of order 50
+    std::vector<SparseMatrix<double>::Triplet> entries22;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        entries22.push_back({i, i, 2.0});
+        if (i > 0)
+            entries22.push_back({i, i - 1, -1.0});
+        if (i + 1 < 50)
+            entries22.push_back({i, i + 1, -1.0});
+    }
+    SparseMatrix<double> mat22(50, 50, entries22);
+    Vectord rhs22(50, 1.0), sol22;
+    IterativeSolver<double> solver22(1e-10);
+    VX(solver22.CG(mat22, rhs22, sol22));
+    VX(solver22.Iterations());
+    // ILU(0) of a tridiagonal matrix is exact: one iteration
+    Vectord sol22b;
+    VX(solver22.GMRES(mat22, rhs22, sol22b, ILU0Preconditioner<double>(mat22)));
+    VX(solver22.Iterations());
+    VX(solver22.BiCGSTAB(mat22.ToDense(), rhs22, sol22b, JacobiPreconditioner<double>(mat22)));
+    VX(solver22.Residual());
+
+    ////////////////////////////////
+    //   Batched Small Matrices   //
+    ////////////////////////////////
+
+    // 1000 independent 3 x 3 systems stored interleaved
+    MatrixBatch<double> batch(1000, 3, 3), batchRhs(1000, 3, 1);
+    for (size_t b = 0; b < batch.Count(); ++b)
+    {
+        batch.Set(b, mat20 + Matrixd::Identity(3) * double(b));
+        batchRhs.Set(b, rhs20);
+    }
+    MatrixBatch<double> batchSol = batch.Solve(batchRhs);
+    std::vector<double> batchDet = batch.Determinant();
+    VX(batchSol.Get(0));
+    VX(batchDet[0]);
+
+    ////////////////////////////////
+    //       NUMA Placement       //
+    ////////////////////////////////
+
+    // Workers first-touch the pages of large matrices: row blocks for A, round-robin pages for B
+    MatrixThreadPool::PinWorkers(true);
+    MatrixMemory::SetDefaultPolicy(MatrixMemory::BLOCK_ROWS);
+    Matrixd mat23 = Matrixd::Rand(600, 600);
+    Matrixd mat23_1 = Matrixd::Rand(600, 600);
+    mat23_1.SetMemoryPolicy(MatrixMemory::INTERLEAVE);
+    Matrixd mat23_2 = mat23 * mat23_1 - mat23 * mat23_1;
+    VX(mat23_2.NormInf());
+    MatrixMemory::SetDefaultPolicy(MatrixMemory::CALLER);
+    MatrixThreadPool::PinWorkers(false);
+
+    ////////////////////////////////
+    //     Asynchronous Jobs      //
+    ////////////////////////////////
+
+    // Overlap an inversion with a product; a cancelled job throws from get()
+    MatrixJobControl job24;
+    std::future<Matrixd> inv24 = mat23.InverseAsync(job24);
+    std::future<Matrixd> prod24 = mat23.MultiplyAsync(mat23_1);
+    Matrixd mat24 = inv24.get() * prod24.get() - mat23_1;
+    VX((mat24.NormInf() < 1e-6 * mat23_1.NormInf()));
+    VX(job24.Progress());
+    MatrixJobControl cancel24;
+    cancel24.Cancel();
+    std::future<LUDecomposition<double>> lu24 = mat23.LUAsync(cancel24);
+    try
+    {
+        lu24.get();
+    }
+    catch (const MatrixCancelled &e)
+    {
+        std::cout << e.what() << '\n';
+    }
+
+    ////////////////////////////////
+    //          Profiling         //
+    ////////////////////////////////
+
+    // Every operation above has been recorded because MATRIX_ENABLE_PROFILER
+    // is defined before including the header
+    MatrixProfiler::Dump();
+
     getchar();
 
     return 0;